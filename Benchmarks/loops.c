@@ -0,0 +1,15 @@
+#include <stdint.h>
+#include <stdio.h>
+
+int main() {
+    int64_t total = 1000000000000;
+
+    for (int16_t outer = 1; outer <= 10000; ++outer) {
+        for (int16_t inner = 1; inner <= 1000; ++inner) {
+            total = total + inner;
+        }
+    }
+
+    printf("Total: %lld\n", (long long) total);
+    return 0;
+}
@@ -0,0 +1,10 @@
+#include <stdint.h>
+#include <stdio.h>
+
+int main() {
+    for (int32_t counter = 1; counter <= 100000; ++counter) {
+        printf("Line #%d\n", counter);
+    }
+
+    return 0;
+}
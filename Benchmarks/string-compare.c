@@ -0,0 +1,17 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+int main() {
+    const char * name = "Hunter";
+    int64_t hits = 1000000000000;
+
+    for (int32_t counter = 1; counter <= 1000000; ++counter) {
+        if (strcmp(name, "Hunter") == 0) {
+            hits = hits + 1;
+        }
+    }
+
+    printf("Hits: %lld\n", (long long) hits);
+    return 0;
+}
@@ -0,0 +1,19 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Point {
+    int64_t x;
+    int64_t y;
+};
+
+int main() {
+    for (int32_t counter = 1; counter <= 100000; ++counter) {
+        struct Point * point = malloc(sizeof(struct Point));
+        point->x = 1;
+        point->y = 2;
+    }
+
+    printf("Done\n");
+    return 0;
+}
@@ -0,0 +1,435 @@
+#include "../src/CodeGenerator.h"
+#include "../src/Compiler.h"
+#include "../src/ImportResolver.h"
+#include "../src/Parser.h"
+#include "../src/SourceManager.h"
+#include "../src/utils/logger.h"
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/JSON.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef HUNTER_COMPILER_VERSION
+#define HUNTER_COMPILER_VERSION "unknown"
+#endif
+
+#ifndef HUNTER_SOURCE_DIR
+#define HUNTER_SOURCE_DIR "."
+#endif
+
+// every allocation of the process goes through these, so each phase can report how much it allocated
+static std::atomic<uint64_t> s_AllocationCount = 0;
+static std::atomic<uint64_t> s_AllocatedBytes = 0;
+
+void * operator new(std::size_t size) {
+    s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void * memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment) {
+    s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    // aligned_alloc wants a multiple of the alignment
+    auto align = static_cast<std::size_t>(alignment);
+    if (void * memory = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void * memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void * memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void * memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void * memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+namespace Hunter::Compiler::Benchmark {
+
+    enum class Phase {
+        Parse,
+        ResolveImports,
+        GenerateCode,
+        CompileModule,
+        Count,
+    };
+
+    const char * GetPhaseName(Phase phase) {
+        switch (phase) {
+            case Phase::Parse:
+                return "parse";
+            case Phase::ResolveImports:
+                return "resolve_imports";
+            case Phase::GenerateCode:
+                return "generate_code";
+            case Phase::CompileModule:
+                return "compile_module";
+            default:
+                return "unknown";
+        }
+    }
+
+    struct PhaseSamples {
+        std::vector<double> Milliseconds;
+        std::vector<uint64_t> Allocations;
+        std::vector<uint64_t> AllocatedBytes;
+    };
+
+    struct InputResult {
+        std::string Name;
+        std::string Path;
+        size_t Units = 0;
+        PhaseSamples Phases[static_cast<size_t>(Phase::Count)];
+    };
+
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer(PhaseSamples & samples)
+            : m_Samples(samples),
+              m_Allocations(s_AllocationCount.load()),
+              m_AllocatedBytes(s_AllocatedBytes.load()),
+              m_Start(std::chrono::steady_clock::now()) {}
+
+        ~PhaseTimer() {
+            auto duration = std::chrono::steady_clock::now() - m_Start;
+
+            m_Samples.Milliseconds.push_back(std::chrono::duration<double, std::milli>(duration).count());
+            m_Samples.Allocations.push_back(s_AllocationCount.load() - m_Allocations);
+            m_Samples.AllocatedBytes.push_back(s_AllocatedBytes.load() - m_AllocatedBytes);
+        }
+
+    private:
+        PhaseSamples & m_Samples;
+        uint64_t m_Allocations;
+        uint64_t m_AllocatedBytes;
+        std::chrono::steady_clock::time_point m_Start;
+    };
+
+    // runs all phases once and adds a sample for each of them, returns the number of compiled units
+    size_t CompileInput(const std::string & filePath, const TargetSettings & target, const std::string & objectDirectory, InputResult & result) {
+        auto measure = [&](Phase phase) {
+            return PhaseTimer(result.Phases[static_cast<size_t>(phase)]);
+        };
+
+        SourceManager sourceManager;
+        Parser parser(sourceManager);
+        ImportResolver importResolver(sourceManager);
+
+        std::unique_ptr<AbstractSyntaxTree> ast;
+        {
+            auto timer = measure(Phase::Parse);
+            ast.reset(parser.Parse(filePath));
+        }
+
+        std::vector<Expression *> instructions;
+        std::vector<CompilationUnit> units;
+        {
+            auto timer = measure(Phase::ResolveImports);
+            importResolver.ResolveImports(std::filesystem::path(filePath).parent_path(), ast.get(), instructions, units);
+            ast->SetInstructions(instructions);
+        }
+
+        ProgramDeclarations declarations;
+        std::vector<std::unique_ptr<CodeGenerator>> codeGenerators;
+        std::vector<llvm::Module *> modules;
+        {
+            auto timer = measure(Phase::GenerateCode);
+
+            for (const auto &unit : units) {
+                declarations.AddUnit(unit);
+            }
+
+            for (const auto &unit : units) {
+                auto & codeGenerator = codeGenerators.emplace_back(std::make_unique<CodeGenerator>(sourceManager.GetSymbols()));
+                codeGenerator->SetDeclarations(&declarations);
+                modules.push_back(codeGenerator->GenerateCode(unit));
+            }
+        }
+
+        {
+            auto timer = measure(Phase::CompileModule);
+
+            for (size_t i = 0; i < modules.size(); ++i) {
+                std::string objectFile = objectDirectory + "/module-" + std::to_string(i) + ".o";
+
+                if (!CompileModule(modules[i], objectFile, target)) {
+                    exit(1);
+                }
+            }
+        }
+
+        return units.size();
+    }
+
+    // the code generator exits on programs it can not handle, so every input is tried in a child process first
+    bool CanCompile(const std::string & filePath, const TargetSettings & target, const std::string & objectDirectory) {
+        std::cout.flush();
+        pid_t child = fork();
+
+        if (child == 0) {
+            freopen("/dev/null", "w", stdout);
+            freopen("/dev/null", "w", stderr);
+
+            // the compiler exits on errors, which would wait for the logger thread of the parent forever
+            std::atexit([]() {
+                _exit(1);
+            });
+
+            InputResult probe;
+            CompileInput(filePath, target, objectDirectory, probe);
+            _exit(0);
+        }
+
+        int status = 0;
+        return child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    /**
+     * Writes a program with the given number of functions, spread over one generated module per
+     * hundred functions. Every function uses loops, conditions, constants and prints, and hunt calls
+     * all of them. Variables are not scoped per function yet, so their names contain the function index.
+     */
+    std::string WriteScaledInput(const std::filesystem::path & directory, size_t functionCount) {
+        std::filesystem::create_directories(directory);
+
+        size_t moduleCount = std::max<size_t>(functionCount / 100, 1);
+        std::ofstream mainFile(directory / "main.hunt");
+
+        for (size_t module = 0; module < moduleCount; ++module) {
+            mainFile << "import generated_" << module << "\n";
+        }
+
+        mainFile << "\nfun hunt()\n"
+                    "    const text = \"Scaled\"\n";
+
+        for (size_t module = 0; module < moduleCount; ++module) {
+            std::ofstream moduleFile(directory / ("generated_" + std::to_string(module) + ".hunt"));
+            moduleFile << "mod generated_" << module << "\n";
+
+            for (size_t function = module; function < functionCount; function += moduleCount) {
+                moduleFile << "\n"
+                              "fun function_" << function << "(number: i8, str: string)\n"
+                              "    const local_" << function << " = \"Function " << function << "\\n\"\n"
+                              "    let counter_" << function << " = 1\n"
+                              "    while counter_" << function << " <= 10\n"
+                              "        print(\"Counter #\", counter_" << function << ", \"\\n\")\n"
+                              "        counter_" << function << " = counter_" << function << " + 1\n"
+                              "    for index_" << function << " in 1..10\n"
+                              "        print(str, index_" << function << ", \"\\n\")\n"
+                              "    const limit_" << function << " = 8\n"
+                              "    if limit_" << function << " eq 8 then\n"
+                              "        print(local_" << function << ")\n";
+
+                mainFile << "    generated_" << module << ".function_" << function << "(8, text)\n";
+            }
+        }
+
+        return (directory / "main.hunt").string();
+    }
+
+    std::vector<std::string> GetDefaultCorpus() {
+        std::filesystem::path sourceDirectory = HUNTER_SOURCE_DIR;
+        std::vector<std::string> files;
+
+        for (const auto &entry : std::filesystem::directory_iterator(sourceDirectory / "Examples")) {
+            if (entry.path().extension() == ".hunt") {
+                files.push_back(entry.path().string());
+            }
+        }
+
+        std::sort(files.begin(), files.end());
+        files.push_back((sourceDirectory / "Examples" / "modules" / "using-modules.hunt").string());
+        files.push_back((sourceDirectory / "Hunter-Compiler" / "compiler.hunt").string());
+
+        return files;
+    }
+
+    // nearest rank on the sorted samples
+    template<typename T>
+    T GetPercentile(std::vector<T> samples, double percentile) {
+        std::sort(samples.begin(), samples.end());
+        size_t rank = static_cast<size_t>(percentile / 100.0 * samples.size() + 0.5);
+
+        return samples.at(std::clamp<size_t>(rank, 1, samples.size()) - 1);
+    }
+
+    void WriteReport(llvm::raw_ostream & output, const std::vector<InputResult> & results, const std::vector<std::string> & skipped, const TargetSettings & target, size_t iterations) {
+        llvm::json::OStream json(output, 2);
+
+        json.object([&]() {
+            json.attribute("compiler_version", HUNTER_COMPILER_VERSION);
+            json.attribute("llvm_version", LLVM_VERSION_STRING);
+            json.attribute("target", target.Triple);
+            json.attribute("optimization", GetOptimizationLevelString(target.Optimization));
+            json.attribute("iterations", static_cast<int64_t>(iterations));
+
+            json.attributeArray("inputs", [&]() {
+                for (const auto &result : results) {
+                    json.object([&]() {
+                        json.attribute("name", result.Name);
+                        json.attribute("path", result.Path);
+                        json.attribute("units", static_cast<int64_t>(result.Units));
+
+                        json.attributeObject("phases", [&]() {
+                            for (size_t phase = 0; phase < static_cast<size_t>(Phase::Count); ++phase) {
+                                const auto & samples = result.Phases[phase];
+
+                                json.attributeObject(GetPhaseName(static_cast<Phase>(phase)), [&]() {
+                                    json.attribute("median_ms", GetPercentile(samples.Milliseconds, 50));
+                                    json.attribute("p90_ms", GetPercentile(samples.Milliseconds, 90));
+                                    json.attribute("p99_ms", GetPercentile(samples.Milliseconds, 99));
+                                    json.attribute("min_ms", GetPercentile(samples.Milliseconds, 0));
+                                    json.attribute("max_ms", GetPercentile(samples.Milliseconds, 100));
+                                    json.attribute("allocations", static_cast<int64_t>(GetPercentile(samples.Allocations, 50)));
+                                    json.attribute("allocated_bytes", static_cast<int64_t>(GetPercentile(samples.AllocatedBytes, 50)));
+                                });
+                            }
+                        });
+                    });
+                }
+            });
+
+            json.attributeArray("skipped", [&]() {
+                for (const auto &path : skipped) {
+                    json.value(path);
+                }
+            });
+        });
+
+        output << "\n";
+    }
+
+}
+
+int main(int argc, const char ** argv) {
+    using namespace Hunter::Compiler;
+    using namespace Hunter::Compiler::Benchmark;
+
+    size_t iterations = 10;
+    std::vector<size_t> scales;
+    std::vector<std::string> files;
+    std::string outputFile;
+    TargetSettings target;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::max(strtoull(argv[++i], nullptr, 10), 1ull);
+        } else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            scales.push_back(std::max(strtoull(argv[++i], nullptr, 10), 1ull));
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (strncmp(argv[i], "-O", 2) == 0) {
+            if (!ParseOptimizationLevel(argv[i], target.Optimization)) {
+                std::cerr << "Unknown optimization level " << argv[i] << ", use one of -O0, -O1, -O2, -O3 or -Os" << std::endl;
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            std::cerr << "Usage: Hunter_Bench [--iterations N] [--scale FUNCTIONS]... [--output FILE] [-O<level>] [FILE]..." << std::endl;
+            return 1;
+        } else {
+            files.emplace_back(argv[i]);
+        }
+    }
+
+    // without inputs the examples, the compiler written in Hunter and two generated programs are measured
+    if (files.empty()) {
+        files = GetDefaultCorpus();
+
+        if (scales.empty()) {
+            scales = {100, 1000};
+        }
+    }
+
+    Logger::Init();
+    // the parser logs every word, which would be measured instead of the compiler
+    Logger::GetInstance()->set_level(spdlog::level::off);
+
+    llvm::SmallString<128> workDirectory;
+    if (auto error = llvm::sys::fs::createUniqueDirectory("hunter-bench", workDirectory)) {
+        std::cerr << "Could not create a temporary directory: " << error.message() << std::endl;
+        return 1;
+    }
+
+    for (size_t scale : scales) {
+        files.push_back(WriteScaledInput(std::filesystem::path(workDirectory.str().str()) / ("scaled-" + std::to_string(scale)), scale));
+    }
+
+    std::vector<InputResult> results;
+    std::vector<std::string> skipped;
+
+    for (const auto &file : files) {
+        std::string filePath = std::filesystem::absolute(file).lexically_normal().string();
+
+        if (!CanCompile(filePath, target, workDirectory.str().str())) {
+            std::cerr << "Skipping " << filePath << ", it does not compile" << std::endl;
+            skipped.push_back(filePath);
+            continue;
+        }
+
+        auto & result = results.emplace_back();
+        result.Path = filePath;
+        result.Name = std::filesystem::path(filePath).filename().string();
+
+        // generated inputs are all called main.hunt, their directory tells them apart
+        if (filePath.rfind(workDirectory.str().str(), 0) == 0) {
+            result.Name = std::filesystem::path(filePath).parent_path().filename().string();
+        }
+
+        for (size_t iteration = 0; iteration < iterations; ++iteration) {
+            result.Units = CompileInput(filePath, target, workDirectory.str().str(), result);
+        }
+
+        std::cerr << "Measured " << result.Name << std::endl;
+    }
+
+    std::filesystem::remove_all(workDirectory.str().str());
+
+    if (outputFile.empty()) {
+        WriteReport(llvm::outs(), results, skipped, target, iterations);
+    } else {
+        std::error_code error;
+        llvm::raw_fd_ostream output(outputFile, error);
+
+        if (error) {
+            std::cerr << "Could not open " << outputFile << ": " << error.message() << std::endl;
+            return 1;
+        }
+
+        WriteReport(output, results, skipped, target, iterations);
+    }
+
+    return 0;
+}
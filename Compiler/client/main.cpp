@@ -0,0 +1,72 @@
+#include "../src/ServerProtocol.h"
+
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+extern char ** environ;
+
+// forwards its arguments to the compile server started with "Hunter_Compiler daemon" and exits with the exit code of the compilation
+int main(int argc, const char ** argv) {
+    using namespace Hunter::Compiler;
+
+    std::string socketPath = GetDefaultServerSocketPath();
+    int firstArgument = 1;
+
+    if (argc > 2 && strcmp(argv[1], "--socket") == 0) {
+        socketPath = argv[2];
+        firstArgument = 3;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "The socket path " << socketPath << " is too long" << std::endl;
+        return 1;
+    }
+
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        std::cerr << "Could not connect to the compile server at " << socketPath << ", start it with Hunter_Compiler daemon" << std::endl;
+        return 1;
+    }
+
+    // the server going away is reported below
+    signal(SIGPIPE, SIG_IGN);
+
+    CompileRequest request;
+    request.Arguments.emplace_back("Hunter_Compiler");
+    request.Arguments.insert(request.Arguments.end(), argv + firstArgument, argv + argc);
+
+    for (char ** variable = environ; *variable; ++variable) {
+        request.Environment.emplace_back(*variable);
+    }
+
+    char workingDirectory[4096];
+
+    if (!getcwd(workingDirectory, sizeof(workingDirectory))) {
+        std::cerr << "Could not read the working directory" << std::endl;
+        return 1;
+    }
+
+    request.WorkingDirectory = workingDirectory;
+    request.FileDescriptors[0] = STDIN_FILENO;
+    request.FileDescriptors[1] = STDOUT_FILENO;
+    request.FileDescriptors[2] = STDERR_FILENO;
+
+    int exitCode;
+
+    if (!SendRequest(connection, request) || !ReceiveExitCode(connection, exitCode)) {
+        std::cerr << "The compile server at " << socketPath << " did not answer" << std::endl;
+        return 1;
+    }
+
+    return exitCode;
+}
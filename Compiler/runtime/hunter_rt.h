@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The runtime of Hunter programs. It is linked into every executable as libhunter_rt.a and,
+ * when the compiler was built with clang, its bitcode is linked into every module before
+ * it is optimized, so the small functions are inlined into the program. The bitcode
+ * definitions are only used for that, the calls which remain go to the library. So the
+ * runtime must not keep state in static variables, every module would get its own copy.
+ * The compiler declares these functions itself, see CodeGenerator::GetRuntimeFunction.
+ */
+
+// the builtin list type, BuiltinFeatureGenerator::GenerateListFeature creates the same struct
+struct hunter_rt_list {
+    int64_t Size;
+    void * Memory;
+};
+
+// allocations which fail end the program, there is nothing a program could do about them yet
+void * hunter_rt_alloc(int64_t size);
+void hunter_rt_free(void * memory);
+
+int32_t hunter_rt_string_equals(const char * left, const char * right);
+int64_t hunter_rt_string_length(const char * str);
+
+// the elements are stored right behind the list, both are freed at once
+struct hunter_rt_list * hunter_rt_list_new(int64_t size, int64_t elementSize);
+// lists from list literals are constant, a list has to be copied before it can be changed
+struct hunter_rt_list * hunter_rt_list_copy(const struct hunter_rt_list * list, int64_t elementSize);
+
+/**
+ * Output of print. Every thread collects what it prints in its own buffer, which is
+ * written to stdout once it is full, when the thread ends, when the program exits or
+ * when hunter_rt_flush is called. Output written through stdio is not ordered with it.
+ */
+void hunter_rt_write(const char * data, int64_t size);
+void hunter_rt_write_string(const char * str);
+void hunter_rt_write_i32(int32_t value);
+void hunter_rt_write_i64(int64_t value);
+
+// writes the buffer of the calling thread, Hunter programs can call it as an extern function
+void hunter_rt_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,18 @@
+#include "hunter_rt.h"
+
+#include <string.h>
+
+struct hunter_rt_list * hunter_rt_list_new(int64_t size, int64_t elementSize) {
+    struct hunter_rt_list * list = hunter_rt_alloc((int64_t) sizeof(struct hunter_rt_list) + size * elementSize);
+    list->Size = size;
+    list->Memory = list + 1;
+
+    return list;
+}
+
+struct hunter_rt_list * hunter_rt_list_copy(const struct hunter_rt_list * list, int64_t elementSize) {
+    struct hunter_rt_list * copy = hunter_rt_list_new(list->Size, elementSize);
+    memcpy(copy->Memory, list->Memory, (size_t) (list->Size * elementSize));
+
+    return copy;
+}
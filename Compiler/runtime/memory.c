@@ -0,0 +1,20 @@
+#include "hunter_rt.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+void * hunter_rt_alloc(int64_t size) {
+    void * memory = malloc((size_t) size);
+
+    if (!memory && size > 0) {
+        static const char message[] = "Hunter program ran out of memory\n";
+        write(STDERR_FILENO, message, sizeof(message) - 1);
+        abort();
+    }
+
+    return memory;
+}
+
+void hunter_rt_free(void * memory) {
+    free(memory);
+}
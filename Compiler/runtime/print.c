@@ -0,0 +1,176 @@
+#include "hunter_rt.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// large enough that a program which prints a lot only makes a system call every few thousand lines
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+// not static, see hunter_rt.h. hidden, so they are not part of the interface of a program
+#define RUNTIME_STATE __attribute__((visibility("hidden")))
+
+struct hunter_rt_output_buffer {
+    size_t Size;
+    char Data[OUTPUT_BUFFER_SIZE];
+};
+
+RUNTIME_STATE _Thread_local struct hunter_rt_output_buffer * hunter_rt_thread_output;
+// set when the buffer of the thread could not be allocated, the output is written directly then
+RUNTIME_STATE _Thread_local int hunter_rt_thread_unbuffered;
+
+RUNTIME_STATE pthread_once_t hunter_rt_output_once = PTHREAD_ONCE_INIT;
+RUNTIME_STATE pthread_key_t hunter_rt_output_key;
+// a terminal shows every line right away, like stdio does
+RUNTIME_STATE int hunter_rt_output_interactive;
+
+void hunter_rt_write_slow(const char * data, int64_t size) __attribute__((cold, noinline));
+
+static void WriteAll(const char * data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(STDOUT_FILENO, data, size);
+
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+
+        // there is nobody left to report it to
+        if (written <= 0) {
+            return;
+        }
+
+        data += written;
+        size -= (size_t) written;
+    }
+}
+
+static void FlushBuffer(struct hunter_rt_output_buffer * buffer) {
+    WriteAll(buffer->Data, buffer->Size);
+    buffer->Size = 0;
+}
+
+// runs when a thread other than the one calling exit ends
+static void FinishThread(void * buffer) {
+    FlushBuffer(buffer);
+    free(buffer);
+    hunter_rt_thread_output = NULL;
+}
+
+// the destructors of thread local data do not run for the thread which calls exit
+static void FinishProcess(void) {
+    hunter_rt_flush();
+}
+
+static void Init(void) {
+    pthread_key_create(&hunter_rt_output_key, FinishThread);
+    atexit(FinishProcess);
+    hunter_rt_output_interactive = isatty(STDOUT_FILENO);
+}
+
+static struct hunter_rt_output_buffer * GetBuffer(void) {
+    if (hunter_rt_thread_output || hunter_rt_thread_unbuffered) {
+        return hunter_rt_thread_output;
+    }
+
+    pthread_once(&hunter_rt_output_once, Init);
+    struct hunter_rt_output_buffer * buffer = malloc(sizeof(struct hunter_rt_output_buffer));
+
+    if (!buffer) {
+        hunter_rt_thread_unbuffered = 1;
+        return NULL;
+    }
+
+    buffer->Size = 0;
+    hunter_rt_thread_output = buffer;
+    pthread_setspecific(hunter_rt_output_key, buffer);
+
+    return buffer;
+}
+
+// the first write of a thread, a full buffer and every write to a terminal
+void hunter_rt_write_slow(const char * data, int64_t size) {
+    struct hunter_rt_output_buffer * buffer = GetBuffer();
+
+    if (!buffer) {
+        WriteAll(data, (size_t) size);
+        return;
+    }
+
+    if ((size_t) size > OUTPUT_BUFFER_SIZE - buffer->Size) {
+        FlushBuffer(buffer);
+
+        // would only be copied to be written right away
+        if ((size_t) size >= OUTPUT_BUFFER_SIZE) {
+            WriteAll(data, (size_t) size);
+            return;
+        }
+    }
+
+    memcpy(buffer->Data + buffer->Size, data, (size_t) size);
+    buffer->Size += (size_t) size;
+
+    if (hunter_rt_output_interactive && memchr(data, '\n', (size_t) size)) {
+        FlushBuffer(buffer);
+    }
+}
+
+// small enough to be inlined into every print, the rest is left to the slow path
+void hunter_rt_write(const char * data, int64_t size) {
+    struct hunter_rt_output_buffer * buffer = hunter_rt_thread_output;
+
+    if (buffer && (size_t) size <= OUTPUT_BUFFER_SIZE - buffer->Size && !hunter_rt_output_interactive) {
+        memcpy(buffer->Data + buffer->Size, data, (size_t) size);
+        buffer->Size += (size_t) size;
+        return;
+    }
+
+    hunter_rt_write_slow(data, size);
+}
+
+void hunter_rt_write_string(const char * str) {
+    hunter_rt_write(str, hunter_rt_string_length(str));
+}
+
+void hunter_rt_write_i32(int32_t value) {
+    // the digits are produced from the back, so they do not have to be reversed.
+    // 32 bit divisions are cheaper, which is why the smaller types do not use the 64 bit version
+    char digits[11];
+    char * start = digits + sizeof(digits);
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t) value : (uint32_t) value;
+
+    do {
+        *--start = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0) {
+        *--start = '-';
+    }
+
+    hunter_rt_write(start, digits + sizeof(digits) - start);
+}
+
+void hunter_rt_write_i64(int64_t value) {
+    char digits[20];
+    char * start = digits + sizeof(digits);
+    uint64_t magnitude = value < 0 ? 0u - (uint64_t) value : (uint64_t) value;
+
+    do {
+        *--start = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0) {
+        *--start = '-';
+    }
+
+    hunter_rt_write(start, digits + sizeof(digits) - start);
+}
+
+void hunter_rt_flush(void) {
+    if (hunter_rt_thread_output) {
+        FlushBuffer(hunter_rt_thread_output);
+    }
+}
@@ -0,0 +1,11 @@
+#include "hunter_rt.h"
+
+#include <string.h>
+
+int32_t hunter_rt_string_equals(const char * left, const char * right) {
+    return strcmp(left, right) == 0;
+}
+
+int64_t hunter_rt_string_length(const char * str) {
+    return (int64_t) strlen(str);
+}
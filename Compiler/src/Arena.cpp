@@ -0,0 +1,40 @@
+#include "Arena.h"
+
+#include <cstdlib>
+
+namespace Hunter::Compiler {
+
+    Arena::~Arena() {
+        // destroy in reverse creation order, like automatic variables
+        for (DestructorEntry * entry = m_Destructors; entry; entry = entry->Next) {
+            entry->Destroy(entry->Object);
+        }
+
+        while (m_Blocks) {
+            Block * previous = m_Blocks->Previous;
+            std::free(m_Blocks);
+            m_Blocks = previous;
+        }
+    }
+
+    void * Arena::AllocateSlow(size_t size, size_t alignment) {
+        size_t requiredSize = sizeof(Block) + size + alignment;
+        size_t blockSize = requiredSize > DefaultBlockSize ? requiredSize : DefaultBlockSize;
+
+        auto * block = static_cast<Block *>(std::malloc(blockSize));
+
+        if (!block) {
+            throw std::bad_alloc();
+        }
+
+        block->Previous = m_Blocks;
+        block->Size = blockSize;
+        m_Blocks = block;
+
+        m_Current = reinterpret_cast<char *>(block + 1);
+        m_End = reinterpret_cast<char *>(block) + blockSize;
+
+        return Allocate(size, alignment);
+    }
+
+}
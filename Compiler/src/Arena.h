@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Hunter::Compiler {
+
+    /**
+     * Bump pointer allocator for objects which all share the same lifetime, like the nodes
+     * of a syntax tree. Everything is released at once when the arena is destroyed,
+     * destructors are only remembered for types which actually need them.
+     */
+    class Arena {
+    public:
+        Arena() = default;
+        Arena(const Arena &) = delete;
+        Arena & operator=(const Arena &) = delete;
+        ~Arena();
+
+        template<typename T, typename... Args>
+        T * Create(Args &&... args) {
+            if constexpr (std::is_trivially_destructible_v<T>) {
+                return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            } else {
+                // the destructor entry is placed in front of the object, so both share one allocation
+                constexpr size_t alignment = alignof(T) > alignof(DestructorEntry) ? alignof(T) : alignof(DestructorEntry);
+                constexpr size_t objectOffset = (sizeof(DestructorEntry) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+                auto * memory = static_cast<char *>(Allocate(objectOffset + sizeof(T), alignment));
+                T * object = new (memory + objectOffset) T(std::forward<Args>(args)...);
+
+                m_Destructors = new (memory) DestructorEntry{
+                    .Destroy = [](void * obj) { static_cast<T *>(obj)->~T(); },
+                    .Object = object,
+                    .Next = m_Destructors
+                };
+
+                return object;
+            }
+        }
+
+        void * Allocate(size_t size, size_t alignment);
+
+        size_t GetAllocatedBytes() const { return m_AllocatedBytes; }
+
+    private:
+        struct Block {
+            Block * Previous;
+            size_t Size;
+        };
+
+        struct DestructorEntry {
+            void (*Destroy)(void *);
+            void * Object;
+            DestructorEntry * Next;
+        };
+
+        void * AllocateSlow(size_t size, size_t alignment);
+
+        static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+        char * m_Current = nullptr;
+        char * m_End = nullptr;
+        Block * m_Blocks = nullptr;
+        DestructorEntry * m_Destructors = nullptr;
+        size_t m_AllocatedBytes = 0;
+    };
+
+    inline void * Arena::Allocate(size_t size, size_t alignment) {
+        auto current = reinterpret_cast<uintptr_t>(m_Current);
+        uintptr_t aligned = (current + alignment - 1) & ~(alignment - 1);
+
+        if (m_Current && aligned + size <= reinterpret_cast<uintptr_t>(m_End)) {
+            m_Current = reinterpret_cast<char *>(aligned + size);
+            m_AllocatedBytes += size;
+            return reinterpret_cast<void *>(aligned);
+        }
+
+        return AllocateSlow(size, alignment);
+    }
+
+}
@@ -0,0 +1,757 @@
+#include "AstSerializer.h"
+#include "SourceManager.h"
+#include "./utils/logger.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
+
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/xxhash.h>
+
+namespace Hunter::Compiler {
+
+    using Hunter::Parser::Debug::DebugData;
+
+    // has to be increased whenever the encoding of any expression changes
+    constexpr uint32_t AstFormatVersion = 2;
+    constexpr char AstFileMagic[4] = {'H', 'A', 'S', 'T'};
+
+    // written instead of the kind for missing child expressions
+    constexpr uint8_t NullExpressionMarker = 0xFF;
+
+    enum class DebugDataMarker : uint8_t {
+        None,
+        // most expressions of a line share the debug data of the line
+        SameAsPrevious,
+        New,
+    };
+
+    static uint64_t GetChecksum(std::string_view data) {
+        data.remove_prefix(sizeof(AstFileHeader));
+        return llvm::xxHash64(llvm::StringRef(data.data(), data.size()));
+    }
+
+    std::string AstWriter::Serialize(AbstractSyntaxTree *tree) {
+        AstWriter writer;
+        writer.m_Data.resize(sizeof(AstFileHeader));
+
+        for (const auto &instruction : tree->GetInstructions()) {
+            writer.WriteExpression(instruction);
+        }
+
+        AstFileHeader header{};
+        std::memcpy(header.Magic, AstFileMagic, sizeof(header.Magic));
+        header.Version = AstFormatVersion;
+        header.StringTableOffset = writer.m_Data.size();
+        header.StringCount = static_cast<uint32_t>(writer.m_Strings.size());
+        header.InstructionCount = static_cast<uint32_t>(tree->GetInstructions().size());
+
+        for (const auto &str : writer.m_Strings) {
+            writer.WriteUnsigned(str.size());
+            writer.m_Data.append(str);
+        }
+
+        header.Size = writer.m_Data.size();
+        header.Checksum = GetChecksum(writer.m_Data);
+        std::memcpy(writer.m_Data.data(), &header, sizeof(header));
+
+        return std::move(writer.m_Data);
+    }
+
+    bool AstWriter::Write(AbstractSyntaxTree *tree, const std::string &filePath) {
+        std::string data = Serialize(tree);
+
+        // written under a private name first, so readers never map a half written file
+        std::string temporaryPath = filePath + ".tmp-" + std::to_string(getpid());
+
+        {
+            std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+            output.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+            if (!output) {
+                COMPILER_WARN("Could not write the syntax tree to '{0}'", filePath);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, filePath, error);
+
+        if (error) {
+            COMPILER_WARN("Could not write the syntax tree to '{0}': {1}", filePath, error.message());
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+
+        return true;
+    }
+
+    void AstWriter::WriteExpression(Expression *expr) {
+        if (!expr) {
+            m_Data.push_back(static_cast<char>(NullExpressionMarker));
+            return;
+        }
+
+        m_Data.push_back(static_cast<char>(expr->GetKind()));
+        WriteDebugData(expr->GetDebugData());
+        Visit(expr);
+    }
+
+    void AstWriter::WriteBody(BlockExpression *block) {
+        auto & body = block->GetBody();
+        WriteUnsigned(body.size());
+
+        for (const auto &expr : body) {
+            WriteExpression(expr);
+        }
+    }
+
+    void AstWriter::WriteDebugData(DebugData *debugData) {
+        if (!debugData) {
+            m_Data.push_back(static_cast<char>(DebugDataMarker::None));
+        } else if (debugData == m_LastDebugData) {
+            m_Data.push_back(static_cast<char>(DebugDataMarker::SameAsPrevious));
+        } else {
+            m_Data.push_back(static_cast<char>(DebugDataMarker::New));
+            WriteString(debugData->GetDirectory());
+            WriteString(debugData->GetFileName());
+            WriteSigned(debugData->GetFileLine());
+            WriteSigned(debugData->GetLineColumn());
+            m_LastDebugData = debugData;
+        }
+    }
+
+    void AstWriter::WriteDataType(DataType *dataType) {
+        if (!dataType) {
+            m_Data.push_back(0);
+            return;
+        }
+
+        m_Data.push_back(1);
+        WriteUnsigned(static_cast<uint64_t>(dataType->GetId()));
+        WriteDataType(dataType->GetTemplateType());
+    }
+
+    void AstWriter::WriteSymbol(Symbol symbol) {
+        if (!symbol.IsValid()) {
+            WriteUnsigned(0);
+            return;
+        }
+
+        // 0 is left for the empty symbol
+        WriteUnsigned(GetStringIndex(symbol.GetName()) + 1);
+    }
+
+    void AstWriter::WriteString(std::string_view str) {
+        WriteUnsigned(GetStringIndex(str));
+    }
+
+    uint32_t AstWriter::GetStringIndex(std::string_view str) {
+        auto [entry, isNew] = m_StringIndices.emplace(str, static_cast<uint32_t>(m_Strings.size()));
+
+        if (isNew) {
+            m_Strings.push_back(str);
+        }
+
+        return entry->second;
+    }
+
+    void AstWriter::WriteUnsigned(uint64_t value) {
+        // 7 bits per byte, the highest bit marks that another byte follows
+        while (value >= 0x80) {
+            m_Data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+
+        m_Data.push_back(static_cast<char>(value));
+    }
+
+    void AstWriter::WriteSigned(int64_t value) {
+        // zig zag encoding keeps small negative numbers short as well
+        WriteUnsigned((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void AstWriter::VisitExpression(Expression *expr) {
+        COMPILER_ERROR("Can not serialize expression: {0}", expr->GetClassName());
+        exit(1);
+    }
+
+    void AstWriter::VisitImport(ImportExpression *expr) {
+        WriteString(expr->GetModule());
+    }
+
+    void AstWriter::VisitModule(ModuleExpression *expr) {
+        WriteString(expr->GetModule());
+    }
+
+    void AstWriter::VisitPrint(PrintExpression *expr) {
+        WriteExpression(expr->GetInput());
+    }
+
+    void AstWriter::VisitExtern(ExternExpression *expr) {
+        WriteExpression(expr->GetData());
+    }
+
+    void AstWriter::VisitString(StringExpression *expr) {
+        WriteString(expr->GetString());
+    }
+
+    void AstWriter::VisitVariableMutation(VariableMutationExpression *expr) {
+        WriteSymbol(expr->GetVariable());
+        WriteExpression(expr->GetValue());
+    }
+
+    void AstWriter::VisitBoolean(BooleanExpression *expr) {
+        WriteUnsigned(static_cast<uint64_t>(expr->GetOperator()));
+        WriteExpression(expr->Left());
+        WriteExpression(expr->Right());
+    }
+
+    void AstWriter::VisitOperation(OperationExpression *expr) {
+        WriteUnsigned(static_cast<uint64_t>(expr->GetOperator()));
+        WriteExpression(expr->Left());
+        WriteExpression(expr->Right());
+    }
+
+    void AstWriter::VisitInt(IntExpression *expr) {
+        WriteUnsigned(static_cast<uint64_t>(expr->GetType()));
+        WriteSigned(expr->GetValue());
+    }
+
+    void AstWriter::VisitIdentifier(IdentifierExpression *expr) {
+        WriteSymbol(expr->GetVariable());
+        WriteSymbol(expr->GetObject());
+        WriteSymbol(expr->GetProperty());
+    }
+
+    void AstWriter::VisitStructConstruction(StructConstructionExpression *expr) {
+        WriteSymbol(expr->GetStruct());
+        WriteUnsigned(expr->GetAttributes().size());
+
+        for (const auto &attribute : expr->GetAttributes()) {
+            WriteExpression(attribute);
+        }
+    }
+
+    void AstWriter::VisitFunctionReturn(FunctionReturnExpression *expr) {
+        WriteExpression(expr->GetValue());
+    }
+
+    void AstWriter::VisitFunctionCall(FunctionCallExpression *expr) {
+        WriteSymbol(expr->GetFunction());
+        WriteUnsigned(expr->GetParameters().size());
+
+        for (const auto &parameter : expr->GetParameters()) {
+            WriteExpression(parameter);
+        }
+    }
+
+    void AstWriter::VisitParameter(ParameterExpression *expr) {
+        WriteSymbol(expr->GetSymbol());
+        WriteDataType(expr->GetDataType());
+    }
+
+    void AstWriter::VisitList(ListExpression *expr) {
+        WriteUnsigned(static_cast<uint64_t>(expr->GetDataType()));
+        WriteUnsigned(expr->GetElements().size());
+
+        for (const auto &element : expr->GetElements()) {
+            WriteExpression(element);
+        }
+    }
+
+    void AstWriter::VisitRange(RangeExpression *expr) {
+        WriteSigned(expr->GetStart());
+        WriteSigned(expr->GetEnd());
+        WriteExpression(expr->GetVariable());
+    }
+
+    void AstWriter::VisitVariableDeclaration(VariableDeclarationExpression *expr) {
+        WriteSymbol(expr->GetVariable());
+        WriteExpression(expr->GetValue());
+    }
+
+    void AstWriter::VisitPropertyDeclaration(PropertyDeclarationExpression *expr) {
+        WriteSymbol(expr->GetVariable());
+        WriteUnsigned(static_cast<uint64_t>(expr->GetVariableType()));
+    }
+
+    void AstWriter::VisitStruct(StructExpression *expr) {
+        WriteSymbol(expr->GetStruct());
+        WriteBody(expr);
+    }
+
+    void AstWriter::VisitFunction(FunctionExpression *expr) {
+        m_Data.push_back(expr->IsExternal() ? 1 : 0);
+        WriteSymbol(expr->GetSymbol());
+        WriteUnsigned(static_cast<uint64_t>(expr->GetReturnType()));
+        WriteUnsigned(expr->GetParameters().size());
+
+        for (const auto &parameter : expr->GetParameters()) {
+            WriteExpression(parameter);
+        }
+
+        // the body gets a fixed size prefix, so a reader can skip it without decoding it.
+        // It has to be decodable on its own, so it does not share debug data with its surroundings
+        size_t sizePosition = m_Data.size();
+        m_Data.append(sizeof(uint32_t), '\0');
+
+        m_LastDebugData = nullptr;
+        WriteBody(expr);
+        m_LastDebugData = nullptr;
+
+        auto bodySize = static_cast<uint32_t>(m_Data.size() - sizePosition - sizeof(uint32_t));
+        std::memcpy(m_Data.data() + sizePosition, &bodySize, sizeof(bodySize));
+    }
+
+    void AstWriter::VisitElse(ElseExpression *expr) {
+        WriteBody(expr);
+    }
+
+    void AstWriter::VisitIf(IfExpression *expr) {
+        WriteExpression(expr->GetCondition());
+        WriteBody(expr);
+        WriteExpression(expr->GetElse());
+    }
+
+    void AstWriter::VisitWhile(WhileExpression *expr) {
+        WriteExpression(expr->GetCondition());
+        WriteBody(expr);
+    }
+
+    void AstWriter::VisitForLoop(ForLoopExpression *expr) {
+        WriteSymbol(expr->GetCounter());
+        WriteExpression(expr->GetRange());
+        WriteBody(expr);
+    }
+
+    AstReader::AstReader(SourceManager &sourceManager, std::string_view data, Arena &arena)
+        : m_SourceManager(sourceManager), m_Data(data), m_Arena(arena) {}
+
+    AbstractSyntaxTree *AstReader::Load(SourceManager &sourceManager, const std::string &filePath) {
+        std::error_code error;
+
+        if (!std::filesystem::is_regular_file(filePath, error)) {
+            return nullptr;
+        }
+
+        return Load(sourceManager, sourceManager.LoadFile(filePath), filePath);
+    }
+
+    AbstractSyntaxTree *AstReader::Load(SourceManager &sourceManager, std::string_view data, const std::string &name) {
+        llvm::TimeTraceScope timeScope("LoadTree", name);
+        AstFileHeader header{};
+
+        if (data.size() >= sizeof(header)) {
+            std::memcpy(&header, data.data(), sizeof(header));
+        }
+
+        if (data.size() < sizeof(header)
+            || std::memcmp(header.Magic, AstFileMagic, sizeof(header.Magic)) != 0
+            || header.Version != AstFormatVersion
+            || header.Size != data.size()
+            || header.StringTableOffset > data.size()) {
+            COMPILER_WARN("Ignoring syntax tree of another format version - '{0}'", name);
+            return nullptr;
+        }
+
+        if (header.Checksum != GetChecksum(data)) {
+            COMPILER_WARN("Ignoring corrupted syntax tree - '{0}'", name);
+            return nullptr;
+        }
+
+        auto * tree = new AbstractSyntaxTree;
+        auto * reader = tree->GetArena().Create<AstReader>(sourceManager, data, tree->GetArena());
+
+        reader->m_Position = header.StringTableOffset;
+        reader->m_Strings.reserve(header.StringCount);
+
+        for (uint32_t i = 0; i < header.StringCount; ++i) {
+            uint64_t length = reader->ReadUnsigned();
+
+            if (length > data.size() - reader->m_Position) {
+                reader->ReportCorruption();
+                break;
+            }
+
+            reader->m_Strings.push_back(data.substr(reader->m_Position, length));
+            reader->m_Position += length;
+        }
+
+        reader->m_Symbols.resize(header.StringCount);
+        reader->m_Data = data.substr(0, header.StringTableOffset);
+        reader->m_Position = sizeof(header);
+
+        for (uint32_t i = 0; i < header.InstructionCount && !reader->m_IsCorrupted; ++i) {
+            tree->AddExpression(reader->ReadExpression());
+        }
+
+        if (reader->m_IsCorrupted) {
+            delete tree;
+            return nullptr;
+        }
+
+        return tree;
+    }
+
+    void AstReader::DecodeBody(size_t offset, std::vector<Expression *> &body) {
+        size_t position = m_Position;
+        DebugData * lastDebugData = m_LastDebugData;
+
+        m_Position = offset;
+        m_LastDebugData = nullptr;
+        ReadBody(body);
+
+        // the checksum matched when the tree was loaded, so the writer and the reader do not agree on the format
+        if (m_IsCorrupted) {
+            COMPILER_ERROR("Could not decode a function body of a serialized syntax tree, delete the cache");
+            exit(1);
+        }
+
+        m_Position = position;
+        m_LastDebugData = lastDebugData;
+    }
+
+    Expression *AstReader::ReadExpression() {
+        uint8_t kindValue = ReadByte();
+
+        if (kindValue == NullExpressionMarker) {
+            return nullptr;
+        }
+
+        if (kindValue > static_cast<uint8_t>(ExpressionKind::ForLoop) || m_IsCorrupted) {
+            ReportCorruption();
+            return nullptr;
+        }
+
+        DebugData * debugData = ReadDebugData();
+        Expression * expr = nullptr;
+
+        // every field is read into a local first, the evaluation order of arguments is unspecified
+        switch (static_cast<ExpressionKind>(kindValue)) {
+            case ExpressionKind::Import: {
+                expr = m_Arena.Create<ImportExpression>(ReadString());
+                break;
+            }
+            case ExpressionKind::Module: {
+                expr = m_Arena.Create<ModuleExpression>(ReadString());
+                break;
+            }
+            case ExpressionKind::Print: {
+                expr = m_Arena.Create<PrintExpression>(ReadExpression());
+                break;
+            }
+            case ExpressionKind::Extern: {
+                expr = m_Arena.Create<ExternExpression>(ReadExpression());
+                break;
+            }
+            case ExpressionKind::String: {
+                expr = m_Arena.Create<StringExpression>(ReadString());
+                break;
+            }
+            case ExpressionKind::VariableMutation: {
+                Symbol variable = ReadSymbol();
+                expr = m_Arena.Create<VariableMutationExpression>(variable, ReadExpression());
+                break;
+            }
+            case ExpressionKind::Boolean: {
+                auto operatorType = static_cast<OperatorType>(ReadUnsigned());
+                Expression * left = ReadExpression();
+                Expression * right = ReadExpression();
+                expr = m_Arena.Create<BooleanExpression>(operatorType, left, right);
+                break;
+            }
+            case ExpressionKind::Operation: {
+                auto * operationExpr = m_Arena.Create<OperationExpression>(static_cast<OperatorType>(ReadUnsigned()));
+                operationExpr->SetLeft(ReadExpression());
+                operationExpr->SetRight(ReadExpression());
+                expr = operationExpr;
+                break;
+            }
+            case ExpressionKind::Int: {
+                auto type = static_cast<IntType>(ReadUnsigned());
+                expr = m_Arena.Create<IntExpression>(type, ReadSigned());
+                break;
+            }
+            case ExpressionKind::Identifier: {
+                Symbol variable = ReadSymbol();
+                Symbol object = ReadSymbol();
+                Symbol property = ReadSymbol();
+                expr = m_Arena.Create<IdentifierExpression>(variable, object, property);
+                break;
+            }
+            case ExpressionKind::StructConstruction: {
+                Symbol structName = ReadSymbol();
+                std::vector<VariableMutationExpression *> attributes(ReadUnsigned());
+
+                for (auto &attribute : attributes) {
+                    attribute = ReadExpressionOf<VariableMutationExpression>();
+                }
+
+                expr = m_Arena.Create<StructConstructionExpression>(structName, std::move(attributes));
+                break;
+            }
+            case ExpressionKind::FunctionReturn: {
+                expr = m_Arena.Create<FunctionReturnExpression>(ReadExpression());
+                break;
+            }
+            case ExpressionKind::FunctionCall: {
+                Symbol function = ReadSymbol();
+                std::vector<Expression *> parameters(ReadUnsigned());
+
+                for (auto &parameter : parameters) {
+                    parameter = ReadExpression();
+                }
+
+                auto * callExpr = m_Arena.Create<FunctionCallExpression>(std::move(parameters));
+                callExpr->SetFunction(function);
+                expr = callExpr;
+                break;
+            }
+            case ExpressionKind::Parameter: {
+                Symbol name = ReadSymbol();
+                expr = m_Arena.Create<ParameterExpression>(name, ReadDataType());
+                break;
+            }
+            case ExpressionKind::List: {
+                auto * listExpr = m_Arena.Create<ListExpression>(static_cast<DataTypeId>(ReadUnsigned()));
+                uint64_t elementCount = ReadUnsigned();
+
+                for (uint64_t i = 0; i < elementCount; ++i) {
+                    listExpr->AddElement(ReadExpression());
+                }
+
+                expr = listExpr;
+                break;
+            }
+            case ExpressionKind::Range: {
+                int64_t start = ReadSigned();
+                int64_t end = ReadSigned();
+                auto * variable = ReadExpressionOf<IdentifierExpression>();
+
+                if (variable) {
+                    expr = m_Arena.Create<RangeExpression>(variable);
+                } else {
+                    expr = m_Arena.Create<RangeExpression>(start, end);
+                }
+                break;
+            }
+            case ExpressionKind::PropertyDeclaration: {
+                Symbol variable = ReadSymbol();
+                expr = m_Arena.Create<PropertyDeclarationExpression>(variable, static_cast<DataTypeId>(ReadUnsigned()));
+                break;
+            }
+            case ExpressionKind::Const: {
+                Symbol variable = ReadSymbol();
+                expr = m_Arena.Create<ConstExpression>(variable, ReadExpression());
+                break;
+            }
+            case ExpressionKind::Let: {
+                Symbol variable = ReadSymbol();
+                expr = m_Arena.Create<LetExpression>(variable, ReadExpression());
+                break;
+            }
+            case ExpressionKind::Struct: {
+                auto * structExpr = m_Arena.Create<StructExpression>(ReadSymbol());
+                ReadBody(structExpr->GetBody());
+                expr = structExpr;
+                break;
+            }
+            case ExpressionKind::Function: {
+                bool isExternal = ReadByte() != 0;
+                Symbol name = ReadSymbol();
+                auto returnType = static_cast<DataTypeId>(ReadUnsigned());
+                std::vector<ParameterExpression *> parameters(ReadUnsigned());
+
+                for (auto &parameter : parameters) {
+                    parameter = ReadExpressionOf<ParameterExpression>();
+                }
+
+                auto * functionExpr = m_Arena.Create<FunctionExpression>(name, std::move(parameters));
+                functionExpr->SetReturnType(returnType);
+                functionExpr->SetExternal(isExternal);
+
+                uint32_t bodySize;
+                if (m_Data.size() - m_Position < sizeof(bodySize)) {
+                    ReportCorruption();
+                    return nullptr;
+                }
+
+                std::memcpy(&bodySize, m_Data.data() + m_Position, sizeof(bodySize));
+                m_Position += sizeof(bodySize);
+
+                if (m_Data.size() - m_Position < bodySize) {
+                    ReportCorruption();
+                    return nullptr;
+                }
+
+                functionExpr->SetLazyBody(this, m_Position);
+                m_Position += bodySize;
+                m_LastDebugData = nullptr;
+
+                expr = functionExpr;
+                break;
+            }
+            case ExpressionKind::Else: {
+                auto * elseExpr = m_Arena.Create<ElseExpression>();
+                ReadBody(elseExpr->GetBody());
+                expr = elseExpr;
+                break;
+            }
+            case ExpressionKind::If: {
+                auto * ifExpr = m_Arena.Create<IfExpression>(ReadExpression());
+                ReadBody(ifExpr->GetBody());
+                ifExpr->SetElse(ReadExpressionOf<ElseExpression>());
+                expr = ifExpr;
+                break;
+            }
+            case ExpressionKind::While: {
+                auto * whileExpr = m_Arena.Create<WhileExpression>(ReadExpression());
+                ReadBody(whileExpr->GetBody());
+                expr = whileExpr;
+                break;
+            }
+            case ExpressionKind::ForLoop: {
+                Symbol counter = ReadSymbol();
+                auto * forExpr = m_Arena.Create<ForLoopExpression>(counter, ReadExpression());
+                ReadBody(forExpr->GetBody());
+                expr = forExpr;
+                break;
+            }
+        }
+
+        if (debugData) {
+            expr->SetDebugData(debugData);
+        }
+
+        return expr;
+    }
+
+    void AstReader::ReadBody(std::vector<Expression *> &body) {
+        uint64_t count = ReadUnsigned();
+
+        // every expression takes at least one byte, which keeps a corrupted count from allocating too much
+        if (count > m_Data.size() - m_Position) {
+            ReportCorruption();
+            return;
+        }
+
+        body.reserve(count);
+
+        for (uint64_t i = 0; i < count; ++i) {
+            body.push_back(ReadExpression());
+        }
+    }
+
+    DebugData *AstReader::ReadDebugData() {
+        switch (static_cast<DebugDataMarker>(ReadByte())) {
+            case DebugDataMarker::None:
+                return nullptr;
+            case DebugDataMarker::SameAsPrevious:
+                if (!m_LastDebugData) {
+                    ReportCorruption();
+                }
+
+                return m_LastDebugData;
+            case DebugDataMarker::New: {
+                auto * debugData = m_Arena.Create<DebugData>();
+                debugData->SetDirectory(ReadString());
+                debugData->SetFileName(ReadString());
+                debugData->SetFileLine(ReadSigned());
+                debugData->SetFileColumn(ReadSigned());
+
+                m_LastDebugData = debugData;
+                return debugData;
+            }
+        }
+
+        ReportCorruption();
+        return nullptr;
+    }
+
+    DataType *AstReader::ReadDataType() {
+        if (ReadByte() == 0) {
+            return nullptr;
+        }
+
+        auto id = static_cast<DataTypeId>(ReadUnsigned());
+        DataType * templateType = ReadDataType();
+
+        return m_Arena.Create<DataType>(id, templateType);
+    }
+
+    Symbol AstReader::ReadSymbol() {
+        uint64_t index = ReadUnsigned();
+
+        if (index == 0) {
+            return {};
+        }
+
+        if (index > m_Symbols.size()) {
+            ReportCorruption();
+            return {};
+        }
+
+        Symbol & symbol = m_Symbols[index - 1];
+
+        if (!symbol.IsValid()) {
+            symbol = m_SourceManager.GetSymbols().Intern(m_Strings[index - 1]);
+        }
+
+        return symbol;
+    }
+
+    std::string_view AstReader::ReadString() {
+        uint64_t index = ReadUnsigned();
+
+        if (index >= m_Strings.size()) {
+            ReportCorruption();
+            return {};
+        }
+
+        return m_Strings[index];
+    }
+
+    uint64_t AstReader::ReadUnsigned() {
+        uint64_t value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = ReadByte();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+
+        ReportCorruption();
+        return 0;
+    }
+
+    int64_t AstReader::ReadSigned() {
+        uint64_t value = ReadUnsigned();
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    uint8_t AstReader::ReadByte() {
+        if (m_Position >= m_Data.size()) {
+            ReportCorruption();
+            return 0;
+        }
+
+        return static_cast<uint8_t>(m_Data[m_Position++]);
+    }
+
+    void AstReader::ReportCorruption() {
+        if (!m_IsCorrupted) {
+            COMPILER_WARN("Ignoring corrupted syntax tree, it can not be decoded at offset {0}", m_Position);
+        }
+
+        m_IsCorrupted = true;
+        m_Position = m_Data.size();
+    }
+
+}
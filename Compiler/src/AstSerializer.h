@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ExpressionVisitor.h"
+#include "Parser.h"
+
+namespace Hunter::Compiler {
+
+    class SourceManager;
+
+    /**
+     * Start of every serialized tree. The expressions follow right after it, all strings are
+     * stored once in a table at the end. Everything is written in host byte order,
+     * the files are only meant to be a local cache of the parser output.
+     */
+    struct AstFileHeader {
+        char Magic[4];
+        uint32_t Version;
+        uint64_t Size;
+        uint64_t StringTableOffset;
+        uint32_t StringCount;
+        uint32_t InstructionCount;
+        // of everything behind the header, so bodies which are decoded later can not be corrupted either
+        uint64_t Checksum;
+    };
+
+    class AstWriter : protected ExpressionVisitor<AstWriter> {
+    public:
+        // returns false if the file could not be written
+        static bool Write(AbstractSyntaxTree * tree, const std::string & filePath);
+        static std::string Serialize(AbstractSyntaxTree * tree);
+
+    protected:
+        void WriteExpression(Expression * expr);
+        void WriteBody(BlockExpression * block);
+        void WriteDebugData(Hunter::Parser::Debug::DebugData * debugData);
+        void WriteDataType(DataType * dataType);
+        void WriteSymbol(Symbol symbol);
+        void WriteString(std::string_view str);
+        void WriteUnsigned(uint64_t value);
+        void WriteSigned(int64_t value);
+        uint32_t GetStringIndex(std::string_view str);
+
+        void VisitExpression(Expression * expr);
+        void VisitImport(ImportExpression * expr);
+        void VisitModule(ModuleExpression * expr);
+        void VisitPrint(PrintExpression * expr);
+        void VisitExtern(ExternExpression * expr);
+        void VisitString(StringExpression * expr);
+        void VisitVariableMutation(VariableMutationExpression * expr);
+        void VisitBoolean(BooleanExpression * expr);
+        void VisitOperation(OperationExpression * expr);
+        void VisitInt(IntExpression * expr);
+        void VisitIdentifier(IdentifierExpression * expr);
+        void VisitStructConstruction(StructConstructionExpression * expr);
+        void VisitFunctionReturn(FunctionReturnExpression * expr);
+        void VisitFunctionCall(FunctionCallExpression * expr);
+        void VisitParameter(ParameterExpression * expr);
+        void VisitList(ListExpression * expr);
+        void VisitRange(RangeExpression * expr);
+        void VisitVariableDeclaration(VariableDeclarationExpression * expr);
+        void VisitPropertyDeclaration(PropertyDeclarationExpression * expr);
+        void VisitStruct(StructExpression * expr);
+        void VisitFunction(FunctionExpression * expr);
+        void VisitElse(ElseExpression * expr);
+        void VisitIf(IfExpression * expr);
+        void VisitWhile(WhileExpression * expr);
+        void VisitForLoop(ForLoopExpression * expr);
+
+    private:
+        std::string m_Data;
+        std::vector<std::string_view> m_Strings;
+        std::unordered_map<std::string_view, uint32_t> m_StringIndices;
+        Hunter::Parser::Debug::DebugData * m_LastDebugData = nullptr;
+
+        friend class ExpressionVisitor<AstWriter>;
+    };
+
+    /**
+     * Loads a serialized tree from a memory mapped file. The top level instructions are decoded
+     * right away, function bodies only once they are accessed. Strings point directly into the
+     * mapping, which is kept alive by the SourceManager. The reader itself lives in the arena of
+     * the loaded tree, as the bodies which are not decoded yet still need it.
+     */
+    class AstReader : public BodyDecoder {
+    public:
+        AstReader(SourceManager & sourceManager, std::string_view data, Arena & arena);
+
+        // returns nullptr if the file does not exist, was written for another version of the format or is corrupted
+        static AbstractSyntaxTree * Load(SourceManager & sourceManager, const std::string & filePath);
+        // the data has to stay alive as long as the tree, name is only used for messages
+        static AbstractSyntaxTree * Load(SourceManager & sourceManager, std::string_view data, const std::string & name);
+
+        void DecodeBody(size_t offset, std::vector<Expression *> & body) override;
+
+    protected:
+        Expression * ReadExpression();
+        void ReadBody(std::vector<Expression *> & body);
+        Hunter::Parser::Debug::DebugData * ReadDebugData();
+        DataType * ReadDataType();
+        Symbol ReadSymbol();
+        std::string_view ReadString();
+        uint64_t ReadUnsigned();
+        int64_t ReadSigned();
+        uint8_t ReadByte();
+
+        template<typename T>
+        T * ReadExpressionOf() {
+            Expression * expr = ReadExpression();
+
+            if (expr && !IsA<T>(expr)) {
+                ReportCorruption();
+                return nullptr;
+            }
+
+            return static_cast<T *>(expr);
+        }
+
+        // everything read afterwards is empty, so the reader can unwind. Load throws the tree away then
+        void ReportCorruption();
+
+    private:
+        SourceManager & m_SourceManager;
+        std::string_view m_Data;
+        Arena & m_Arena;
+        size_t m_Position = 0;
+        bool m_IsCorrupted = false;
+
+        std::vector<std::string_view> m_Strings;
+        // interned on first use, most strings of a module are never needed as symbols
+        std::vector<Symbol> m_Symbols;
+        Hunter::Parser::Debug::DebugData * m_LastDebugData = nullptr;
+    };
+
+}
@@ -6,6 +6,7 @@ namespace Hunter::Compiler {
         GenerateListFeature(builder);
     }
 
+    // the same layout as hunter_rt_list of the runtime, which creates and copies lists
     void BuiltinFeatureGenerator::GenerateListFeature(llvm::IRBuilder<> *builder) {
         std::vector<llvm::Type *> structTypes = {
             builder->getInt64Ty(), // elements number
@@ -14,6 +15,6 @@ namespace Hunter::Compiler {
 
         auto * structType = llvm::StructType::create(m_Generator->m_Context, structTypes, "list");
 
-        m_Generator->m_Structs["list"] = structType;
+        m_Generator->m_Structs.Set(m_Generator->m_ListSymbol, structType);
     }
 }
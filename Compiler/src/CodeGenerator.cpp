@@ -2,11 +2,11 @@
 #include "Parser.h"
 #include "Expressions.h"
 #include "BuiltinFeatureGenerator.h"
+#include "ImportResolver.h"
 #include "utils/logger.h"
 
 #include <iostream>
 
-#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
@@ -14,6 +14,7 @@
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Object/IRObjectFile.h>
+#include <llvm/Support/TimeProfiler.h>
 
 
 namespace Hunter::Compiler {
@@ -35,130 +36,157 @@ namespace Hunter::Compiler {
             case DataTypeId::i64:
                 return builder->getInt64Ty();
             case DataTypeId::List:
-                return llvm::PointerType::get(m_Structs["list"], 0);
+                return llvm::PointerType::get(m_Structs.Get(m_ListSymbol), 0);
             default:
                 COMPILER_ERROR("Unhandled data type: {0}", dataType);
                 exit(1);
         }
     }
 
-    std::string GetFormatPlaceholderFromDataType(DataTypeId dataType) {
-        switch (dataType) {
-            case DataTypeId::Void: {
-                COMPILER_ERROR("Unknown data type has no format string");
-                exit(1);
+    CodeGenerator::CodeGenerator(SymbolTable & symbols)
+        : m_BuiltinGenerator(new BuiltinFeatureGenerator(this)), m_Symbols(symbols), m_ListSymbol(symbols.Intern("list")) {}
+
+    CodeGenerator::CodeGenerator(SymbolTable & symbols, llvm::LLVMContext & context)
+        : m_BuiltinGenerator(new BuiltinFeatureGenerator(this)), m_ContextOwner(nullptr), m_Context(context), m_Symbols(symbols), m_ListSymbol(symbols.Intern("list")) {}
+
+    void ProgramDeclarations::AddUnit(const CompilationUnit &unit) {
+        for (const auto &instruction : unit.Instructions) {
+            FunctionExpression * funcExpr = DynCast<FunctionExpression>(instruction);
+
+            if (auto * externExpr = DynCast<ExternExpression>(instruction)) {
+                funcExpr = DynCast<FunctionExpression>(externExpr->GetData());
             }
-            case DataTypeId::Memory: {
-                return "%s";
+
+            // several modules can declare the same external function, the first one is used everywhere
+            if (funcExpr && !m_Functions.Contains(funcExpr->GetSymbol())) {
+                m_Functions.Set(funcExpr->GetSymbol(), funcExpr);
+                m_FunctionUnits.Set(funcExpr->GetSymbol(), &unit);
+            } else if (auto * structExpr = DynCast<StructExpression>(instruction); structExpr && !m_Structs.Contains(structExpr->GetStruct())) {
+                m_Structs.Set(structExpr->GetStruct(), structExpr);
             }
-            case DataTypeId::String:
-                return "%s";
-            case DataTypeId::i8:
-            case DataTypeId::i16:
-            case DataTypeId::i32:
-                return "%d";
-            case DataTypeId::i64:
-                return "%lld";
-            default:
-                COMPILER_ERROR("Unhandled data type: {0}", dataType);
-                exit(1);
         }
     }
 
-    CodeGenerator::CodeGenerator() : m_BuiltinGenerator(new BuiltinFeatureGenerator(this)) {}
-
-    llvm::Module *CodeGenerator::GenerateCode(AbstractSyntaxTree *ast) {
+    llvm::Module *CodeGenerator::GenerateCode(const CompilationUnit &unit) {
+        llvm::TimeTraceScope timeScope("GenerateCode", unit.IsMain ? "main" : unit.Module);
+        m_Unit = &unit;
+        m_Module = new llvm::Module(unit.IsMain ? "Hunt" : unit.Module, m_Context);
+        m_ConstantPool = std::make_unique<ConstantPool>(m_Module);
 
-        std::cout << std::endl << std::endl << "Generate code" << std::endl << "------------" << std::endl;
+        llvm::IRBuilder<> * builder;
 
-        m_Module = new llvm::Module("Hunt", m_Context);
-
-        llvm::Function *hunterFunction = llvm::Function::Create(
-                llvm::FunctionType::get(llvm::Type::getInt32Ty(m_Context), false),
-                llvm::Function::ExternalLinkage,
-                "main",
-                m_Module
-        );
+        if (unit.IsMain) {
+            llvm::Function *hunterFunction = llvm::Function::Create(
+                    llvm::FunctionType::get(llvm::Type::getInt32Ty(m_Context), false),
+                    llvm::Function::ExternalLinkage,
+                    "main",
+                    m_Module
+            );
 
-        llvm::BasicBlock *entryBlock = llvm::BasicBlock::Create(m_Context, "EntryBlock", hunterFunction);
-        auto *builder = new llvm::IRBuilder<>(entryBlock);
+            llvm::BasicBlock *entryBlock = llvm::BasicBlock::Create(m_Context, "EntryBlock", hunterFunction);
+            builder = new llvm::IRBuilder<>(entryBlock);
+        } else {
+            // without a main function there is nothing to insert into, the builder only provides the types
+            builder = new llvm::IRBuilder<>(m_Context);
+        }
 
         m_BuiltinGenerator->GenerateBuiltinFeatures(builder);
 
-        for (const auto &instr : ast->GetInstructions()) {
+        for (const auto &instr : unit.Instructions) {
             if (!m_DebugGenerator) {
                 m_DebugGenerator = new Debug::DebugGenerator(m_Module, this);
                 auto * debugData = instr->GetDebugData();
                 m_DebugGenerator->CreateCompileUnit(debugData);
             }
 
-            if (auto *funcExpr = dynamic_cast<FunctionExpression *>(instr)) {
+            if (auto *funcExpr = DynCast<FunctionExpression>(instr)) {
                 InsertFunctionExpression(builder, funcExpr);
-            } else {
+            } else if (unit.IsMain || IsA<StructExpression>(instr) || IsA<ExternExpression>(instr) || IsA<ModuleExpression>(instr)) {
                 InsertExpression(builder, instr);
+            } else {
+                COMPILER_ERROR("Only the main file can contain statements outside of a function, found {0} in module {1}", instr->GetClassName(), unit.Module);
+                exit(1);
             }
         }
 
-        builder->CreateRet(llvm::ConstantInt::get(m_Context, llvm::APInt(32, 0)));
+        if (unit.IsMain) {
+            builder->CreateRet(llvm::ConstantInt::get(m_Context, llvm::APInt(32, 0)));
+        }
+
+        delete builder;
 
         if (m_DebugGenerator) {
             m_DebugGenerator->Generate();
         }
 
-        std::error_code err;
-        llvm::raw_ostream *ostream = new llvm::raw_fd_ostream("output.bc", err);
-        llvm::WriteBitcodeToFile(*m_Module, *ostream);
-        delete ostream;
+        return m_Module;
+    }
 
-        llvm::raw_fd_ostream *moduleOutputStream = &(llvm::outs());
+    llvm::orc::ThreadSafeModule CodeGenerator::TakeModule() {
+        std::unique_ptr<llvm::Module> module(m_Module);
+        m_Module = nullptr;
 
-        if (!m_DebugOutputFileName.empty()) {
-            moduleOutputStream = new llvm::raw_fd_ostream(m_DebugOutputFileName, err);
-        }
+        return llvm::orc::ThreadSafeModule(std::move(module), std::move(m_ContextOwner));
+    }
 
-        m_Module->print(*moduleOutputStream, nullptr);
+    void CodeGenerator::InsertExpression(llvm::IRBuilder<> *builder, Expression *expr) {
+        Visit(expr, builder);
+    }
 
-        if (!m_DebugOutputFileName.empty()) {
-            delete moduleOutputStream;
-        }
+    void CodeGenerator::VisitExpression(Expression *expr, llvm::IRBuilder<> *builder) {
+        COMPILER_ERROR("Unhandled expression found: {0}", expr->GetClassName());
+        exit(1);
+    }
 
-        return m_Module;
+    void CodeGenerator::VisitPrint(PrintExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertPrintExpression(builder, expr);
     }
 
-    void CodeGenerator::InsertExpression(llvm::IRBuilder<> *builder, Expression *expr) {
-        if (auto *printExpr = dynamic_cast<PrintExpression *>(expr)) {
-            InsertPrintExpression(builder, printExpr);
-        } else if (auto *varDeclExpr = dynamic_cast<VariableDeclarationExpression *>(expr)) {
-            InsertVarDeclarationExpression(builder, varDeclExpr);
-        } else if (auto *varMutExpr = dynamic_cast<VariableMutationExpression *>(expr)) {
-            InsertVarMutationExpression(builder, varMutExpr);
-        } else if (auto *ifExpr = dynamic_cast<IfExpression *>(expr)) {
-            InsertIfExpression(builder, ifExpr);
-        } else if (auto *forExpr = dynamic_cast<ForLoopExpression *>(expr)) {
-            InsertForLoopExpression(builder, forExpr);
-        } else if (auto *whileExpr = dynamic_cast<WhileExpression *>(expr)) {
-            InsertWhileLoopExpression(builder, whileExpr);
-        } else if (auto *funcCallExpr = dynamic_cast<FunctionCallExpression *>(expr)) {
-            InsertFunctionCallExpression(builder, funcCallExpr);
-        } else if (auto *retExpr = dynamic_cast<FunctionReturnExpression *>(expr)) {
-            InsertFuncReturnExpression(builder, retExpr);
-        } else if (auto *structExpr = dynamic_cast<StructExpression *>(expr)) {
-            InsertStructDeclareExpression(builder, structExpr);
-        } else if (auto *externExpr = dynamic_cast<ExternExpression *>(expr)) {
-            if (auto * funcExpr = dynamic_cast<FunctionExpression *>(externExpr->GetData())) {
-                InsertFunctionExpression(builder, funcExpr);
-            } else {
-                COMPILER_ERROR("Unknown data type used for external declaration: {0}", externExpr->GetData()->GetClassName());
-                exit(1);
-            }
-        }  else if (auto *moduleExpr = dynamic_cast<ModuleExpression *>(expr)) {
-            // maybe this will not be here anymore
+    void CodeGenerator::VisitVariableDeclaration(VariableDeclarationExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertVarDeclarationExpression(builder, expr);
+    }
+
+    void CodeGenerator::VisitVariableMutation(VariableMutationExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertVarMutationExpression(builder, expr);
+    }
+
+    void CodeGenerator::VisitIf(IfExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertIfExpression(builder, expr);
+    }
+
+    void CodeGenerator::VisitForLoop(ForLoopExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertForLoopExpression(builder, expr);
+    }
+
+    void CodeGenerator::VisitWhile(WhileExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertWhileLoopExpression(builder, expr);
+    }
+
+    void CodeGenerator::VisitFunctionCall(FunctionCallExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertFunctionCallExpression(builder, expr);
+    }
+
+    void CodeGenerator::VisitFunctionReturn(FunctionReturnExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertFuncReturnExpression(builder, expr);
+    }
+
+    void CodeGenerator::VisitStruct(StructExpression *expr, llvm::IRBuilder<> *builder) {
+        InsertStructDeclareExpression(builder, expr);
+    }
+
+    void CodeGenerator::VisitExtern(ExternExpression *expr, llvm::IRBuilder<> *builder) {
+        if (auto * funcExpr = DynCast<FunctionExpression>(expr->GetData())) {
+            InsertFunctionExpression(builder, funcExpr);
         } else {
-            COMPILER_ERROR("Unhandled expression found: {0}", expr->GetClassName());
+            COMPILER_ERROR("Unknown data type used for external declaration: {0}", expr->GetData()->GetClassName());
             exit(1);
         }
     }
 
+    void CodeGenerator::VisitModule(ModuleExpression *expr, llvm::IRBuilder<> *builder) {
+        // maybe this will not be here anymore
+    }
+
     llvm::IntegerType *GetVariableTypeForInt(llvm::IRBuilder<> *builder, IntType type) {
         switch (type) {
             case IntType::i8:
@@ -173,69 +201,56 @@ namespace Hunter::Compiler {
     }
 
     void CodeGenerator::InsertFunctionExpression(llvm::IRBuilder<> *builder, FunctionExpression *funcExpr) {
-        std::string functionName = funcExpr->GetName();
+        Symbol function = funcExpr->GetSymbol();
+        std::string_view functionName = function.GetName();
+        llvm::TimeTraceScope timeScope("GenerateFunction", llvm::StringRef(functionName.data(), functionName.size()));
         llvm::Function *currentFunction;
 
-        if (m_Functions.contains(functionName)) {
-            currentFunction = m_Functions[functionName];
+        if (m_Functions.Contains(function)) {
+            currentFunction = m_Functions.Get(function);
         } else {
-            std::vector<llvm::Type *> parameterDescriptions;
-
-            for (const auto &parameter : funcExpr->GetParameters()) {
-                parameterDescriptions.push_back(GetTypeFromDataType(builder, parameter->GetDataType()->GetId()));
-            }
-
-            DataTypeId returnType = funcExpr->GetReturnType();
-            auto *simpleFuncType = llvm::FunctionType::get(GetTypeFromDataType(builder, returnType), parameterDescriptions, false);
-
-            currentFunction = llvm::Function::Create(
-                    simpleFuncType,
-                    llvm::Function::InternalLinkage,
-                    functionName,
-                    m_Module
+            // functions of modules are called from the other units, the ones of the main file are not.
+            // external declarations are resolved by the linker or the JIT, so they can never be internal
+            bool isVisible = funcExpr->IsExternal() || !m_Unit->IsMain;
+
+            currentFunction = DeclareFunction(
+                    builder,
+                    funcExpr,
+                    isVisible ? llvm::Function::ExternalLinkage : llvm::Function::InternalLinkage
             );
 
-            int argumentCounter = 0;
-            for (auto &arg : currentFunction->args()) {
-                arg.setName(funcExpr->GetParameters().at(argumentCounter)->GetName());
-                argumentCounter++;
-            }
-
-            m_Functions[functionName] = currentFunction;
-            m_FunctionsDefinitions[functionName] = funcExpr;
-
-//            m_DebugGenerator->DefineFunction(currentFunction, funcExpr);
-
             if (funcExpr->IsExternal()) {
                 return;
             }
 
+            m_DebugGenerator->DefineFunction(currentFunction, funcExpr);
+
             // Create a new basic block to start insertion into.
             llvm::BasicBlock::Create(m_Context, "entry", currentFunction);
         }
 
         llvm::IRBuilder<> funcBlockBuilder(&currentFunction->getEntryBlock(), currentFunction->getEntryBlock().begin());
-        std::unordered_map<std::string, llvm::Value *> outerVariables;
+        SymbolMap<llvm::Value> outerVariables;
 
         int argumentCounter = 0;
         for (const auto &arg : currentFunction->args()) {
             auto *parameter = funcExpr->GetParameters().at(argumentCounter);
-            auto parameterName = parameter->GetName();
+            Symbol parameterSymbol = parameter->GetSymbol();
 
-            if (m_Variables.contains(parameterName)) {
-                outerVariables[parameterName] = m_Variables[parameterName];
+            if (m_Variables.Contains(parameterSymbol)) {
+                outerVariables.Set(parameterSymbol, m_Variables.Get(parameterSymbol));
             }
 
             llvm::Value *variable = funcBlockBuilder.CreateAlloca(
                 GetTypeFromDataType(&funcBlockBuilder, parameter->GetDataType()->GetId()),
                 nullptr,
-                parameterName
+                parameter->GetName()
             );
 
             funcBlockBuilder.CreateStore((llvm::Value *)&arg, variable);
 
-            m_Variables[parameterName] = variable;
-            m_VariablesExpression[parameterName] = parameter;
+            m_Variables.Set(parameterSymbol, variable);
+            m_VariablesExpression.Set(parameterSymbol, parameter);
 
             argumentCounter++;
         }
@@ -245,30 +260,96 @@ namespace Hunter::Compiler {
         }
 
         for (const auto &parameter : funcExpr->GetParameters()) {
-            auto parameterName = parameter->GetName();
-            if (outerVariables.contains(parameterName)) {
-                m_Variables[parameterName] = outerVariables[parameterName];
+            Symbol parameterSymbol = parameter->GetSymbol();
+            if (outerVariables.Contains(parameterSymbol)) {
+                m_Variables.Set(parameterSymbol, outerVariables.Get(parameterSymbol));
             } else {
-                m_Variables.erase(parameterName);
+                m_Variables.Erase(parameterSymbol);
             }
         }
 
-//        if (!dynamic_cast<FunctionReturnExpression *>(*funcExpr->GetBody().end())) {
+//        if (!DynCast<FunctionReturnExpression>(*funcExpr->GetBody().end())) {
             funcBlockBuilder.CreateRetVoid();
 //        }
 
-        if (functionName == "hunt") {
+        if (functionName == "hunt" && m_Unit->IsMain) {
             builder->CreateCall(currentFunction);
         }
 
         m_DebugGenerator->PopLocation();
     }
 
+    llvm::Function *CodeGenerator::DeclareFunction(llvm::IRBuilder<> *builder, FunctionExpression *funcExpr, llvm::GlobalValue::LinkageTypes linkage) {
+        std::vector<llvm::Type *> parameterDescriptions;
+
+        for (const auto &parameter : funcExpr->GetParameters()) {
+            parameterDescriptions.push_back(GetTypeFromDataType(builder, parameter->GetDataType()->GetId()));
+        }
+
+        DataTypeId returnType = funcExpr->GetReturnType();
+        auto *simpleFuncType = llvm::FunctionType::get(GetTypeFromDataType(builder, returnType), parameterDescriptions, false);
+
+        llvm::Function *function = llvm::Function::Create(
+                simpleFuncType,
+                linkage,
+                funcExpr->GetName(),
+                m_Module
+        );
+
+        int argumentCounter = 0;
+        for (auto &arg : function->args()) {
+            arg.setName(funcExpr->GetParameters().at(argumentCounter)->GetName());
+            argumentCounter++;
+        }
+
+        m_Functions.Set(funcExpr->GetSymbol(), function);
+        m_FunctionsDefinitions.Set(funcExpr->GetSymbol(), funcExpr);
+
+        return function;
+    }
+
+    llvm::Function *CodeGenerator::GetFunction(Symbol function) {
+        if (m_Functions.Contains(function)) {
+            return m_Functions.Get(function);
+        }
+
+        // functions of the own unit still have to be defined before they are used
+        if (!m_Declarations || !m_Declarations->GetFunctionUnit(function) || m_Declarations->GetFunctionUnit(function) == m_Unit) {
+            return nullptr;
+        }
+
+        llvm::IRBuilder<> builder(m_Context);
+        return DeclareFunction(&builder, m_Declarations->GetFunction(function), llvm::Function::ExternalLinkage);
+    }
+
+    FunctionExpression *CodeGenerator::GetFunctionDefinition(Symbol function) {
+        if (m_FunctionsDefinitions.Contains(function)) {
+            return m_FunctionsDefinitions.Get(function);
+        }
+
+        return m_Declarations ? m_Declarations->GetFunction(function) : nullptr;
+    }
+
+    llvm::StructType *CodeGenerator::GetStruct(Symbol structSymbol) {
+        if (!m_Structs.Contains(structSymbol) && m_Declarations && m_Declarations->GetStruct(structSymbol)) {
+            // types can not be shared between contexts, so every unit creates its own
+            llvm::IRBuilder<> builder(m_Context);
+            InsertStructDeclareExpression(&builder, m_Declarations->GetStruct(structSymbol));
+        }
+
+        return m_Structs.Get(structSymbol);
+    }
+
+    StructExpression *CodeGenerator::GetStructDefinition(Symbol structSymbol) {
+        GetStruct(structSymbol);
+        return m_StructsDefinitions.Get(structSymbol);
+    }
+
     void CodeGenerator::InsertStructDeclareExpression(llvm::IRBuilder<> *builder, StructExpression *structExpr) {
         std::vector<llvm::Type *> structTypes;
 
         for (const auto &propertyExpr : structExpr->GetBody()) {
-            if (auto * property = dynamic_cast<PropertyDeclarationExpression *>(propertyExpr)) {
+            if (auto * property = DynCast<PropertyDeclarationExpression>(propertyExpr)) {
                 structTypes.push_back(GetTypeFromDataType(builder, GetVariableDeclarationType(property)));
             } else {
                 COMPILER_ERROR("Struct body element is not a property: {0}", propertyExpr->GetClassName());
@@ -276,15 +357,14 @@ namespace Hunter::Compiler {
             }
         }
 
-        std::string structName = structExpr->GetStructName();
-        auto * structType = llvm::StructType::create(m_Context, structTypes, structName);
+        auto * structType = llvm::StructType::create(m_Context, structTypes, structExpr->GetStructName());
 
-        m_Structs[structName] = structType;
-        m_StructsDefinitions[structName] = structExpr;
+        m_Structs.Set(structExpr->GetStruct(), structType);
+        m_StructsDefinitions.Set(structExpr->GetStruct(), structExpr);
     }
 
     void CodeGenerator::InsertIfExpression(llvm::IRBuilder<> *builder, IfExpression *ifExpr) {
-        auto *condition = dynamic_cast<BooleanExpression *>(ifExpr->GetCondition());
+        auto *condition = DynCast<BooleanExpression>(ifExpr->GetCondition());
         llvm::Value *compareResult = GetConditionFromExpression(builder, condition);
 
         llvm::Function *func = builder->GetInsertBlock()->getParent();
@@ -320,12 +400,14 @@ namespace Hunter::Compiler {
 
     void CodeGenerator::InsertForLoopExpression(llvm::IRBuilder<> *builder, ForLoopExpression *forExpr) {
         // create loop counter
-        if (auto *range = dynamic_cast<RangeExpression *>(forExpr->GetRange())) {
+        if (auto *range = DynCast<RangeExpression>(forExpr->GetRange())) {
             IntType intType = IntType::i64;
             llvm::IntegerType *counterType = GetVariableTypeForInt(builder, intType);
 
-            std::string counterName = forExpr->GetCounter();
-            InsertIntExpression(builder, counterName, new IntExpression(intType, range->GetStart()));
+            Symbol counter = forExpr->GetCounter();
+            // only referenced while the loop body is generated
+            IntExpression counterStart(intType, range->GetStart());
+            InsertIntExpression(builder, counter, &counterStart);
             llvm::ConstantInt *endValue = llvm::ConstantInt::get(counterType, range->GetEnd());
 
             llvm::Function *currentFunction = builder->GetInsertBlock()->getParent();
@@ -342,12 +424,12 @@ namespace Hunter::Compiler {
             // step
             llvm::Constant *step = llvm::ConstantInt::get(counterType, 1);
 
-            llvm::Value *loadedCounter = builder->CreateLoad(counterType, m_Variables[counterName]);
+            llvm::Value *loadedCounter = builder->CreateLoad(counterType, m_Variables.Get(counter));
             llvm::Value *nextCounter = builder->CreateAdd(loadedCounter, step, "next-counter");
-            builder->CreateStore(nextCounter, m_Variables[counterName]);
+            builder->CreateStore(nextCounter, m_Variables.Get(counter));
 
             llvm::Value *conditionResult = builder->CreateICmpSLE(
-                    builder->CreateLoad(counterType, m_Variables[counterName]),
+                    builder->CreateLoad(counterType, m_Variables.Get(counter)),
                     endValue,
                     "loop-condition"
             );
@@ -358,8 +440,8 @@ namespace Hunter::Compiler {
 
             // Any new code will be inserted in AfterBB.
             builder->SetInsertPoint(afterLoopBlock);
-            m_Variables.erase(counterName);
-            m_VariablesExpression.erase(counterName);
+            m_Variables.Erase(counter);
+            m_VariablesExpression.Erase(counter);
         } else {
             std::cerr << "Unknown expression type for range" << std::endl;
             exit(1);
@@ -367,7 +449,7 @@ namespace Hunter::Compiler {
     }
 
     void CodeGenerator::InsertWhileLoopExpression(llvm::IRBuilder<> *builder, WhileExpression *whileExpr) {
-        if (auto *conditionExpr = dynamic_cast<BooleanExpression *>(whileExpr->GetCondition())) {
+        if (auto *conditionExpr = DynCast<BooleanExpression>(whileExpr->GetCondition())) {
             llvm::Function *currentFunction = builder->GetInsertBlock()->getParent();
             llvm::BasicBlock *loopBlock = llvm::BasicBlock::Create(m_Context, "while-loop", currentFunction);
             llvm::BasicBlock *loopBodyBlock = llvm::BasicBlock::Create(m_Context, "while-body", currentFunction);
@@ -397,73 +479,79 @@ namespace Hunter::Compiler {
 
     void CodeGenerator::InsertPrintExpression(llvm::IRBuilder<> *builder, PrintExpression *printExpr) {
 
-        if (auto *funcCallExpr = dynamic_cast<FunctionCallExpression *>(printExpr->GetInput())) {
-            std::string formatString;
-            std::vector<llvm::Value *> ops;
+        if (auto *funcCallExpr = DynCast<FunctionCallExpression>(printExpr->GetInput())) {
+            // literals next to each other are written at once, their text is known at compile time
+            std::string literal;
+
+            auto writeLiteral = [&]() {
+                if (!literal.empty()) {
+                    builder->CreateCall(GetRuntimeFunction("hunter_rt_write"), {
+                        m_ConstantPool->GetString(literal),
+                        builder->getInt64(literal.size())
+                    });
+                    literal.clear();
+                }
+            };
+
+            auto writeValue = [&](llvm::Value *value, DataTypeId dataType) {
+                writeLiteral();
+
+                switch (dataType) {
+                    case DataTypeId::Memory:
+                    case DataTypeId::String:
+                        builder->CreateCall(GetRuntimeFunction("hunter_rt_write_string"), {builder->CreateBitCast(value, builder->getInt8PtrTy())});
+                        break;
+                    case DataTypeId::i8:
+                    case DataTypeId::i16:
+                    case DataTypeId::i32:
+                        builder->CreateCall(GetRuntimeFunction("hunter_rt_write_i32"), {builder->CreateSExt(value, builder->getInt32Ty())});
+                        break;
+                    case DataTypeId::i64:
+                        builder->CreateCall(GetRuntimeFunction("hunter_rt_write_i64"), {value});
+                        break;
+                    default:
+                        COMPILER_ERROR("Data type {0} can not be printed", GetDataTypeString(dataType));
+                        exit(1);
+                }
+            };
 
             m_DebugGenerator->EmitLocation(builder, printExpr);
 
             for (const auto &parameter : funcCallExpr->GetParameters()) {
 
-                if (auto *strExpr = dynamic_cast<StringExpression *>(parameter)) {
-                    llvm::GlobalVariable *strData = builder->CreateGlobalString(llvm::StringRef(strExpr->GetString()));
-                    ops.push_back(strData);
-                    formatString += "%s";
-
-                } else if (auto *identifierExpr = dynamic_cast<IdentifierExpression *>(parameter)) {
-                    std::string variableName = identifierExpr->GetVariableName();
-                    std::string propertyName;
+                if (auto *strExpr = DynCast<StringExpression>(parameter)) {
+                    literal += strExpr->GetString();
 
-                    uint64_t lastDotPosition = variableName.find_last_of('.');
-
-                    if (lastDotPosition != std::string::npos) {
-                        propertyName = variableName.substr(lastDotPosition+1);
-                        std::string objectName = variableName.substr(0, lastDotPosition);
-                        variableName = objectName;
-                    }
+                } else if (auto *identifierExpr = DynCast<IdentifierExpression>(parameter)) {
+                    Symbol variable = identifierExpr->GetObject();
+                    std::string_view variableName = variable.GetName();
 
-                    if (!m_Variables.contains(variableName)) {
+                    if (!m_Variables.Contains(variable)) {
                         COMPILER_ERROR("Could not find variable {0}", variableName);
                         exit(1);
                     }
 
-                    Expression *variableExpr = m_VariablesExpression[variableName];
+                    Expression *variableExpr = m_VariablesExpression.Get(variable);
 
-                    if (dynamic_cast<StringExpression *>(variableExpr)) {
-                        ops.push_back(builder->CreateLoad(builder->getInt8PtrTy(), m_Variables[variableName]));
-                        formatString += "%s";
-                    } else if (auto *intValExpr = dynamic_cast<IntExpression *>(variableExpr)) {
+                    if (DynCast<StringExpression>(variableExpr)) {
+                        writeValue(builder->CreateLoad(builder->getInt8PtrTy(), m_Variables.Get(variable)), DataTypeId::String);
+                    } else if (auto *intValExpr = DynCast<IntExpression>(variableExpr)) {
                         IntType type = intValExpr->GetType();
                         auto *loadExpr = builder->CreateLoad(GetVariableTypeForInt(builder, type),
-                                                             m_Variables[variableName]);
-                        ops.push_back(loadExpr);
-
-                        if (type == IntType::i64) {
-                            formatString += "%lld";
-                        } else {
-                            formatString += "%d";
-                        }
-                    } else if (auto *parameterExpr = dynamic_cast<ParameterExpression *>(variableExpr)) {
+                                                             m_Variables.Get(variable));
+                        writeValue(loadExpr, static_cast<DataTypeId>(type));
+                    } else if (auto *parameterExpr = DynCast<ParameterExpression>(variableExpr)) {
                         auto parameterType = parameterExpr->GetDataType()->GetId();
-                        if (parameterType == DataTypeId::String) {
-                            ops.push_back(builder->CreateLoad(builder->getInt8PtrTy(), m_Variables[variableName]));
-                            formatString += "%s";
-                        } else if (
+                        if (
+                                parameterType == DataTypeId::String ||
                                 parameterType == DataTypeId::i8 ||
                                 parameterType == DataTypeId::i16 ||
                                 parameterType == DataTypeId::i32 ||
                                 parameterType == DataTypeId::i64
                         ) {
-                            auto type = static_cast<IntType>(parameterType);
                             auto *loadExpr = builder->CreateLoad(GetTypeFromDataType(builder, parameterType),
-                                                                 m_Variables[variableName]);
-                            ops.push_back(loadExpr);
-
-                            if (type == IntType::i64) {
-                                formatString += "%lld";
-                            } else {
-                                formatString += "%d";
-                            }
+                                                                 m_Variables.Get(variable));
+                            writeValue(loadExpr, parameterType);
                         } else {
                             COMPILER_ERROR(
                                 "Parameter {0} with type {1} not supported for print",
@@ -472,21 +560,18 @@ namespace Hunter::Compiler {
                            );
                             exit(1);
                         }
-                    } else if (auto * funcCallExpr = dynamic_cast<FunctionCallExpression *>(variableExpr)) {
-                        auto * funcDef = m_FunctionsDefinitions[funcCallExpr->GetFunctionName()];
+                    } else if (auto * funcCallExpr = DynCast<FunctionCallExpression>(variableExpr)) {
+                        auto * funcDef = GetFunctionDefinition(funcCallExpr->GetFunction());
                         auto * funcReturnType = GetTypeFromDataType(builder, funcDef->GetReturnType());
-                        auto * funcReturnValue = builder->CreateLoad(funcReturnType, m_Variables[variableName]);
-                        ops.push_back(funcReturnValue);
-                        formatString += GetFormatPlaceholderFromDataType(funcDef->GetReturnType());
-                    } else if (auto * structConstrExpr = dynamic_cast<StructConstructionExpression *>(variableExpr)) {
-                        std::string structName = structConstrExpr->GetStructName();
-
-                        llvm::StructType * structType = m_Structs[structName];
-                        StructExpression * structExpr = m_StructsDefinitions[structName];
+                        auto * funcReturnValue = builder->CreateLoad(funcReturnType, m_Variables.Get(variable));
+                        writeValue(funcReturnValue, funcDef->GetReturnType());
+                    } else if (auto * structConstrExpr = DynCast<StructConstructionExpression>(variableExpr)) {
+                        llvm::StructType * structType = GetStruct(structConstrExpr->GetStruct());
+                        StructExpression * structExpr = GetStructDefinition(structConstrExpr->GetStruct());
                         llvm::Type * structPointerType = llvm::PointerType::get(structType, 0);
-                        uint64_t propertyIndex = structExpr->GetPropertyIndex(propertyName);
+                        uint64_t propertyIndex = structExpr->GetPropertyIndex(identifierExpr->GetProperty());
 
-                        auto * loadedValue = builder->CreateLoad(structPointerType, m_Variables[variableName]);
+                        auto * loadedValue = builder->CreateLoad(structPointerType, m_Variables.Get(variable));
 
                         auto * attributePointer = builder->CreateStructGEP(
                                 structType,
@@ -494,11 +579,11 @@ namespace Hunter::Compiler {
                                 propertyIndex
                         );
 
-                        auto * structPropertyValue = builder->CreateLoad(structPointerType, attributePointer);
-                        ops.push_back(structPropertyValue);
+                        auto * propertyExpr = DynCast<PropertyDeclarationExpression>(structExpr->GetBody().at(propertyIndex));
+                        DataTypeId propertyType = GetVariableDeclarationType(propertyExpr);
 
-                        auto * propertyExpr = dynamic_cast<PropertyDeclarationExpression *>(structExpr->GetBody().at(propertyIndex));
-                        formatString += GetFormatPlaceholderFromDataType(GetVariableDeclarationType(propertyExpr));
+                        auto * structPropertyValue = builder->CreateLoad(GetTypeFromDataType(builder, propertyType), attributePointer);
+                        writeValue(structPropertyValue, propertyType);
 
                     } else if (!variableExpr) {
                         COMPILER_ERROR("Invalid expression found for variable {0}", variableName);
@@ -514,10 +599,7 @@ namespace Hunter::Compiler {
                 }
             }
 
-            llvm::GlobalVariable *var = builder->CreateGlobalString(llvm::StringRef(formatString));
-            ops.insert(ops.cbegin(), var);
-
-            builder->CreateCall(GetCLibraryFunction("printf"), llvm::ArrayRef(ops));
+            writeLiteral();
         }
     }
 
@@ -527,13 +609,12 @@ namespace Hunter::Compiler {
 
         for (const auto &parameter : funcCallExpr->GetParameters()) {
 
-            if (auto *strExpr = dynamic_cast<StringExpression *>(parameter)) {
-                llvm::GlobalVariable *strData = builder->CreateGlobalString(llvm::StringRef(strExpr->GetString()));
-                ops.push_back(strData);
+            if (auto *strExpr = DynCast<StringExpression>(parameter)) {
+                ops.push_back(m_ConstantPool->GetString(strExpr->GetString()));
 
-            } else if (auto *identifierExpr = dynamic_cast<IdentifierExpression *>(parameter)) {
-                ops.push_back(GetVariableValue(builder, identifierExpr->GetVariableName()));
-            } else if (auto *intExpr = dynamic_cast<IntExpression *>(parameter)) {
+            } else if (auto *identifierExpr = DynCast<IdentifierExpression>(parameter)) {
+                ops.push_back(GetVariableValue(builder, identifierExpr->GetVariable()));
+            } else if (auto *intExpr = DynCast<IntExpression>(parameter)) {
                 auto * value = GetValueFromExpression(builder, intExpr);
                 ops.push_back(value);
             } else {
@@ -542,14 +623,16 @@ namespace Hunter::Compiler {
             }
         }
 
-        auto functionName = funcCallExpr->GetFunctionName();
+        Symbol function = funcCallExpr->GetFunction();
+
+        llvm::Function * calledFunction = GetFunction(function);
 
-        if (!m_Functions.contains(functionName)) {
-            COMPILER_ERROR("Function not defined: {0}", functionName);
+        if (!calledFunction) {
+            COMPILER_ERROR("Function not defined: {0}", function.GetName());
             exit(1);
         }
 
-        return builder->CreateCall(m_Functions[functionName], llvm::ArrayRef(ops));
+        return builder->CreateCall(calledFunction, llvm::ArrayRef(ops));
     }
 
     llvm::Constant *GetIntValue(llvm::IRBuilder<> *builder, IntExpression *expr) {
@@ -568,28 +651,29 @@ namespace Hunter::Compiler {
     void CodeGenerator::InsertVarDeclarationExpression(llvm::IRBuilder<> *builder, VariableDeclarationExpression *constExpr) {
         m_DebugGenerator->EmitLocation(builder, constExpr);
 
-        std::string variableName = constExpr->GetVariableName();
+        Symbol variable = constExpr->GetVariable();
+        std::string_view variableName = variable.GetName();
         Expression *value = constExpr->GetValue();
 
-        if (m_Variables.contains(variableName)) {
+        if (m_Variables.Contains(variable)) {
             COMPILER_ERROR("Variable {0} was already defined", variableName);
             exit(1);
         }
 
-        if (auto *strExpr = dynamic_cast<StringExpression *>(value)) {
-            llvm::GlobalVariable *strData = builder->CreateGlobalString(llvm::StringRef(strExpr->GetString()));
+        if (auto *strExpr = DynCast<StringExpression>(value)) {
+            llvm::Constant *strData = m_ConstantPool->GetString(strExpr->GetString());
             auto *var = builder->CreateAlloca(builder->getInt8PtrTy(), nullptr, variableName);
             m_DebugGenerator->DefineVariable(builder, var, constExpr);
 
-            m_Variables[variableName] = var;
-            m_VariablesExpression[variableName] = value;
+            m_Variables.Set(variable, var);
+            m_VariablesExpression.Set(variable, value);
 
             builder->CreateStore(strData, var);
-        } else if (auto *intExpr = dynamic_cast<IntExpression *>(value)) {
-           auto * var = InsertIntExpression(builder, variableName, intExpr);
+        } else if (auto *intExpr = DynCast<IntExpression>(value)) {
+           auto * var = InsertIntExpression(builder, variable, intExpr);
            m_DebugGenerator->DefineVariable(builder, var, constExpr);
-        } else if (auto *funcCallExpr = dynamic_cast<FunctionCallExpression *>(value)) {
-            auto * func = m_FunctionsDefinitions[funcCallExpr->GetFunctionName()];
+        } else if (auto *funcCallExpr = DynCast<FunctionCallExpression>(value)) {
+            auto * func = GetFunctionDefinition(funcCallExpr->GetFunction());
 
             if (!func) {
                 COMPILER_ERROR("Could not find function definition for {0}", funcCallExpr->GetFunctionName());
@@ -600,86 +684,103 @@ namespace Hunter::Compiler {
             auto *var = builder->CreateAlloca(GetTypeFromDataType(builder, returnType), nullptr, variableName);
             m_DebugGenerator->DefineVariable(builder, var, constExpr);
 
-            m_Variables[variableName] = var;
-            m_VariablesExpression[variableName] = value;
+            m_Variables.Set(variable, var);
+            m_VariablesExpression.Set(variable, value);
 
             llvm::Value * funcReturnVal = InsertFunctionCallExpression(builder, funcCallExpr);
             builder->CreateStore(funcReturnVal, var);
-        } else if (auto *structConstrExpr = dynamic_cast<StructConstructionExpression *>(value)) {
-            std::string structName = structConstrExpr->GetStructName();
-            if (!m_Structs.contains(structName)) {
-                COMPILER_ERROR("A struct with the name \"{0}\" does not exist", structName);
+        } else if (auto *structConstrExpr = DynCast<StructConstructionExpression>(value)) {
+            Symbol structSymbol = structConstrExpr->GetStruct();
+            if (!GetStruct(structSymbol)) {
+                COMPILER_ERROR("A struct with the name \"{0}\" does not exist", structSymbol.GetName());
                 exit(1);
             }
 
-            llvm::StructType * structType = m_Structs[structName];
-            StructExpression * structExpr = m_StructsDefinitions[structName];
+            llvm::StructType * structType = GetStruct(structSymbol);
+            StructExpression * structExpr = GetStructDefinition(structSymbol);
             llvm::Type * structPointerType = llvm::PointerType::get(structType, 0);
             auto *var = builder->CreateAlloca(structPointerType, nullptr, variableName);
             //m_DebugGenerator->DefineVariable(builder, var, structConstrExpr);
 
-            m_Variables[variableName] = var;
-            m_VariablesExpression[variableName] = value;
+            m_Variables.Set(variable, var);
+            m_VariablesExpression.Set(variable, value);
 
             std::vector<llvm::Value *> ops;
             auto dataLayout = m_Module->getDataLayout();
             ops.push_back(builder->getInt64(dataLayout.getStructLayout(structType)->getSizeInBytes()));
 
-            auto * structData = builder->CreateCall(GetCLibraryFunction("malloc"), llvm::ArrayRef(ops));
+            auto * structData = builder->CreateCall(GetRuntimeFunction("hunter_rt_alloc"), llvm::ArrayRef(ops));
             auto * value = builder->CreateBitCast(structData, structPointerType);
             builder->CreateStore(value, var);
 
             for (const auto &attribute : structConstrExpr->GetAttributes()) {
-                auto * attributePointer = builder->CreateStructGEP(
-                    structType,
-                    value,
-                    structExpr->GetPropertyIndex(attribute->GetVariableName())
-                );
+                auto propertyIndex = static_cast<unsigned>(structExpr->GetPropertyIndex(attribute->GetVariable()));
+                auto * attributePointer = builder->CreateStructGEP(structType, value, propertyIndex);
+                llvm::Type * propertyType = structType->getElementType(propertyIndex);
+                llvm::Value * attributeValue = GetValueFromExpression(builder, attribute->GetValue());
+
+                // literals get the smallest type which fits their value, the property decides what is stored
+                if (attributeValue->getType()->isIntegerTy() && propertyType->isIntegerTy()) {
+                    attributeValue = builder->CreateSExtOrTrunc(attributeValue, propertyType);
+                } else if (attributeValue->getType()->isPointerTy() && propertyType->isPointerTy()) {
+                    attributeValue = builder->CreatePointerCast(attributeValue, propertyType);
+                }
 
-                builder->CreateStore(GetValueFromExpression(builder, attribute->GetValue()), attributePointer);
+                builder->CreateStore(attributeValue, attributePointer);
             }
 
-        } else if (auto *listConstrExpr = dynamic_cast<ListExpression *>(value)) {
-
-            // todo: optimize this so not everything has to be written here
-            llvm::StructType * structType = m_Structs["list"];
+        } else if (auto *listConstrExpr = DynCast<ListExpression>(value)) {
+            llvm::StructType * structType = m_Structs.Get(m_ListSymbol);
             llvm::Type * structPointerType = llvm::PointerType::get(structType, 0);
             auto *var = builder->CreateAlloca(structPointerType, nullptr, variableName);
 
-            m_Variables[variableName] = var;
-            m_VariablesExpression[variableName] = value;
-
-            // allocate list structure
-            std::vector<llvm::Value *> ops;
-            auto dataLayout = m_Module->getDataLayout();
-            ops.push_back(builder->getInt64(dataLayout.getStructLayout(structType)->getSizeInBytes()));
-
-            auto * structData = builder->CreateCall(GetCLibraryFunction("malloc"), llvm::ArrayRef(ops));
-            auto * value = builder->CreateBitCast(structData, structPointerType);
-            builder->CreateStore(value, var);
-
-            // store list size
-            auto * elementsNumberPointer = builder->CreateStructGEP(structType, value,0);
-            builder->CreateStore(builder->getInt64(listConstrExpr->GetElements().size()), elementsNumberPointer);
+            m_Variables.Set(variable, var);
+            m_VariablesExpression.Set(variable, value);
 
-            // allocate static list data space
-            std::vector<llvm::Value *> ops2;
-            ops.push_back(builder->getInt64(dataLayout.getPointerTypeSize(GetTypeFromDataType(builder, listConstrExpr->GetDataType()))));
+            std::vector<llvm::Value *> elements;
+            for (const auto &element : listConstrExpr->GetElements()) {
+                elements.push_back(GetValueFromExpression(builder, element));
+            }
 
-            auto * listDataType = llvm::PointerType::get(builder->getInt8PtrTy(), 0);
-            auto * listDataSpace = builder->CreateCall(GetCLibraryFunction("malloc"), llvm::ArrayRef(ops2));
-            auto * listPointer = builder->CreateBitCast(listDataSpace, listDataType);
-            int elementIndex = 0;
+            // literals get the smallest type which fits their value, all elements are widened to the largest one
+            llvm::Type * elementType = elements.empty() ? builder->getInt8PtrTy() : elements.front()->getType();
+            for (const auto &element : elements) {
+                if (element->getType()->isIntegerTy() && elementType->isIntegerTy()) {
+                    if (element->getType()->getIntegerBitWidth() > elementType->getIntegerBitWidth()) {
+                        elementType = element->getType();
+                    }
+                } else if (element->getType() != elementType) {
+                    COMPILER_ERROR("The elements of list {0} have different types", variableName);
+                    exit(1);
+                }
+            }
 
-            for (const auto &element : listConstrExpr->GetElements()) {
-                if (auto * strElement = dynamic_cast<StringExpression *>(element)) {
-                    auto * strElementValue = GetValueFromExpression(builder, strElement);
+            std::vector<llvm::Constant *> constantElements;
+            for (auto &element : elements) {
+                element = builder->CreateSExtOrBitCast(element, elementType);
 
-                    auto * listArrayPointer = builder->CreateAdd(listPointer, builder->getInt32(elementIndex));
-                    builder->CreateStore(strElementValue, elementsNumberPointer);
+                if (auto * constantElement = llvm::dyn_cast<llvm::Constant>(element)) {
+                    constantElements.push_back(constantElement);
                 }
+            }
 
-                elementIndex++;
+            if (constantElements.size() == elements.size()) {
+                // lists can not be changed yet, an operation which changes one has to copy a constant list first
+                builder->CreateStore(m_ConstantPool->GetList(structType, elementType, constantElements), var);
+            } else {
+                auto dataLayout = m_Module->getDataLayout();
+                auto * list = builder->CreateCall(GetRuntimeFunction("hunter_rt_list_new"), {
+                    builder->getInt64(elements.size()),
+                    builder->getInt64(dataLayout.getTypeAllocSize(elementType))
+                });
+                builder->CreateStore(list, var);
+
+                auto * listData = builder->CreateLoad(structType->getElementType(1), builder->CreateStructGEP(structType, list, 1));
+                auto * elementsPointer = builder->CreateBitCast(listData, llvm::PointerType::get(elementType, 0));
+
+                for (size_t i = 0; i < elements.size(); ++i) {
+                    builder->CreateStore(elements[i], builder->CreateConstInBoundsGEP1_64(elementType, elementsPointer, i));
+                }
             }
 
         } else {
@@ -690,14 +791,14 @@ namespace Hunter::Compiler {
 
     void
     CodeGenerator::InsertVarMutationExpression(llvm::IRBuilder<> *builder, VariableMutationExpression *varMutExpr) {
-        if (auto *operatorExpr = dynamic_cast<OperationExpression *>(varMutExpr->GetValue())) {
+        if (auto *operatorExpr = DynCast<OperationExpression>(varMutExpr->GetValue())) {
             if (operatorExpr->GetOperator() == OperatorType::MathPlus) {
-                llvm::Value *variable = m_Variables[varMutExpr->GetVariableName()];
+                llvm::Value *variable = m_Variables.Get(varMutExpr->GetVariable());
 
                 llvm::Value *incrementedValue = builder->CreateAdd(
                         GetValueFromExpression(builder, operatorExpr->Left()),
                         GetValueFromExpression(builder, operatorExpr->Right()),
-                        "next-" + varMutExpr->GetVariableName()
+                        "next-" + std::string(varMutExpr->GetVariableName())
                 );
                 builder->CreateStore(incrementedValue, variable);
             } else {
@@ -715,11 +816,11 @@ namespace Hunter::Compiler {
         builder->CreateRet(GetValueFromExpression(builder, retExpr->GetValue()));
     }
 
-    llvm::AllocaInst * CodeGenerator::InsertIntExpression(llvm::IRBuilder<> *builder, const std::string &variableName,
+    llvm::AllocaInst * CodeGenerator::InsertIntExpression(llvm::IRBuilder<> *builder, Symbol variable,
                                             IntExpression *intExpr) {
-        auto *var = builder->CreateAlloca(GetVariableTypeForInt(builder, intExpr->GetType()), nullptr, variableName);
-        m_Variables[variableName] = var;
-        m_VariablesExpression[variableName] = intExpr;
+        auto *var = builder->CreateAlloca(GetVariableTypeForInt(builder, intExpr->GetType()), nullptr, variable.GetName());
+        m_Variables.Set(variable, var);
+        m_VariablesExpression.Set(variable, intExpr);
 
         builder->CreateStore(GetIntValue(builder, intExpr), var);
 
@@ -735,12 +836,12 @@ namespace Hunter::Compiler {
 
         auto * value = expr->GetValue();
 
-        if (dynamic_cast<StringExpression *>(value)) {
+        if (DynCast<StringExpression>(value)) {
             return DataTypeId::String;
-        } else if (auto *intExpr = dynamic_cast<IntExpression *>(value)) {
+        } else if (auto *intExpr = DynCast<IntExpression>(value)) {
             return static_cast<DataTypeId>(GetTypeFromValue(intExpr->GetValue()));
-        } else if (auto *funcCallExpr = dynamic_cast<FunctionCallExpression *>(value)) {
-            auto * funcDef = m_FunctionsDefinitions[funcCallExpr->GetFunctionName()];
+        } else if (auto *funcCallExpr = DynCast<FunctionCallExpression>(value)) {
+            auto * funcDef = GetFunctionDefinition(funcCallExpr->GetFunction());
             return funcDef->GetReturnType();
         } else {
             COMPILER_ERROR("Not supported variable value type: {0}", value->GetClassName());
@@ -750,46 +851,43 @@ namespace Hunter::Compiler {
 
     llvm::Value *CodeGenerator::GetValueFromExpression(llvm::IRBuilder<> *builder, Expression *expr) {
 
-        if (auto *intValExpr = dynamic_cast<IntExpression *>(expr)) {
+        if (auto *intValExpr = DynCast<IntExpression>(expr)) {
             return GetIntValue(builder, intValExpr);
-        } else if (auto *identifierExpr = dynamic_cast<IdentifierExpression *>(expr)) {
-            std::string variableName = identifierExpr->GetVariableName();
-            return GetVariableValue(builder, variableName);
-        } else if (auto *strExpr = dynamic_cast<StringExpression *>(expr)) {
-            llvm::GlobalVariable *strData = builder->CreateGlobalString(llvm::StringRef(strExpr->GetString()));
-            return strData;
+        } else if (auto *identifierExpr = DynCast<IdentifierExpression>(expr)) {
+            return GetVariableValue(builder, identifierExpr->GetVariable());
+        } else if (auto *strExpr = DynCast<StringExpression>(expr)) {
+            return m_ConstantPool->GetString(strExpr->GetString());
         }
 
         std::cerr << "Could not map expression to value" << std::endl;
         exit(1);
     }
 
-    llvm::Value *CodeGenerator::GetVariableValue(llvm::IRBuilder<> *builder, const std::string &variableName) {
-        if (!m_Variables.contains(variableName)) {
-            std::cerr << "Could not find variable " << variableName << std::endl;
+    llvm::Value *CodeGenerator::GetVariableValue(llvm::IRBuilder<> *builder, Symbol variable) {
+        if (!m_Variables.Contains(variable)) {
+            std::cerr << "Could not find variable " << variable.GetName() << std::endl;
             exit(1);
         }
 
-        Expression *variableExpr = m_VariablesExpression[variableName];
+        Expression *variableExpr = m_VariablesExpression.Get(variable);
 
-        if (dynamic_cast<StringExpression *>(variableExpr)) {
-            return builder->CreateLoad(builder->getInt8PtrTy(), m_Variables[variableName]);
-        } else if (auto *intValExpr = dynamic_cast<IntExpression *>(variableExpr)) {
+        if (DynCast<StringExpression>(variableExpr)) {
+            return builder->CreateLoad(builder->getInt8PtrTy(), m_Variables.Get(variable));
+        } else if (auto *intValExpr = DynCast<IntExpression>(variableExpr)) {
             IntType type = intValExpr->GetType();
-            return builder->CreateLoad(GetVariableTypeForInt(builder, type), m_Variables[variableName]);
-        } else if (auto * funcCallExpr = dynamic_cast<FunctionCallExpression *>(variableExpr)) {
-            auto * funcDef = m_FunctionsDefinitions[funcCallExpr->GetFunctionName()];
-            return builder->CreateLoad(GetTypeFromDataType(builder, funcDef->GetReturnType()), m_Variables[variableName]);
-        } else if (auto * structConstrExpr = dynamic_cast<StructConstructionExpression *>(variableExpr)) {
-            auto * structType = m_Structs[structConstrExpr->GetStructName()];
+            return builder->CreateLoad(GetVariableTypeForInt(builder, type), m_Variables.Get(variable));
+        } else if (auto * funcCallExpr = DynCast<FunctionCallExpression>(variableExpr)) {
+            auto * funcDef = GetFunctionDefinition(funcCallExpr->GetFunction());
+            return builder->CreateLoad(GetTypeFromDataType(builder, funcDef->GetReturnType()), m_Variables.Get(variable));
+        } else if (auto * structConstrExpr = DynCast<StructConstructionExpression>(variableExpr)) {
+            auto * structType = GetStruct(structConstrExpr->GetStruct());
             llvm::Type * structPointerType = llvm::PointerType::get(structType, 0);
 
-            return builder->CreateLoad(structPointerType, m_Variables[variableName]);
-        } else if (auto * listExpr = dynamic_cast<ListExpression *>(variableExpr)) {
-            // todo: adapt for non string lists
-            llvm::Type * stringListType = llvm::PointerType::get(builder->getInt8PtrTy(), 0);
+            return builder->CreateLoad(structPointerType, m_Variables.Get(variable));
+        } else if (DynCast<ListExpression>(variableExpr)) {
+            llvm::Type * listPointerType = llvm::PointerType::get(m_Structs.Get(m_ListSymbol), 0);
 
-            return builder->CreateLoad(stringListType, m_Variables[variableName]);
+            return builder->CreateLoad(listPointerType, m_Variables.Get(variable));
         } else {
             COMPILER_ERROR("Unsupported expressions for variable values found: {0}", variableExpr->GetClassName());
             exit(1);
@@ -841,9 +939,9 @@ namespace Hunter::Compiler {
             params.push_back(GetValueFromExpression(builder, condition->Left()));
             params.push_back(GetValueFromExpression(builder, condition->Right()));
 
-            llvm::Value * compareResult = builder->CreateCall(GetCLibraryFunction("strcmp"), llvm::ArrayRef(params));
+            llvm::Value * compareResult = builder->CreateCall(GetRuntimeFunction("hunter_rt_string_equals"), llvm::ArrayRef(params));
 
-            return builder->CreateICmpEQ(
+            return builder->CreateICmpNE(
                     compareResult,
                     builder->getInt32(0)
             );
@@ -854,80 +952,56 @@ namespace Hunter::Compiler {
         }
     }
 
-    llvm::Function *CodeGenerator::GetCLibraryFunction(const std::string &functionName) {
-
-        if (m_Functions.contains(functionName)) {
-            return m_Functions[functionName];
+    llvm::Function *CodeGenerator::GetRuntimeFunction(const std::string &functionName) {
+
+        Symbol function = m_Symbols.Intern(functionName);
+
+        if (m_RuntimeFunctions.Contains(function)) {
+            return m_RuntimeFunctions.Get(function);
+        }
+
+        // the prototypes of Compiler/runtime/hunter_rt.h
+        llvm::Type *voidType = llvm::Type::getVoidTy(m_Context);
+        llvm::Type *listPointerType = llvm::PointerType::get(m_Structs.Get(m_ListSymbol), 0);
+        llvm::FunctionType *functionType;
+
+        if (functionName == "hunter_rt_alloc") {
+            functionType = llvm::FunctionType::get(llvm::Type::getInt8PtrTy(m_Context), {llvm::Type::getInt64Ty(m_Context)}, false);
+        } else if (functionName == "hunter_rt_string_equals") {
+            functionType = llvm::FunctionType::get(llvm::Type::getInt32Ty(m_Context), {llvm::Type::getInt8PtrTy(m_Context), llvm::Type::getInt8PtrTy(m_Context)}, false);
+        } else if (functionName == "hunter_rt_list_new") {
+            functionType = llvm::FunctionType::get(listPointerType, {llvm::Type::getInt64Ty(m_Context), llvm::Type::getInt64Ty(m_Context)}, false);
+        } else if (functionName == "hunter_rt_write") {
+            functionType = llvm::FunctionType::get(voidType, {llvm::Type::getInt8PtrTy(m_Context), llvm::Type::getInt64Ty(m_Context)}, false);
+        } else if (functionName == "hunter_rt_write_string") {
+            functionType = llvm::FunctionType::get(voidType, {llvm::Type::getInt8PtrTy(m_Context)}, false);
+        } else if (functionName == "hunter_rt_write_i32") {
+            functionType = llvm::FunctionType::get(voidType, {llvm::Type::getInt32Ty(m_Context)}, false);
+        } else if (functionName == "hunter_rt_write_i64") {
+            functionType = llvm::FunctionType::get(voidType, {llvm::Type::getInt64Ty(m_Context)}, false);
+        } else {
+            COMPILER_ERROR("No runtime function with the name \"{0}\" exists", functionName);
+            exit(1);
         }
 
-        if (functionName == "printf") {
-
-            auto *printfFuncType = llvm::FunctionType::get(
-                    llvm::Type::getInt32Ty(m_Context),
-                    std::vector<llvm::Type *>({llvm::Type::getInt8PtrTy(m_Context)}),
-                    true
-            );
-
-            llvm::Function *printfFunc = llvm::Function::Create(
-                    printfFuncType,
-                    llvm::Function::ExternalLinkage,
-                    "printf",
-                    m_Module
-            );
-
-            m_Functions["printf"] = printfFunc;
-            return printfFunc;
-        } else if (functionName == "strcmp") {
-            /////// int strcmp(const char *__s1, const char *__s2) {}
-            auto *strcmpFuncType = llvm::FunctionType::get(
-                llvm::Type::getInt32Ty(m_Context),
-                std::vector<llvm::Type *>({
-                  llvm::Type::getInt8PtrTy(m_Context),
-                  llvm::Type::getInt8PtrTy(m_Context)
-                }),
-                false
-            );
-
-            llvm::Function *strcmpFunc = llvm::Function::Create(
-                strcmpFuncType,
+        llvm::Function *runtimeFunc = llvm::Function::Create(
+                functionType,
                 llvm::Function::ExternalLinkage,
-                "strcmp",
+                functionName,
                 m_Module
-            );
-
-            m_Functions["strcmp"] = strcmpFunc;
-            return strcmpFunc;
-        } else if (functionName == "malloc") {
-            /////// void * malloc(size: size_t)
-            auto *mallocFuncType = llvm::FunctionType::get(
-                llvm::PointerType::get(llvm::Type::getVoidTy(m_Context), 0),
-                std::vector<llvm::Type *>({
-                  llvm::Type::getInt64Ty(m_Context),
-                }),
-                false
-            );
-
-            llvm::Function *mallocFunc = llvm::Function::Create(
-                    mallocFuncType,
-                    llvm::Function::ExternalLinkage,
-                    "malloc",
-                    m_Module
-            );
-
-            m_Functions["malloc"] = mallocFunc;
-            return mallocFunc;
-        }
+        );
+        runtimeFunc->addFnAttr(llvm::Attribute::NoUnwind);
 
-        COMPILER_ERROR("No standard function with the name \"{0}\" exists", functionName);
-        exit(1);
+        m_RuntimeFunctions.Set(function, runtimeFunc);
+        return runtimeFunc;
     }
 
     bool CodeGenerator::IsString(Expression * expr) {
-        if (dynamic_cast<StringExpression *>(expr)) {
+        if (DynCast<StringExpression>(expr)) {
             return true;
         }
-        if (auto * identifierExpr = dynamic_cast<IdentifierExpression *>(expr)) {
-            return dynamic_cast<StringExpression *>(m_VariablesExpression[identifierExpr->GetVariableName()]);
+        if (auto * identifierExpr = DynCast<IdentifierExpression>(expr)) {
+            return DynCast<StringExpression>(m_VariablesExpression.Get(identifierExpr->GetVariable()));
         }
         else {
             return false;
@@ -935,11 +1009,11 @@ namespace Hunter::Compiler {
     }
 
     bool CodeGenerator::IsInt(Expression *expr) {
-        if (dynamic_cast<IntExpression *>(expr)) {
+        if (DynCast<IntExpression>(expr)) {
             return true;
         }
-        if (auto * identifierExpr = dynamic_cast<IdentifierExpression *>(expr)) {
-            return dynamic_cast<IntExpression *>(m_VariablesExpression[identifierExpr->GetVariableName()]);
+        if (auto * identifierExpr = DynCast<IdentifierExpression>(expr)) {
+            return DynCast<IntExpression>(m_VariablesExpression.Get(identifierExpr->GetVariable()));
         }
         else {
             return false;
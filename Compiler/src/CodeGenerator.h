@@ -1,11 +1,15 @@
 #pragma once
 
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/IRBuilder.h>
+#include <memory>
 #include <string>
-#include <unordered_map>
 
+#include "ConstantPool.h"
 #include "DebugGenerator.h"
+#include "ExpressionVisitor.h"
+#include "SymbolTable.h"
 
 namespace llvm {
     class BasicBlock;
@@ -30,20 +34,47 @@ namespace Hunter::Compiler {
     class FunctionReturnExpression;
     class IntExpression;
     class AbstractSyntaxTree;
+    struct CompilationUnit;
 
     class BuiltinFeatureGenerator;
 
-    class CodeGenerator {
+    /**
+     * Functions and structs of all units of a program. A unit which uses something
+     * of another unit declares it from here, as every unit has its own LLVM context.
+     */
+    class ProgramDeclarations {
+    public:
+        void AddUnit(const CompilationUnit & unit);
+
+        FunctionExpression * GetFunction(Symbol function) const { return m_Functions.Get(function); }
+        StructExpression * GetStruct(Symbol structSymbol) const { return m_Structs.Get(structSymbol); }
+
+        // the unit which defines the function, nullptr if it does not exist
+        const CompilationUnit * GetFunctionUnit(Symbol function) const { return m_FunctionUnits.Get(function); }
+
+    private:
+        SymbolMap<FunctionExpression> m_Functions;
+        SymbolMap<StructExpression> m_Structs;
+        SymbolMap<const CompilationUnit> m_FunctionUnits;
+    };
+
+    class CodeGenerator : protected ExpressionVisitor<CodeGenerator, void, llvm::IRBuilder<> *> {
     public:
         llvm::Type *GetTypeFromDataType(llvm::IRBuilder<> *builder, DataTypeId dataType);
 
-        CodeGenerator();
+        explicit CodeGenerator(SymbolTable & symbols);
+        // the module is created in a context owned by the caller, so it can be linked with others of the same context
+        CodeGenerator(SymbolTable & symbols, llvm::LLVMContext & context);
 
-        llvm::Module * GenerateCode(AbstractSyntaxTree * ast);
+        // only the main unit gets a main function, the other units may only contain declarations
+        llvm::Module * GenerateCode(const CompilationUnit & unit);
 
         DataTypeId GetVariableDeclarationType(VariableDeclarationExpression * expr);
 
-        void SetDebugOutputFile(const std::string & outputFileName) { m_DebugOutputFileName = outputFileName; }
+        void SetDeclarations(const ProgramDeclarations * declarations) { m_Declarations = declarations; }
+
+        // hands the generated module over together with its context, the generator can not be used anymore afterwards
+        llvm::orc::ThreadSafeModule TakeModule();
 
     protected:
         void InsertExpression(llvm::IRBuilder<> *builder, Expression * expr);
@@ -57,37 +88,69 @@ namespace Hunter::Compiler {
         void InsertVarDeclarationExpression(llvm::IRBuilder<> *builder, VariableDeclarationExpression *constExpr);
         void InsertVarMutationExpression(llvm::IRBuilder<> *builder, VariableMutationExpression *varMutExpr);
         void InsertFuncReturnExpression(llvm::IRBuilder<> *builder, FunctionReturnExpression * retExpr);
-        llvm::AllocaInst * InsertIntExpression(llvm::IRBuilder<> *builder, const std::string & variableName, IntExpression *intExpr);
+        llvm::AllocaInst * InsertIntExpression(llvm::IRBuilder<> *builder, Symbol variable, IntExpression *intExpr);
 
         llvm::Value * GetValueFromExpression(llvm::IRBuilder<> *builder, Expression * expr);
-        llvm::Value * GetVariableValue(llvm::IRBuilder<> *builder, const std::string & variableName);
+        llvm::Value * GetVariableValue(llvm::IRBuilder<> *builder, Symbol variable);
         llvm::Value * GetConditionFromExpression(llvm::IRBuilder<> *builder, BooleanExpression * condition);
         llvm::Value * GetEqualsCondition(llvm::IRBuilder<> *builder, BooleanExpression * condition);
 
-        llvm::Function * GetCLibraryFunction(const std::string & functionName);
+        // functions of the Hunter runtime, which is linked into every program
+        llvm::Function * GetRuntimeFunction(const std::string & functionName);
+
+        llvm::Function * DeclareFunction(llvm::IRBuilder<> *builder, FunctionExpression *funcExpr, llvm::GlobalValue::LinkageTypes linkage);
+
+        // functions and structs of other units are declared in this module on first use
+        llvm::Function * GetFunction(Symbol function);
+        FunctionExpression * GetFunctionDefinition(Symbol function);
+        llvm::StructType * GetStruct(Symbol structSymbol);
+        StructExpression * GetStructDefinition(Symbol structSymbol);
 
         bool IsString(Expression * expr);
         bool IsInt(Expression * expr);
 
-    private:
-        std::string m_DebugOutputFileName;
+        // statements which can show up in a block, everything else ends up in VisitExpression
+        void VisitExpression(Expression * expr, llvm::IRBuilder<> *builder);
+        void VisitPrint(PrintExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitVariableDeclaration(VariableDeclarationExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitVariableMutation(VariableMutationExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitIf(IfExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitForLoop(ForLoopExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitWhile(WhileExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitFunctionCall(FunctionCallExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitFunctionReturn(FunctionReturnExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitStruct(StructExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitExtern(ExternExpression * expr, llvm::IRBuilder<> *builder);
+        void VisitModule(ModuleExpression * expr, llvm::IRBuilder<> *builder);
 
+    private:
         Debug::DebugGenerator * m_DebugGenerator = nullptr;
+        std::unique_ptr<ConstantPool> m_ConstantPool;
 
         BuiltinFeatureGenerator * m_BuiltinGenerator;
 
         // make sure it lives as long as the module is used
         llvm::Module * m_Module;
-        llvm::LLVMContext m_Context;
-
-        std::unordered_map<std::string, llvm::StructType *> m_Structs;
-        std::unordered_map<std::string, StructExpression *> m_StructsDefinitions;
-        std::unordered_map<std::string, llvm::Function *> m_Functions;
-        std::unordered_map<std::string, FunctionExpression *> m_FunctionsDefinitions;
-        std::unordered_map<std::string, llvm::Value *> m_Variables;
-        std::unordered_map<std::string, Expression *> m_VariablesExpression;
+        std::unique_ptr<llvm::LLVMContext> m_ContextOwner = std::make_unique<llvm::LLVMContext>();
+        llvm::LLVMContext & m_Context = *m_ContextOwner;
+
+        SymbolTable & m_Symbols;
+        const CompilationUnit * m_Unit = nullptr;
+        const ProgramDeclarations * m_Declarations = nullptr;
+        // name of the builtin list struct
+        Symbol m_ListSymbol;
+
+        SymbolMap<llvm::StructType> m_Structs;
+        SymbolMap<StructExpression> m_StructsDefinitions;
+        SymbolMap<llvm::Function> m_Functions;
+        // kept apart from the functions of the program, so a call in Hunter code can never resolve to one of them
+        SymbolMap<llvm::Function> m_RuntimeFunctions;
+        SymbolMap<FunctionExpression> m_FunctionsDefinitions;
+        SymbolMap<llvm::Value> m_Variables;
+        SymbolMap<Expression> m_VariablesExpression;
 
         friend class BuiltinFeatureGenerator;
+        friend class ExpressionVisitor<CodeGenerator, void, llvm::IRBuilder<> *>;
     };
 }
 
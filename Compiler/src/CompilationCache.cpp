@@ -0,0 +1,283 @@
+#include "CompilationCache.h"
+#include "Compiler.h"
+#include "ImportResolver.h"
+#include "SourceManager.h"
+#include "./utils/logger.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_set>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/SHA1.h>
+
+#ifndef HUNTER_COMPILER_VERSION
+#define HUNTER_COMPILER_VERSION "unknown"
+#endif
+
+namespace Hunter::Compiler {
+
+    // has to be increased whenever the layout of an entry changes
+    constexpr const char * CacheFormatVersion = "4";
+
+    // the IR is kept as text, the bitcode of the code generator can not always be read back
+    constexpr const char * ModuleTextFileName = "module.ll";
+
+    // the paths the files of an entry were written to, one per line. the files are stored under their line number
+    constexpr const char * OutputListFileName = "outputs";
+
+    static void AddField(llvm::SHA1 & hasher, std::string_view field) {
+        // the separator keeps neighbouring fields from being shifted into each other
+        hasher.update(llvm::StringRef(field.data(), field.size()));
+        hasher.update(llvm::StringRef("\0", 1));
+    }
+
+    /**
+     * The version only changes with releases, every build of the compiler in between generates
+     * different code. Hashing the whole executable would cost more than most cache hits save,
+     * a rebuilt compiler always has another modification time.
+     */
+    static const std::string & GetCompilerBuild() {
+        static std::string s_Build;
+        static std::once_flag buildDetermined;
+
+        std::call_once(buildDetermined, []() {
+            s_Build = HUNTER_COMPILER_VERSION;
+            std::string executable = llvm::sys::fs::getMainExecutable(nullptr, nullptr);
+            llvm::sys::fs::file_status status;
+
+            if (executable.empty() || llvm::sys::fs::status(executable, status)) {
+                COMPILER_WARN("Could not identify the compiler executable, cached files of other builds of {0} are used", HUNTER_COMPILER_VERSION);
+                return;
+            }
+
+            s_Build += "\n" + executable
+                + "\n" + std::to_string(status.getSize())
+                + "\n" + std::to_string(status.getLastModificationTime().time_since_epoch().count());
+        });
+
+        return s_Build;
+    }
+
+    // files which do not exist get an empty hash, the compilation reports them if it needs them
+    static std::string HashFile(const std::string & filePath) {
+        if (filePath.empty()) {
+            return {};
+        }
+
+        auto contents = llvm::MemoryBuffer::getFile(filePath);
+
+        if (!contents) {
+            return {};
+        }
+
+        llvm::SHA1 hasher;
+        hasher.update((*contents)->getBuffer());
+
+        return llvm::toHex(hasher.final(), true);
+    }
+
+    CompilationCache::CompilationCache(std::string directory) : m_Directory(std::move(directory)) {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(m_Directory) / "ast", error);
+
+        if (error) {
+            COMPILER_ERROR("Could not create the cache directory - '{0}': {1}", m_Directory, error.message());
+            exit(1);
+        }
+    }
+
+    std::string CompilationCache::ComputeKey(SourceManager &sourceManager, const std::string &filePath, const TargetSettings &target, std::string_view outputs) {
+        llvm::SHA1 hasher;
+        AddField(hasher, CacheFormatVersion);
+        AddField(hasher, outputs);
+        AddField(hasher, GetCompilerBuild());
+        AddField(hasher, LLVM_VERSION_STRING);
+        AddField(hasher, target.Triple);
+        AddField(hasher, target.CPU);
+        AddField(hasher, target.Features);
+        AddField(hasher, GetOptimizationLevelString(target.Optimization));
+        AddField(hasher, target.LinkTimeOptimization ? "lto" : "");
+
+        for (const auto &bitcodeFile : target.LinkTimeInputs) {
+            std::string_view bitcode = sourceManager.LoadFile(bitcodeFile);
+            llvm::SHA1 bitcodeHasher;
+            bitcodeHasher.update(llvm::StringRef(bitcode.data(), bitcode.size()));
+
+            AddField(hasher, bitcodeFile);
+            AddField(hasher, llvm::toHex(bitcodeHasher.final(), true));
+        }
+
+        // the runtime is linked into the executables and its bitcode inlined into the optimized modules
+        for (const auto &runtimeFile : {GetRuntimeLibraryFile(), GetRuntimeBitcodeFile()}) {
+            AddField(hasher, runtimeFile);
+            AddField(hasher, HashFile(runtimeFile));
+        }
+
+        // instrumented programs can be linked by another driver, together with the profile runtime
+        if (llvm::Expected<ExecutableLinker> linker = FindExecutableLinker(target)) {
+            AddField(hasher, linker->Driver);
+
+            for (const auto &argument : linker->ProfileArguments) {
+                AddField(hasher, argument);
+            }
+        } else {
+            llvm::consumeError(linker.takeError());
+            AddField(hasher, "");
+        }
+
+        // the file name of the raw profile ends up in the instrumented object
+        AddField(hasher, target.ProfileGenerate);
+        AddField(hasher, target.ProfileUse);
+
+        if (!target.ProfileUse.empty()) {
+            std::string_view profile = sourceManager.LoadFile(target.ProfileUse);
+            llvm::SHA1 profileHasher;
+            profileHasher.update(llvm::StringRef(profile.data(), profile.size()));
+
+            AddField(hasher, llvm::toHex(profileHasher.final(), true));
+        }
+
+        // the debug information contains the paths, so they are part of the key as well
+        std::string basePath = std::filesystem::path(filePath).parent_path();
+        std::vector<std::pair<std::string, std::string>> pendingFiles = {{"", std::filesystem::absolute(filePath)}};
+        std::unordered_set<std::string> seenModules;
+
+        // the same depth first order as the import resolver, every module is hashed once
+        while (!pendingFiles.empty()) {
+            auto [module, path] = std::move(pendingFiles.back());
+            pendingFiles.pop_back();
+
+            std::string_view source = sourceManager.LoadFile(path);
+            llvm::SHA1 sourceHasher;
+            sourceHasher.update(llvm::StringRef(source.data(), source.size()));
+
+            AddField(hasher, module);
+            AddField(hasher, path);
+            AddField(hasher, llvm::toHex(sourceHasher.final(), true));
+
+            auto imports = ImportResolver::FindImportedModules(source);
+
+            for (auto it = imports.rbegin(); it != imports.rend(); ++it) {
+                std::string importedModule(*it);
+
+                if (seenModules.insert(importedModule).second) {
+                    std::string modulePath = std::filesystem::absolute(ImportResolver::GetModuleFilePath(basePath, importedModule));
+                    pendingFiles.emplace_back(std::move(importedModule), std::move(modulePath));
+                }
+            }
+        }
+
+        return llvm::toHex(hasher.final(), true);
+    }
+
+    bool CompilationCache::Restore(const std::string &key, const std::string &irOutputFile, std::vector<std::string> &restoredFiles) {
+        std::filesystem::path entryPath = std::filesystem::path(m_Directory) / key;
+        std::error_code error;
+
+        if (!std::filesystem::is_directory(entryPath, error)) {
+            return false;
+        }
+
+        // which bitcode files exist depends on the modules, so the entry is restored as a whole
+        std::ifstream outputList(entryPath / OutputListFileName);
+        std::string filePath;
+
+        for (size_t index = 0; std::getline(outputList, filePath); ++index) {
+            std::filesystem::copy_file(entryPath / std::to_string(index), filePath, std::filesystem::copy_options::overwrite_existing, error);
+
+            if (error) {
+                COMPILER_WARN("Could not restore '{0}' from the cache: {1}", filePath, error.message());
+                return false;
+            }
+
+            restoredFiles.push_back(filePath);
+        }
+
+        if (irOutputFile == "-") {
+            std::ifstream moduleText(entryPath / ModuleTextFileName);
+            llvm::outs() << std::string(std::istreambuf_iterator<char>(moduleText), {});
+        } else if (!irOutputFile.empty()) {
+            std::filesystem::copy_file(entryPath / ModuleTextFileName, irOutputFile, std::filesystem::copy_options::overwrite_existing, error);
+
+            if (error) {
+                COMPILER_WARN("Could not restore '{0}' from the cache: {1}", irOutputFile, error.message());
+                return false;
+            }
+        }
+
+        COMPILER_INFO("Restored compilation from cache entry {0}", key);
+
+        return true;
+    }
+
+    void CompilationCache::Store(const std::string &key, const std::vector<std::string> &filePaths, std::string_view moduleText) {
+        std::filesystem::path entryPath = std::filesystem::path(m_Directory) / key;
+        std::error_code error;
+
+        if (std::filesystem::is_directory(entryPath, error)) {
+            return;
+        }
+
+        // the entry is filled under a private name and renamed in one step,
+        // so other builds using the same cache never see a half written entry
+        std::filesystem::path temporaryPath = entryPath;
+        temporaryPath += ".tmp-" + std::to_string(llvm::sys::Process::getProcessId());
+        std::filesystem::create_directory(temporaryPath, error);
+
+        if (!error) {
+            llvm::raw_fd_ostream moduleTextStream((temporaryPath / ModuleTextFileName).string(), error);
+            moduleTextStream << moduleText;
+        }
+
+        if (!error) {
+            llvm::raw_fd_ostream outputListStream((temporaryPath / OutputListFileName).string(), error);
+
+            for (const auto &filePath : filePaths) {
+                outputListStream << filePath << "\n";
+            }
+        }
+
+        for (size_t index = 0; index < filePaths.size() && !error; ++index) {
+            std::filesystem::copy_file(filePaths[index], temporaryPath / std::to_string(index), std::filesystem::copy_options::overwrite_existing, error);
+        }
+
+        if (!error) {
+            std::filesystem::rename(temporaryPath, entryPath, error);
+        }
+
+        if (error) {
+            // another build storing the same entry first is fine, everything else is only worth a warning
+            if (!std::filesystem::is_directory(entryPath)) {
+                COMPILER_WARN("Could not store cache entry {0}: {1}", key, error.message());
+            }
+
+            std::filesystem::remove_all(temporaryPath, error);
+            return;
+        }
+
+        COMPILER_INFO("Stored compilation in cache entry {0}", key);
+    }
+
+    std::string CompilationCache::GetTreeFilePath(const std::string &filePath, std::string_view source) {
+        llvm::SHA1 hasher;
+        AddField(hasher, GetCompilerBuild());
+        // the path ends up in the debug data of the tree
+        AddField(hasher, filePath);
+        AddField(hasher, source);
+
+        return (std::filesystem::path(m_Directory) / "ast" / llvm::toHex(hasher.final(), true)).string() + ".hast";
+    }
+
+    bool CompilationCache::EvictTree(const std::string &treeFilePath) {
+        std::error_code error;
+        return std::filesystem::remove(treeFilePath, error);
+    }
+
+}
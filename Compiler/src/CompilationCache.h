@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Hunter::Compiler {
+
+    class SourceManager;
+    struct TargetSettings;
+
+    /**
+     * On disk cache for the files a compilation produces. An entry is addressed by a hash
+     * of the compiler build, the target settings and the contents of the main file and
+     * all modules it imports, so it can be shared between several builds on one machine.
+     */
+    class CompilationCache {
+    public:
+        explicit CompilationCache(std::string directory);
+
+        // only reads the sources and their import lines, nothing gets parsed. outputs names the requested files
+        std::string ComputeKey(SourceManager & sourceManager, const std::string & filePath, const TargetSettings & target, std::string_view outputs);
+
+        /**
+         * Copies all cached files back to where they were written from and writes the cached IR like the compiler does,
+         * to the given file or to stdout for "-", not at all without a file. Returns false if the entry does not exist.
+         */
+        bool Restore(const std::string & key, const std::string & irOutputFile, std::vector<std::string> & restoredFiles);
+        void Store(const std::string & key, const std::vector<std::string> & filePaths, std::string_view moduleText);
+
+        // where the serialized syntax tree of a single source is kept, see AstWriter
+        std::string GetTreeFilePath(const std::string & filePath, std::string_view source);
+        // for trees which could not be loaded, returns false if there was no such tree
+        bool EvictTree(const std::string & treeFilePath);
+
+    private:
+        std::string m_Directory;
+    };
+
+}
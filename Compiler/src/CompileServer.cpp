@@ -0,0 +1,271 @@
+#include "CompileServer.h"
+#include "Compiler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char ** environ;
+
+namespace Hunter::Compiler {
+
+    // a client which does not send its request in time would block all others
+    constexpr int RequestTimeoutSeconds = 5;
+
+    static volatile sig_atomic_t s_IsStopping = 0;
+
+    CompileServer::CompileServer(std::string socketPath, CompileFunction compile)
+        : m_SocketPath(std::move(socketPath)),
+          m_Compile(std::move(compile)),
+          m_MaximumCompilations(std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+    CompileServer::~CompileServer() {
+        if (m_Socket != -1) {
+            close(m_Socket);
+            unlink(m_SocketPath.c_str());
+        }
+    }
+
+    int CompileServer::Run() {
+        // everything a compilation would set up first, the forked children get it for free
+        if (!CreateTargetMachine(TargetSettings())) {
+            return 1;
+        }
+
+        if (!Listen()) {
+            return 1;
+        }
+
+        // without SA_RESTART, so poll returns right away
+        struct sigaction stopAction{};
+        stopAction.sa_handler = [](int) {
+            s_IsStopping = 1;
+        };
+        sigaction(SIGINT, &stopAction, nullptr);
+        sigaction(SIGTERM, &stopAction, nullptr);
+
+        // a client which went away must not end the server
+        signal(SIGPIPE, SIG_IGN);
+
+        std::cout << "Listening on " << m_SocketPath << std::endl;
+
+        std::vector<pollfd> pollDescriptors;
+
+        // running compilations are still finished after a signal, their clients wait for the exit code
+        while (!s_IsStopping || !m_Compilations.empty()) {
+            pollDescriptors.clear();
+
+            for (const auto &compilation : m_Compilations) {
+                pollDescriptors.push_back({compilation.ReportFileDescriptor, POLLIN, 0});
+            }
+
+            // new requests wait in the backlog of the socket while all compilations are busy
+            bool acceptsRequests = !s_IsStopping && m_Compilations.size() < m_MaximumCompilations;
+
+            if (acceptsRequests) {
+                pollDescriptors.push_back({m_Socket, POLLIN, 0});
+            }
+
+            if (poll(pollDescriptors.data(), pollDescriptors.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                std::cerr << "Waiting for requests failed: " << strerror(errno) << std::endl;
+                return 1;
+            }
+
+            bool hasRequest = acceptsRequests && (pollDescriptors.back().revents & POLLIN);
+
+            // from back to front, so the indices of the remaining ones stay the same
+            for (size_t i = m_Compilations.size(); i-- > 0;) {
+                if (!pollDescriptors[i].revents) {
+                    continue;
+                }
+
+                auto &compilation = m_Compilations[i];
+                char buffer[64 * 1024];
+                ssize_t size = read(compilation.ReportFileDescriptor, buffer, sizeof(buffer));
+
+                if (size > 0) {
+                    compilation.Reports.append(buffer, static_cast<size_t>(size));
+                } else if (size == 0 || errno != EINTR) {
+                    // the pipe is only closed once the process is gone
+                    FinishCompilation(compilation);
+                    m_Compilations.erase(m_Compilations.begin() + static_cast<ptrdiff_t>(i));
+                }
+            }
+
+            if (hasRequest) {
+                int connection = accept(m_Socket, nullptr, nullptr);
+
+                if (connection != -1) {
+                    StartCompilation(connection);
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    bool CompileServer::Listen() {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+
+        if (m_SocketPath.size() >= sizeof(address.sun_path)) {
+            std::cerr << "The socket path " << m_SocketPath << " is too long" << std::endl;
+            return false;
+        }
+
+        std::strncpy(address.sun_path, m_SocketPath.c_str(), sizeof(address.sun_path) - 1);
+
+        // a socket file nobody listens on anymore is left over from a server which was killed
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool isRunning = connect(probe, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+        close(probe);
+
+        if (isRunning) {
+            std::cerr << "Another compile server is already listening on " << m_SocketPath << std::endl;
+            return false;
+        }
+
+        unlink(m_SocketPath.c_str());
+        int listeningSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        // only the user who started the server may send it requests
+        mode_t previousMask = umask(0077);
+        bool isBound = bind(listeningSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+        umask(previousMask);
+
+        if (!isBound || listen(listeningSocket, SOMAXCONN) != 0) {
+            std::cerr << "Could not listen on " << m_SocketPath << ": " << strerror(errno) << std::endl;
+            close(listeningSocket);
+            return false;
+        }
+
+        m_Socket = listeningSocket;
+        return true;
+    }
+
+    void CompileServer::StartCompilation(int connection) {
+        timeval timeout{RequestTimeoutSeconds, 0};
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        CompileRequest request;
+
+        if (!ReceiveRequest(connection, request)) {
+            close(connection);
+            return;
+        }
+
+        int reportPipe[2] = {-1, -1};
+        pid_t process = -1;
+
+        if (pipe(reportPipe) == 0) {
+            // the server keeps no buffered output, which the child would write a second time
+            std::cout.flush();
+            process = fork();
+
+            if (process == 0) {
+                close(reportPipe[0]);
+                close(connection);
+                RunCompilation(request, reportPipe[1]);
+            }
+        }
+
+        int error = errno;
+        close(reportPipe[1]);
+
+        // the child has its own copies
+        for (int fileDescriptor : request.FileDescriptors) {
+            close(fileDescriptor);
+        }
+
+        if (process == -1) {
+            std::cerr << "Could not start a compilation: " << strerror(error) << std::endl;
+            close(reportPipe[0]);
+            SendExitCode(connection, 1);
+            close(connection);
+            return;
+        }
+
+        m_Compilations.push_back({process, connection, reportPipe[0], {}});
+    }
+
+    void CompileServer::RunCompilation(CompileRequest & request, int reportFileDescriptor) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGPIPE, SIG_DFL);
+
+        // only the server needs these
+        close(m_Socket);
+
+        for (const auto &compilation : m_Compilations) {
+            close(compilation.Connection);
+            close(compilation.ReportFileDescriptor);
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            dup2(request.FileDescriptors[i], i);
+        }
+
+        for (int fileDescriptor : request.FileDescriptors) {
+            if (fileDescriptor > 2) {
+                close(fileDescriptor);
+            }
+        }
+
+        if (chdir(request.WorkingDirectory.c_str()) != 0) {
+            std::cerr << "Could not change into the directory " << request.WorkingDirectory << std::endl;
+            _exit(1);
+        }
+
+        // exit does not unwind, so the strings stay alive until the end of the process
+        std::vector<char *> environment;
+
+        for (auto &variable : request.Environment) {
+            environment.push_back(variable.data());
+        }
+
+        environment.push_back(nullptr);
+        environ = environment.data();
+
+        std::vector<const char *> arguments;
+
+        for (const auto &argument : request.Arguments) {
+            arguments.push_back(argument.c_str());
+        }
+
+        m_TreeCache.SetReportFileDescriptor(reportFileDescriptor);
+        int exitCode = m_Compile(static_cast<int>(arguments.size()), arguments.data(), &m_TreeCache);
+
+        // like returning from main, so the buffered output is written and the logger is shut down
+        exit(exitCode);
+    }
+
+    void CompileServer::FinishCompilation(RunningCompilation & compilation) {
+        close(compilation.ReportFileDescriptor);
+
+        int status = 0;
+
+        while (waitpid(compilation.Process, &status, 0) == -1 && errno == EINTR) {
+        }
+
+        m_TreeCache.AddReports(compilation.Reports);
+
+        // a crashed compilation looks like it does in a shell
+        SendExitCode(compilation.Connection, WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status));
+        close(compilation.Connection);
+    }
+
+}
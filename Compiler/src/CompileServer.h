@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ModuleTreeCache.h"
+#include "ServerProtocol.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace Hunter::Compiler {
+
+    /**
+     * Keeps everything which does not depend on a single program ready between compilations:
+     * the initialized LLVM targets and the syntax trees of imported modules. Every request of
+     * Hunter_Client is compiled in a child process forked from the server, which starts with all
+     * of it already in memory and writes directly into the stdout and stderr of the client.
+     * A compilation which exits because of an error only ends its own process.
+     */
+    class CompileServer {
+    public:
+        // runs in the child process with the arguments of the client, returns the exit code
+        using CompileFunction = std::function<int(int argc, const char ** argv, ModuleTreeCache * treeCache)>;
+
+        CompileServer(std::string socketPath, CompileFunction compile);
+        CompileServer(const CompileServer &) = delete;
+        CompileServer & operator=(const CompileServer &) = delete;
+        ~CompileServer();
+
+        // serves requests until the server gets SIGINT or SIGTERM, returns the exit code of the server
+        int Run();
+
+    protected:
+        bool Listen();
+        void StartCompilation(int connection);
+        [[noreturn]] void RunCompilation(CompileRequest & request, int reportFileDescriptor);
+
+    private:
+        struct RunningCompilation {
+            pid_t Process;
+            int Connection;
+            // the trees the compilation parsed, see ModuleTreeCache
+            int ReportFileDescriptor;
+            std::string Reports;
+        };
+
+        void FinishCompilation(RunningCompilation & compilation);
+
+        std::string m_SocketPath;
+        CompileFunction m_Compile;
+        int m_Socket = -1;
+
+        ModuleTreeCache m_TreeCache;
+        std::vector<RunningCompilation> m_Compilations;
+        size_t m_MaximumCompilations;
+    };
+
+}
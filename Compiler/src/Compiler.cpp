@@ -1,18 +1,217 @@
 #include "Compiler.h"
+#include "ThreadPool.h"
+#include "./utils/logger.h"
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/DebugInfo.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/MC/MCSubtargetInfo.h>
+#include <llvm/Support/FileUtilities.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 
 
 namespace Hunter::Compiler {
 
-    void CompileModule(llvm::Module * module) {
+#if LLVM_VERSION_MAJOR >= 14
+    using PipelineLevel = llvm::OptimizationLevel;
+#else
+    using PipelineLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
+
+    bool ParseOptimizationLevel(std::string_view flag, OptimizationLevel & level) {
+        for (auto candidate : {OptimizationLevel::O0, OptimizationLevel::O1, OptimizationLevel::O2, OptimizationLevel::O3, OptimizationLevel::Os}) {
+            if (flag == GetOptimizationLevelString(candidate)) {
+                level = candidate;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    const char * GetOptimizationLevelString(OptimizationLevel level) {
+        switch (level) {
+            case OptimizationLevel::O0:
+                return "-O0";
+            case OptimizationLevel::O1:
+                return "-O1";
+            case OptimizationLevel::O2:
+                return "-O2";
+            case OptimizationLevel::O3:
+                return "-O3";
+            case OptimizationLevel::Os:
+                return "-Os";
+        }
+
+        return "";
+    }
+
+    void UseHostCPU(TargetSettings & target) {
+        target.CPU = llvm::sys::getHostCPUName().str();
+        target.Features.clear();
+
+        llvm::StringMap<bool> hostFeatures;
+
+        if (!llvm::sys::getHostCPUFeatures(hostFeatures)) {
+            return;
+        }
+
+        // sorted, so the same machine always gets the same cache key
+        std::vector<std::string> features;
+
+        for (const auto &feature : hostFeatures) {
+            features.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+        }
+
+        std::sort(features.begin(), features.end());
+
+        for (const auto &feature : features) {
+            AddTargetFeatures(target, feature);
+        }
+    }
+
+    void AddTargetFeatures(TargetSettings & target, std::string_view features) {
+        if (features.empty()) {
+            return;
+        }
+
+        if (!target.Features.empty()) {
+            target.Features += ",";
+        }
+
+        target.Features += features;
+    }
+
+    llvm::CodeGenOpt::Level GetCodeGenLevel(OptimizationLevel level) {
+        switch (level) {
+            case OptimizationLevel::O0:
+                return llvm::CodeGenOpt::None;
+            case OptimizationLevel::O1:
+                return llvm::CodeGenOpt::Less;
+            case OptimizationLevel::O3:
+                return llvm::CodeGenOpt::Aggressive;
+            default:
+                return llvm::CodeGenOpt::Default;
+        }
+    }
+
+    static PipelineLevel GetPipelineLevel(OptimizationLevel level) {
+        switch (level) {
+            case OptimizationLevel::O1:
+                return PipelineLevel::O1;
+            case OptimizationLevel::O3:
+                return PipelineLevel::O3;
+            case OptimizationLevel::Os:
+                return PipelineLevel::Os;
+            default:
+                return PipelineLevel::O2;
+        }
+    }
+
+    llvm::Optional<llvm::PGOOptions> GetProfileOptions(const TargetSettings & target) {
+        if (!target.ProfileGenerate.empty()) {
+            return llvm::PGOOptions(target.ProfileGenerate, "", "", llvm::PGOOptions::IRInstr);
+        }
+
+        if (!target.ProfileUse.empty()) {
+            return llvm::PGOOptions(target.ProfileUse, "", "", llvm::PGOOptions::IRUse);
+        }
+
+        return llvm::None;
+    }
+
+    void OptimizeModule(
+        llvm::Module * module,
+        llvm::TargetMachine * targetMachine,
+        OptimizationLevel level,
+        bool linkTime,
+        const llvm::Optional<llvm::PGOOptions> & profile
+    ) {
+        if (level == OptimizationLevel::O0 && !profile) {
+            return;
+        }
+
+        llvm::TimeTraceScope timeScope("Optimize", module->getModuleIdentifier());
+
+        // the passes expect valid IR, which the code generator does not produce for every program yet
+        std::string verifierOutput;
+        llvm::raw_string_ostream verifierStream(verifierOutput);
+        bool brokenDebugInfo = false;
+
+        if (llvm::verifyModule(*module, &verifierStream, &brokenDebugInfo)) {
+            verifierStream.flush();
+            COMPILER_WARN(
+                "Module {0} is not valid, it is compiled without optimizations and profiles: {1}",
+                module->getModuleIdentifier(),
+                verifierOutput.substr(0, verifierOutput.find('\n'))
+            );
+            return;
+        }
+
+        if (brokenDebugInfo) {
+            COMPILER_WARN("Debug information of module {0} is not valid and was removed", module->getModuleIdentifier());
+            llvm::StripDebugInfo(*module);
+        }
+
+        llvm::LoopAnalysisManager loopAnalysis;
+        llvm::FunctionAnalysisManager functionAnalysis;
+        llvm::CGSCCAnalysisManager cgsccAnalysis;
+        llvm::ModuleAnalysisManager moduleAnalysis;
+
+        // the target machine lets the cost models of the vectorizers and the inliner use the real target
+        llvm::PassBuilder passBuilder(targetMachine, llvm::PipelineTuningOptions(), profile);
+        passBuilder.registerModuleAnalyses(moduleAnalysis);
+        passBuilder.registerCGSCCAnalyses(cgsccAnalysis);
+        passBuilder.registerFunctionAnalyses(functionAnalysis);
+        passBuilder.registerLoopAnalyses(loopAnalysis);
+        passBuilder.crossRegisterProxies(loopAnalysis, functionAnalysis, cgsccAnalysis, moduleAnalysis);
+
+        llvm::ModulePassManager passes;
+
+        if (level == OptimizationLevel::O0) {
+            passes = passBuilder.buildO0DefaultPipeline(PipelineLevel::O0);
+        } else if (linkTime) {
+            // the profile is instrumented or applied before linking, the link time pipeline only consumes it
+            if (profile) {
+                passes.addPass(passBuilder.buildLTOPreLinkDefaultPipeline(GetPipelineLevel(level)));
+            }
+
+            passes.addPass(passBuilder.buildLTODefaultPipeline(GetPipelineLevel(level), nullptr));
+        } else {
+            passes = passBuilder.buildPerModuleDefaultPipeline(GetPipelineLevel(level));
+        }
+
+        passes.run(*module, moduleAnalysis);
+    }
+
+    std::unique_ptr<llvm::TargetMachine> CreateTargetMachine(const TargetSettings & target) {
 
-        // Initialize the target registry etc.
-        llvm::InitializeAllTargetInfos();
-        llvm::InitializeAllTargets();
-        llvm::InitializeAllTargetMCs();
-        llvm::InitializeAllAsmPrinters();
+        // Initialize the target registry etc. only once, modules are compiled from several threads
+        static std::once_flag targetsInitialized;
+        std::call_once(targetsInitialized, []() {
+            llvm::InitializeAllTargetInfos();
+            llvm::InitializeAllTargets();
+            llvm::InitializeAllTargetMCs();
+            llvm::InitializeAllAsmPrinters();
+        });
 
-        auto TargetTriple = llvm::sys::getDefaultTargetTriple();
-        module->setTargetTriple(TargetTriple);
+        auto TargetTriple = target.Triple;
 
         std::string Error;
         auto Target = llvm::TargetRegistry::lookupTarget(TargetTriple, Error);
@@ -22,40 +221,540 @@ namespace Hunter::Compiler {
         // TargetRegistry or we have a bogus target triple.
         if (!Target) {
             llvm::errs() << Error;
-            return;
+            return nullptr;
         }
 
-        auto CPU = "generic";
-        auto Features = "";
+        auto CPU = target.CPU;
+        auto Features = target.Features;
+
+        std::unique_ptr<llvm::MCSubtargetInfo> subtargetInfo(Target->createMCSubtargetInfo(TargetTriple, CPU, ""));
+
+        if (!subtargetInfo->isCPUStringValid(CPU)) {
+            COMPILER_ERROR("Unknown CPU {0} for target {1}", CPU, TargetTriple);
+            return nullptr;
+        }
 
         llvm::TargetOptions opt;
         auto RM = llvm::Optional<llvm::Reloc::Model>();
-        auto TheTargetMachine =
-                Target->createTargetMachine(TargetTriple, CPU, Features, opt, RM);
 
-        module->setDataLayout(TheTargetMachine->createDataLayout());
-        auto Filename = "output.o";
-        std::error_code EC;
+        return std::unique_ptr<llvm::TargetMachine>(
+                Target->createTargetMachine(TargetTriple, CPU, Features, opt, RM, llvm::None, GetCodeGenLevel(target.Optimization)));
+    }
+
+    std::string GetRuntimeLibraryFile() {
+        return getenv("HUNTER_RUNTIME_LIBRARY") ? getenv("HUNTER_RUNTIME_LIBRARY") : HUNTER_RUNTIME_LIBRARY;
+    }
+
+    std::string GetRuntimeBitcodeFile() {
+        return getenv("HUNTER_RUNTIME_BITCODE") ? getenv("HUNTER_RUNTIME_BITCODE") : HUNTER_RUNTIME_BITCODE;
+    }
+
+    llvm::ErrorOr<std::string> FindCCompiler() {
+        if (const char * compiler = getenv("CC"); compiler && *compiler) {
+            return llvm::sys::findProgramByName(compiler);
+        }
+
+        for (const char * name : {"cc", "clang", "gcc"}) {
+            if (auto compiler = llvm::sys::findProgramByName(name)) {
+                return compiler;
+            }
+        }
+
+        return std::make_error_code(std::errc::no_such_file_or_directory);
+    }
+
+    std::string GetProfileRuntimeFile() {
+        return getenv("HUNTER_PROFILE_RUNTIME") ? getenv("HUNTER_PROFILE_RUNTIME") : HUNTER_PROFILE_RUNTIME;
+    }
+
+    // cc is clang on some systems, so the driver is asked itself instead of going by its name
+    static bool IsClangDriver(const std::string & driver) {
+        llvm::SmallString<128> versionFile;
+
+        if (llvm::sys::fs::createTemporaryFile("hunter-cc-version", "txt", versionFile)) {
+            return false;
+        }
+
+        llvm::FileRemover versionFileRemover(versionFile);
+        llvm::Optional<llvm::StringRef> redirects[] = {llvm::StringRef(""), llvm::StringRef(versionFile), llvm::StringRef("")};
+
+        if (llvm::sys::ExecuteAndWait(driver, {driver, "--version"}, llvm::None, redirects) != 0) {
+            return false;
+        }
+
+        auto version = llvm::MemoryBuffer::getFile(versionFile);
+        return version && (*version)->getBuffer().contains("clang");
+    }
+
+    llvm::Expected<ExecutableLinker> FindExecutableLinker(const TargetSettings & target) {
+        llvm::ErrorOr<std::string> driver = FindCCompiler();
+
+        if (!driver) {
+            return llvm::make_error<llvm::StringError>("Could not find a C compiler, set CC: " + driver.getError().message(), driver.getError());
+        }
+
+        if (target.ProfileGenerate.empty()) {
+            return ExecutableLinker{*driver, {}};
+        }
+
+        // makes clang link the profile runtime of compiler-rt, which writes the counters on exit
+        if (IsClangDriver(*driver)) {
+            return ExecutableLinker{*driver, {"-fprofile-instr-generate"}};
+        }
+
+        // the runtime of the clang which matches LLVM writes the raw profile format the instrumentation expects
+        for (const std::string & name : {"clang-" + std::to_string(LLVM_VERSION_MAJOR), std::string("clang")}) {
+            if (auto clang = llvm::sys::findProgramByName(name)) {
+                return ExecutableLinker{*clang, {"-fprofile-instr-generate"}};
+            }
+        }
+
+        // other drivers get the runtime as an archive, nothing references the part which registers the writer on exit
+        std::string profileRuntime = GetProfileRuntimeFile();
+
+        if (!profileRuntime.empty() && llvm::sys::fs::exists(profileRuntime)) {
+            return ExecutableLinker{*driver, {profileRuntime, "-u__llvm_profile_runtime"}};
+        }
+
+        return llvm::make_error<llvm::StringError>(
+                "--profile-generate needs clang or the profile runtime of compiler-rt to link with " + *driver
+                        + ", install clang or set HUNTER_PROFILE_RUNTIME to libclang_rt.profile",
+                std::make_error_code(std::errc::no_such_file_or_directory));
+    }
+
+    // read once, every module parses its own copy into its context. empty if the runtime was built without clang
+    static llvm::Optional<llvm::MemoryBufferRef> GetRuntimeBitcode() {
+        static std::unique_ptr<llvm::MemoryBuffer> s_Bitcode;
+        static std::once_flag bitcodeRead;
+
+        std::call_once(bitcodeRead, []() {
+            std::string bitcodeFile = GetRuntimeBitcodeFile();
+
+            if (bitcodeFile.empty()) {
+                return;
+            }
+
+            auto bitcode = llvm::MemoryBuffer::getFile(bitcodeFile);
+
+            if (!bitcode) {
+                COMPILER_WARN("Could not read the runtime bitcode {0}, the runtime is not inlined: {1}", bitcodeFile, bitcode.getError().message());
+                return;
+            }
+
+            s_Bitcode = std::move(*bitcode);
+        });
+
+        if (!s_Bitcode) {
+            return llvm::None;
+        }
+
+        return s_Bitcode->getMemBufferRef();
+    }
+
+    // returns nullptr if there is no bitcode or it was compiled for another target
+    static std::unique_ptr<llvm::Module> LoadRuntime(llvm::LLVMContext & context, const TargetSettings & target) {
+        auto bitcode = GetRuntimeBitcode();
+
+        if (!bitcode) {
+            return nullptr;
+        }
+
+        // the functions are only read once the linker needs them
+        auto runtime = llvm::getLazyBitcodeModule(*bitcode, context);
+
+        if (!runtime) {
+            COMPILER_WARN("Could not read the runtime bitcode: {0}", llvm::toString(runtime.takeError()));
+            return nullptr;
+        }
+
+        llvm::Triple runtimeTriple((*runtime)->getTargetTriple());
+        llvm::Triple targetTriple(target.Triple);
+
+        if (runtimeTriple.getArch() != targetTriple.getArch() || runtimeTriple.getOS() != targetTriple.getOS()) {
+            return nullptr;
+        }
+
+        return std::move(*runtime);
+    }
+
+    // integers and floats have to have the same width, every pointer is passed the same way
+    static bool IsSamePrototype(llvm::FunctionType * declared, llvm::FunctionType * defined) {
+        if (declared->getNumParams() != defined->getNumParams() || declared->isVarArg() != defined->isVarArg()) {
+            return false;
+        }
+
+        auto isSameType = [](llvm::Type * first, llvm::Type * second) {
+            if (first->isPointerTy() && second->isPointerTy()) {
+                return true;
+            }
 
-        llvm::raw_fd_ostream dest(Filename, EC, llvm::sys::fs::OF_None);
+            return first->getTypeID() == second->getTypeID() && first->getPrimitiveSizeInBits() == second->getPrimitiveSizeInBits();
+        };
+
+        for (unsigned i = 0; i < declared->getNumParams(); ++i) {
+            if (!isSameType(declared->getParamType(i), defined->getParamType(i))) {
+                return false;
+            }
+        }
+
+        return isSameType(declared->getReturnType(), defined->getReturnType());
+    }
 
-        if (EC) {
-            llvm::errs() << "Could not open file: " << EC.message();
+    /**
+     * Copies the runtime functions the module calls into it, so the optimizer can inline them.
+     * They stay available_externally: whatever is not inlined is still called in the runtime
+     * archive, which also keeps the only definition of the state of the runtime.
+     */
+    static void LinkRuntime(llvm::Module * module, const TargetSettings & target) {
+        bool callsRuntime = std::any_of(module->begin(), module->end(), [](const llvm::Function & function) {
+            return function.isDeclaration() && function.getName().startswith("hunter_rt_");
+        });
+
+        if (!callsRuntime) {
             return;
         }
 
-        llvm::legacy::PassManager pass;
-        auto FileType = llvm::CGFT_ObjectFile;
+        std::unique_ptr<llvm::Module> runtime = LoadRuntime(module->getContext(), target);
+
+        if (!runtime) {
+            return;
+        }
+
+        // a copy of a static variable in every module would be a different variable in each of them
+        for (const auto &global : runtime->globals()) {
+            if (global.hasLocalLinkage() && !global.isConstant()) {
+                static std::once_flag warned;
+                std::call_once(warned, [&]() {
+                    COMPILER_WARN("The runtime bitcode has the static variable {0}, the runtime is not inlined", global.getName().str());
+                });
+                return;
+            }
+        }
+
+        llvm::StringSet<> runtimeFunctions;
 
-        if (TheTargetMachine->addPassesToEmitFile(pass, dest, nullptr, FileType)) {
-            llvm::errs() << "TheTargetMachine can't emit a file of this type";
+        for (const auto &function : *runtime) {
+            if (function.isDeclaration() || function.hasLocalLinkage()) {
+                continue;
+            }
+
+            llvm::Function * declaration = module->getFunction(function.getName());
+
+            // the linker would cast the call, which is not what the program meant
+            if (declaration && !IsSamePrototype(declaration->getFunctionType(), function.getFunctionType())) {
+                COMPILER_WARN("{0} is declared differently than in the runtime, the runtime is not inlined into {1}", function.getName().str(), module->getModuleIdentifier());
+                return;
+            }
+
+            runtimeFunctions.insert(function.getName());
+        }
+
+        llvm::StringSet<> runtimeVariables;
+
+        for (const auto &global : runtime->globals()) {
+            if (!global.isDeclaration() && !global.hasLocalLinkage()) {
+                runtimeVariables.insert(global.getName());
+            }
+        }
+
+        runtime->setTargetTriple(target.Triple);
+        runtime->setDataLayout(module->getDataLayout());
+
+        if (llvm::Linker::linkModules(*module, std::move(runtime), llvm::Linker::LinkOnlyNeeded)) {
+            COMPILER_WARN("Could not link the runtime into {0}", module->getModuleIdentifier());
             return;
         }
 
-        pass.run(*module);
-        dest.flush();
+        for (auto &function : *module) {
+            if (function.isDeclaration() || !runtimeFunctions.count(function.getName())) {
+                continue;
+            }
+
+            function.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+            function.setComdat(nullptr);
+            // built for a generic CPU, the attributes of the program are set afterwards
+            function.removeFnAttr("target-features");
+            function.removeFnAttr("tune-cpu");
+        }
+
+        for (auto &global : module->globals()) {
+            if (global.isDeclaration() || !runtimeVariables.count(global.getName())) {
+                continue;
+            }
+
+            if (global.isConstant()) {
+                global.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+            } else {
+                global.setInitializer(nullptr);
+                global.setLinkage(llvm::GlobalValue::ExternalLinkage);
+            }
+
+            global.setComdat(nullptr);
+        }
+    }
+
+    bool CompileModule(llvm::Module * module, const std::vector<ModuleOutput> & outputs, const TargetSettings & target) {
+        llvm::TimeTraceScope timeScope("CompileModule", module->getModuleIdentifier());
+        std::unique_ptr<llvm::TargetMachine> TheTargetMachine = CreateTargetMachine(target);
+
+        if (!TheTargetMachine) {
+            return false;
+        }
+
+        // set before the runtime is linked in, which gets the same ones
+        module->setTargetTriple(target.Triple);
+        module->setDataLayout(TheTargetMachine->createDataLayout());
+
+        // a linked program already contains the whole runtime, without optimizations nothing would be inlined
+        if (target.Optimization != OptimizationLevel::O0 && !target.LinkTimeOptimization) {
+            LinkRuntime(module, target);
+        }
+
+        // recorded on every function like clang does it, so the passes and a later LTO step know the target as well
+        for (auto &function : *module) {
+            if (function.isDeclaration()) {
+                continue;
+            }
+
+            function.addFnAttr("target-cpu", target.CPU);
+
+            if (!target.Features.empty()) {
+                function.addFnAttr("target-features", target.Features);
+            }
+        }
+
+        OptimizeModule(module, TheTargetMachine.get(), target.Optimization, target.LinkTimeOptimization, GetProfileOptions(target));
+
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            const auto &output = outputs[i];
+            std::error_code EC;
+
+            llvm::raw_fd_ostream dest(output.File, EC, llvm::sys::fs::OF_None);
+
+            if (EC) {
+                llvm::errs() << "Could not open file: " << EC.message();
+                return false;
+            }
+
+            // the backend changes the module while it emits it, every output but the last one gets a copy
+            std::unique_ptr<llvm::Module> copy;
+            llvm::Module * emittedModule = module;
+
+            if (i + 1 < outputs.size()) {
+                copy = llvm::CloneModule(*module);
+                emittedModule = copy.get();
+            }
+
+            llvm::legacy::PassManager pass;
+
+            if (TheTargetMachine->addPassesToEmitFile(pass, dest, nullptr, output.Type)) {
+                llvm::errs() << "TheTargetMachine can't emit a file of this type";
+                return false;
+            }
+
+            {
+                llvm::TimeTraceScope emitScope(output.Type == llvm::CGFT_AssemblyFile ? "EmitAssembly" : "EmitObject", output.File);
+                pass.run(*emittedModule);
+            }
+
+            dest.flush();
+        }
+
+        return true;
+    }
+
+    bool CompileModule(llvm::Module * module, const std::string & objectFile, const TargetSettings & target) {
+        return CompileModule(module, std::vector<ModuleOutput>{{objectFile, llvm::CGFT_ObjectFile}}, target);
+    }
+
+    llvm::Module * LinkProgram(const std::vector<llvm::Module *> & modules, const TargetSettings & target) {
+        llvm::TimeTraceScope timeScope("LinkProgram");
+        std::unique_ptr<llvm::TargetMachine> targetMachine = CreateTargetMachine(target);
+
+        if (!targetMachine) {
+            return nullptr;
+        }
+
+        // set before linking, the libraries were compiled for the target already and the linker warns about any difference
+        for (auto * module : modules) {
+            module->setTargetTriple(target.Triple);
+            module->setDataLayout(targetMachine->createDataLayout());
+        }
+
+        llvm::Module * program = modules.front();
+        llvm::Linker linker(*program);
+
+        for (size_t i = 1; i < modules.size(); ++i) {
+            std::string moduleName = modules[i]->getModuleIdentifier();
+
+            if (linker.linkInModule(std::unique_ptr<llvm::Module>(modules[i]))) {
+                COMPILER_ERROR("Could not link module {0} into the program", moduleName);
+                return nullptr;
+            }
+        }
+
+        for (const auto &bitcodeFile : target.LinkTimeInputs) {
+            llvm::SMDiagnostic error;
+            std::unique_ptr<llvm::Module> library = llvm::parseIRFile(bitcodeFile, error, program->getContext());
+
+            if (!library) {
+                COMPILER_ERROR("Could not read the bitcode of {0}: {1}", bitcodeFile, error.getMessage().str());
+                return nullptr;
+            }
+
+            if (linker.linkInModule(std::move(library))) {
+                COMPILER_ERROR("Could not link {0} into the program", bitcodeFile);
+                return nullptr;
+            }
+        }
+
+        // all of it, the runtime is internalized with the program and the archive is not needed anymore
+        if (std::unique_ptr<llvm::Module> runtime = LoadRuntime(program->getContext(), target)) {
+            runtime->setTargetTriple(target.Triple);
+            runtime->setDataLayout(program->getDataLayout());
+
+            if (linker.linkInModule(std::move(runtime))) {
+                COMPILER_ERROR("Could not link the runtime into the program");
+                return nullptr;
+            }
+        }
+
+        // only the C runtime calls into the program, everything else may be inlined or dropped
+        llvm::internalizeModule(*program, [](const llvm::GlobalValue & value) {
+            return value.getName() == "main";
+        });
+
+        return program;
+    }
+
+    static bool RunLinker(const std::string & linker, const std::vector<std::string> & arguments, const std::string & outputFile) {
+        std::vector<llvm::StringRef> linkerArguments = {linker};
+        linkerArguments.insert(linkerArguments.end(), arguments.begin(), arguments.end());
+
+        std::string errorMessage;
+        int result = llvm::sys::ExecuteAndWait(linker, linkerArguments, llvm::None, {}, 0, 0, &errorMessage);
+
+        if (result != 0) {
+            COMPILER_ERROR("Linking {0} failed: {1}", outputFile, errorMessage.empty() ? "exit code " + std::to_string(result) : errorMessage);
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool LinkObjects(const std::vector<std::string> & objectFiles, const std::string & outputFile) {
+        llvm::TimeTraceScope timeScope("LinkObjects", outputFile);
+        auto linker = llvm::sys::findProgramByName("ld");
+
+        if (!linker) {
+            COMPILER_ERROR("Could not find the linker to combine the modules: {0}", linker.getError().message());
+            return false;
+        }
+
+        std::vector<std::string> arguments = {"-r", "-o", outputFile};
+        arguments.insert(arguments.end(), objectFiles.begin(), objectFiles.end());
+
+        return RunLinker(*linker, arguments, outputFile);
+    }
+
+    // the C compiler knows where the C runtime and the C library of the system are, so it drives the link
+    static bool LinkExecutable(const std::vector<std::string> & objectFiles, const std::string & outputFile, const TargetSettings & target) {
+        llvm::TimeTraceScope timeScope("LinkExecutable", outputFile);
+        llvm::Expected<ExecutableLinker> linker = FindExecutableLinker(target);
+
+        if (!linker) {
+            COMPILER_ERROR("Could not link {0}: {1}", outputFile, llvm::toString(linker.takeError()));
+            return false;
+        }
+
+        // print writes through the runtime, so every program needs it. an installed compiler points to it through the environment
+        std::string runtimeLibrary = GetRuntimeLibraryFile();
+
+        if (!llvm::sys::fs::exists(runtimeLibrary)) {
+            COMPILER_ERROR("Could not find the Hunter runtime {0} to link {1}, set HUNTER_RUNTIME_LIBRARY", runtimeLibrary, outputFile);
+            return false;
+        }
+
+        std::vector<std::string> arguments = {"-o", outputFile};
+        arguments.insert(arguments.end(), objectFiles.begin(), objectFiles.end());
+        arguments.push_back(runtimeLibrary);
+        // the runtime keeps a buffer per thread, older C libraries have the thread functions in a separate library
+        arguments.emplace_back("-pthread");
+
+        // the objects are not position independent, most distributions build position independent executables by default
+        if (llvm::Triple(target.Triple).isOSBinFormatELF()) {
+            arguments.emplace_back("-no-pie");
+        }
+
+        arguments.insert(arguments.end(), linker->ProfileArguments.begin(), linker->ProfileArguments.end());
+
+        return RunLinker(linker->Driver, arguments, outputFile);
+    }
+
+    bool CompileModules(const std::vector<llvm::Module *> & modules, const ProgramOutputs & outputs, const TargetSettings & target, size_t threadCount) {
+        bool needsObjects = !outputs.Object.empty() || !outputs.Executable.empty();
+        // nothing to combine, the object is written directly
+        bool directObject = modules.size() == 1 && !outputs.Object.empty();
+
+        llvm::SmallString<128> objectDirectory;
+        std::vector<std::string> objectFiles;
+
+        if (directObject) {
+            objectFiles.push_back(outputs.Object);
+        } else if (needsObjects) {
+            if (std::error_code error = llvm::sys::fs::createUniqueDirectory("hunter-objects", objectDirectory)) {
+                COMPILER_ERROR("Could not create a directory for the module objects: {0}", error.message());
+                return false;
+            }
+
+            for (size_t i = 0; i < modules.size(); ++i) {
+                objectFiles.push_back((objectDirectory + "/module-" + std::to_string(i) + ".o").str());
+            }
+        }
+
+        std::vector<std::vector<ModuleOutput>> moduleOutputs(modules.size());
+
+        for (size_t i = 0; i < modules.size(); ++i) {
+            if (needsObjects) {
+                moduleOutputs[i].push_back({objectFiles[i], llvm::CGFT_ObjectFile});
+            }
+
+            if (i < outputs.Assembly.size()) {
+                moduleOutputs[i].push_back({outputs.Assembly[i], llvm::CGFT_AssemblyFile});
+            }
+        }
+
+        // every module has its own context, so they do not share anything while being compiled
+        std::atomic<bool> succeeded = true;
+        {
+            ThreadPool pool(std::min(modules.size(), threadCount ? threadCount : ThreadPool::GetDefaultThreadCount()));
+
+            for (size_t i = 0; i < modules.size(); ++i) {
+                pool.Submit([&, i]() {
+                    if (!CompileModule(modules[i], moduleOutputs[i], target)) {
+                        succeeded = false;
+                    }
+                });
+            }
+
+            pool.Wait();
+        }
+
+        bool linked = succeeded;
+
+        if (linked && !directObject && !outputs.Object.empty()) {
+            linked = LinkObjects(objectFiles, outputs.Object);
+        }
+
+        if (linked && !outputs.Executable.empty()) {
+            linked = LinkExecutable(objectFiles, outputs.Executable, target);
+        }
+
+        if (!objectDirectory.empty()) {
+            llvm::sys::fs::remove_directories(objectDirectory);
+        }
 
-        llvm::outs() << "Wrote " << Filename << "\n";
+        return linked;
     }
 
 }
\ No newline at end of file
@@ -4,15 +4,129 @@
 
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/ErrorOr.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/PGOOptions.h>
 #include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace Hunter::Compiler {
 
-    void CompileModule(llvm::Module * module);
+    enum class OptimizationLevel {
+        O0,
+        O1,
+        O2,
+        O3,
+        Os,
+    };
+
+    // returns false if the flag is not one of -O0, -O1, -O2, -O3 or -Os
+    bool ParseOptimizationLevel(std::string_view flag, OptimizationLevel & level);
+    const char * GetOptimizationLevelString(OptimizationLevel level);
+
+    // everything besides the module itself that changes the emitted object
+    struct TargetSettings {
+        std::string Triple = llvm::sys::getDefaultTargetTriple();
+        std::string CPU = "generic";
+        std::string Features;
+        OptimizationLevel Optimization = OptimizationLevel::O0;
+        // all modules are linked into one before they are optimized, together with the bitcode of these libraries
+        bool LinkTimeOptimization = false;
+        std::vector<std::string> LinkTimeInputs;
+        // instrumented programs write their counters to this file on exit, llvm-profdata merges them into a profile
+        std::string ProfileGenerate;
+        // merged profile of earlier runs, provides the branch weights and function entry counts
+        std::string ProfileUse;
+    };
+
+    // targets the CPU of this machine with all of its features, like -march=native of other compilers
+    void UseHostCPU(TargetSettings & target);
+
+    // adds comma separated features like +avx2,-fma, later ones win over the ones already set
+    void AddTargetFeatures(TargetSettings & target, std::string_view features);
+
+    llvm::CodeGenOpt::Level GetCodeGenLevel(OptimizationLevel level);
+
+    // returns None if the target neither generates nor uses a profile
+    llvm::Optional<llvm::PGOOptions> GetProfileOptions(const TargetSettings & target);
+
+    /**
+     * Runs the default pipeline of the level, modules which are not valid IR are left alone.
+     * With a profile, even -O0 runs the passes which instrument the module or apply the profile.
+     */
+    void OptimizeModule(
+        llvm::Module * module,
+        llvm::TargetMachine * targetMachine,
+        OptimizationLevel level,
+        bool linkTime = false,
+        const llvm::Optional<llvm::PGOOptions> & profile = llvm::None
+    );
+
+    // the runtime of the programs, $HUNTER_RUNTIME_LIBRARY and $HUNTER_RUNTIME_BITCODE override the ones of the build
+    std::string GetRuntimeLibraryFile();
+    // empty if the runtime was built without bitcode
+    std::string GetRuntimeBitcodeFile();
+
+    // links the executables, $CC or the first C compiler driver found on the path
+    llvm::ErrorOr<std::string> FindCCompiler();
+    // linked into instrumented programs by drivers which are not clang, $HUNTER_PROFILE_RUNTIME overrides the one of the build
+    std::string GetProfileRuntimeFile();
+
+    // the C compiler driver of the executables and what it needs to link the profile runtime of instrumented programs
+    struct ExecutableLinker {
+        std::string Driver;
+        std::vector<std::string> ProfileArguments;
+    };
+
+    // instrumented programs prefer clang over $CC, the error says what is missing if neither can link them
+    llvm::Expected<ExecutableLinker> FindExecutableLinker(const TargetSettings & target);
+
+    // returns nullptr if the target is not known, the reason is already printed
+    std::unique_ptr<llvm::TargetMachine> CreateTargetMachine(const TargetSettings & target);
+
+    /**
+     * Links the modules and the link time inputs of the target into the first module and internalizes
+     * everything besides main, so the whole program can be optimized at once. The modules have to
+     * share one context, all besides the first one are consumed.
+     */
+    llvm::Module * LinkProgram(const std::vector<llvm::Module *> & modules, const TargetSettings & target);
+
+    // a file the backend writes for a module
+    struct ModuleOutput {
+        std::string File;
+        llvm::CodeGenFileType Type = llvm::CGFT_ObjectFile;
+    };
+
+    /**
+     * Optimizes the module once and writes all outputs from it. Returns false if one of them
+     * could not be written, the reason is already printed.
+     */
+    bool CompileModule(llvm::Module * module, const std::vector<ModuleOutput> & outputs, const TargetSettings & target = {});
+    bool CompileModule(llvm::Module * module, const std::string & objectFile, const TargetSettings & target = {});
+
+    // what CompileModules writes, empty files are not written at all
+    struct ProgramOutputs {
+        // all modules combined with a relocatable link, so it can be used like a single object
+        std::string Object;
+        // linked with the C runtime by the C compiler driver of the system
+        std::string Executable;
+        // one file for every module
+        std::vector<std::string> Assembly;
+    };
+
+    /**
+     * Emits the objects of all modules at the same time and links them into the requested outputs.
+     * Objects which are only needed for linking are kept in a temporary directory.
+     * A thread count of 0 uses one thread per core.
+     */
+    bool CompileModules(const std::vector<llvm::Module *> & modules, const ProgramOutputs & outputs, const TargetSettings & target = {}, size_t threadCount = 0);
 
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "ConstantPool.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Module.h>
+
+namespace Hunter::Compiler {
+
+    static llvm::GlobalVariable * CreateConstant(llvm::Module * module, llvm::Constant * initializer, const char * name) {
+        auto * global = new llvm::GlobalVariable(
+            *module,
+            initializer->getType(),
+            true,
+            llvm::GlobalValue::PrivateLinkage,
+            initializer,
+            name
+        );
+
+        // only the content matters, the address may be shared with other constants
+        global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+
+        return global;
+    }
+
+    llvm::Constant * ConstantPool::GetString(std::string_view str) {
+        auto [entry, isNew] = m_Strings.try_emplace(llvm::StringRef(str.data(), str.size()), nullptr);
+
+        if (isNew) {
+            llvm::Constant * data = llvm::ConstantDataArray::getString(m_Module->getContext(), entry->getKey(), true);
+            llvm::GlobalVariable * global = CreateConstant(m_Module, data, ".str");
+            global->setAlignment(llvm::Align(1));
+
+            llvm::Constant * zero = llvm::ConstantInt::get(llvm::Type::getInt32Ty(m_Module->getContext()), 0);
+            entry->second = llvm::ConstantExpr::getInBoundsGetElementPtr(data->getType(), global, llvm::ArrayRef<llvm::Constant *>({zero, zero}));
+        }
+
+        return entry->second;
+    }
+
+    llvm::Constant * ConstantPool::GetList(llvm::StructType * listType, llvm::Type * elementType, llvm::ArrayRef<llvm::Constant *> elements) {
+        llvm::Constant * data = llvm::ConstantArray::get(llvm::ArrayType::get(elementType, elements.size()), elements);
+        llvm::Constant *& list = m_Lists[data];
+
+        if (!list) {
+            auto * memoryType = llvm::cast<llvm::PointerType>(listType->getElementType(1));
+            llvm::Constant * memory = elements.empty()
+                ? llvm::ConstantPointerNull::get(memoryType)
+                : llvm::ConstantExpr::getBitCast(CreateConstant(m_Module, data, ".list.data"), memoryType);
+
+            llvm::Constant * initializer = llvm::ConstantStruct::get(listType, {
+                llvm::ConstantInt::get(listType->getElementType(0), elements.size()),
+                memory
+            });
+
+            list = CreateConstant(m_Module, initializer, ".list");
+        }
+
+        return list;
+    }
+}
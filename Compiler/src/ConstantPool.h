@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string_view>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringMap.h>
+
+namespace llvm {
+    class Constant;
+    class GlobalVariable;
+    class Module;
+    class StructType;
+    class Type;
+}
+
+namespace Hunter::Compiler {
+
+    /**
+     * The read-only data of a module. Every literal is emitted once as a private unnamed_addr
+     * constant, no matter how often it is used, so identical literals share their memory and
+     * the linker can merge them with the ones of other modules.
+     */
+    class ConstantPool {
+    public:
+        explicit ConstantPool(llvm::Module * module) : m_Module(module) {}
+        ConstantPool(const ConstantPool &) = delete;
+        ConstantPool & operator=(const ConstantPool &) = delete;
+
+        // a pointer to the first character of the null terminated string
+        llvm::Constant * GetString(std::string_view str);
+
+        // a pointer to a constant list of the builtin list type, its elements are stored in a constant array
+        llvm::Constant * GetList(llvm::StructType * listType, llvm::Type * elementType, llvm::ArrayRef<llvm::Constant *> elements);
+
+    private:
+        llvm::Module * m_Module;
+
+        llvm::StringMap<llvm::Constant *> m_Strings;
+        // LLVM constants are unique, equal arrays are the same constant
+        llvm::DenseMap<llvm::Constant *, llvm::Constant *> m_Lists;
+    };
+}
@@ -3,36 +3,36 @@
 
 namespace Hunter::Compiler {
 
-    DataType *DataType::FromString(const std::string &typeStr) {
+    DataType *DataType::FromString(const std::string &typeStr, Arena &arena) {
 
         if (typeStr == "string") {
-            return new DataType(DataTypeId::String);
+            return arena.Create<DataType>(DataTypeId::String);
         }
         else if (typeStr == "memory") {
-            return new DataType(DataTypeId::Memory);
+            return arena.Create<DataType>(DataTypeId::Memory);
         }
         else if (typeStr == "i8") {
-            return new DataType(DataTypeId::i8);
+            return arena.Create<DataType>(DataTypeId::i8);
         }
         else if (typeStr == "i16") {
-            return new DataType(DataTypeId::i16);
+            return arena.Create<DataType>(DataTypeId::i16);
         }
         else if (typeStr == "i32") {
-            return new DataType(DataTypeId::i32);
+            return arena.Create<DataType>(DataTypeId::i32);
         }
         else if (typeStr == "i64") {
-            return new DataType(DataTypeId::i64);
+            return arena.Create<DataType>(DataTypeId::i64);
         }
         else if (typeStr.empty()) {
-            return new DataType(DataTypeId::Void);
+            return arena.Create<DataType>(DataTypeId::Void);
         }
         else if (typeStr.starts_with("list<")) {
             std::string listSearchStr = "list<";
             std::string templateTypeStr = typeStr.substr(listSearchStr.size(), typeStr.size()-listSearchStr.size()-1);
-            return new DataType(DataTypeId::List, FromString(templateTypeStr));
+            return arena.Create<DataType>(DataTypeId::List, FromString(templateTypeStr, arena));
         }
         else {
-            return new DataType(DataTypeId::Unknown);
+            return arena.Create<DataType>(DataTypeId::Unknown);
         }
 
     }
@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "Arena.h"
+
 namespace Hunter::Compiler {
 
     enum class IntType {
@@ -40,11 +42,11 @@ namespace Hunter::Compiler {
             return m_TemplateType;
         }
 
-        static DataType * FromString(const std::string & typeStr);
+        static DataType * FromString(const std::string & typeStr, Arena & arena);
 
     private:
         DataTypeId m_TypeId;
-        DataType * m_TemplateType;
+        DataType * m_TemplateType = nullptr;
     };
 
 }
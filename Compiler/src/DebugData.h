@@ -1,6 +1,7 @@
 #pragma once
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 
 namespace Hunter::Parser::Debug {
     class DebugEntry {
@@ -9,20 +10,21 @@ namespace Hunter::Parser::Debug {
 
     class DebugData {
     public:
-        std::string GetDirectory() const { return m_Directory; }
-        std::string GetFileName() const { return m_FileName; }
+        std::string_view GetDirectory() const { return m_Directory; }
+        std::string_view GetFileName() const { return m_FileName; }
         int64_t GetFileLine() const { return m_Line; }
         int64_t GetLineColumn() const { return m_Column; }
 
-        void SetDirectory(const std::string & directory) { m_Directory = directory; }
-        void SetFileName(const std::string & fileName) { m_FileName = fileName; }
+        void SetDirectory(std::string_view directory) { m_Directory = directory; }
+        void SetFileName(std::string_view fileName) { m_FileName = fileName; }
         void SetFileLine(int64_t line) { m_Line = line; }
         void SetFileColumn(int64_t column) { m_Column = column; }
 
     private:
-        std::string m_Directory;
-        std::string m_FileName;
-        int64_t m_Line;
-        int64_t m_Column;
+        // both are owned by the SourceManager
+        std::string_view m_Directory;
+        std::string_view m_FileName;
+        int64_t m_Line = 0;
+        int64_t m_Column = 0;
     };
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Expressions.h"
 #include "./utils/logger.h"
 
+#include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/Module.h>
 
 namespace Hunter::Compiler::Debug {
@@ -16,6 +17,9 @@ namespace Hunter::Compiler::Debug {
             "",
             0
         );
+
+        // without the version, the debug info is dropped when the module is read again
+        m_Module->addModuleFlag(llvm::Module::Warning, "Debug Info Version", llvm::DEBUG_METADATA_VERSION);
     }
 
     void DebugGenerator::DefineFunction(llvm::Function *func, FunctionExpression * expr) {
@@ -29,7 +33,7 @@ namespace Hunter::Compiler::Debug {
             Unit,
             expr->GetDebugData()->GetFileLine(),
             GetFunctionType(expr),
-            expr->GetDebugData()->GetLineColumn(),
+            expr->GetDebugData()->GetFileLine(),
             llvm::DINode::FlagPrototyped,
             llvm::DISubprogram::SPFlagDefinition
         );
@@ -39,18 +43,17 @@ namespace Hunter::Compiler::Debug {
     }
 
     void DebugGenerator::DefineVariable(llvm::IRBuilder<> *builder, llvm::AllocaInst * alloc, Expression *expr) {
-        llvm::DIScope *scope;
+        // locations are only valid inside of a function, statements of the main file have none
         if (m_LexicalBlocks.empty()) {
-            scope = m_CompileUnit;
-        }
-        else {
-            scope = m_LexicalBlocks.back();
+            return;
         }
 
+        llvm::DIScope *scope = m_LexicalBlocks.back();
+
         std::string variableName;
         llvm::DIType * variableType;
 
-        if (auto * var = dynamic_cast<VariableDeclarationExpression *>(expr)) {
+        if (auto * var = DynCast<VariableDeclarationExpression>(expr)) {
             variableName = var->GetVariableName();
             variableType = GetDebugDatatype(m_CodeGenerator->GetVariableDeclarationType(var));
         }
@@ -70,14 +73,13 @@ namespace Hunter::Compiler::Debug {
     }
 
     void DebugGenerator::EmitLocation(llvm::IRBuilder<> *builder, Expression *expr) {
-        llvm::DIScope *scope;
         if (m_LexicalBlocks.empty()) {
-            scope = m_CompileUnit;
-        }
-        else {
-            scope = m_LexicalBlocks.back();
+            builder->SetCurrentDebugLocation(llvm::DebugLoc());
+            return;
         }
 
+        llvm::DIScope *scope = m_LexicalBlocks.back();
+
         auto * debugData = expr->GetDebugData();
         builder->SetCurrentDebugLocation(
             llvm::DILocation::get(
@@ -122,13 +124,18 @@ namespace Hunter::Compiler::Debug {
                     m_DebugInfoBuilder->createBasicType("void", 64, 0),
                     64
                 );
-//            case DataTypeId::List:
-//                return m_DebugInfoBuilder->createPointerType(m_Structs["list"], 64);
+            case DataTypeId::List:
+            case DataTypeId::Struct:
+            case DataTypeId::Custom:
+                return m_DebugInfoBuilder->createPointerType(
+                    m_DebugInfoBuilder->createBasicType("void", 64, 0),
+                    64
+                );
             case DataTypeId::Void:
                 return m_DebugInfoBuilder->createBasicType("void", 64, 0);
-//            default:
-//                COMPILER_ERROR("Unhandled data type: {0}", dataType);
-//                exit(1);
+            default:
+                COMPILER_ERROR("Unhandled data type: {0}", dataType);
+                exit(1);
         }
     }
 
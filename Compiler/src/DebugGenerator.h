@@ -26,7 +26,7 @@ namespace Hunter::Compiler::Debug {
     class DebugGenerator {
     public:
         DebugGenerator(llvm::Module * module, Hunter::Compiler::CodeGenerator * generator)
-            : m_DebugInfoBuilder(new llvm::DIBuilder(*module)), m_CodeGenerator(generator) {}
+            : m_Module(module), m_DebugInfoBuilder(new llvm::DIBuilder(*module)), m_CodeGenerator(generator) {}
 
         void CreateCompileUnit(Hunter::Parser::Debug::DebugData * data);
         void DefineFunction(llvm::Function * func, FunctionExpression * expr);
@@ -40,6 +40,7 @@ namespace Hunter::Compiler::Debug {
         llvm::DIType * GetDebugDatatype(DataTypeId dataType);
         llvm::DISubroutineType * GetFunctionType(FunctionExpression * expr);
 
+        llvm::Module * m_Module;
         llvm::DIBuilder * m_DebugInfoBuilder = nullptr;
         llvm::DICompileUnit * m_CompileUnit;
         std::vector<llvm::DIScope *> m_LexicalBlocks;
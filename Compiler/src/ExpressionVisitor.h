@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Expressions.h"
+
+namespace Hunter::Compiler {
+
+    /**
+     * Dispatches an expression to the matching Visit method of Derived with a single switch
+     * over the kind tag. Every Visit method falls back to the one of the base class, so a
+     * visitor only has to implement the expressions it cares about, everything else ends
+     * up in VisitExpression. Additional arguments are passed through to every Visit method.
+     */
+    template<typename Derived, typename ReturnType = void, typename... Args>
+    class ExpressionVisitor {
+    public:
+        ReturnType Visit(Expression * expr, Args... args) {
+            switch (expr->GetKind()) {
+                case ExpressionKind::Import:
+                    return Self().VisitImport(static_cast<ImportExpression *>(expr), args...);
+                case ExpressionKind::Module:
+                    return Self().VisitModule(static_cast<ModuleExpression *>(expr), args...);
+                case ExpressionKind::Print:
+                    return Self().VisitPrint(static_cast<PrintExpression *>(expr), args...);
+                case ExpressionKind::Extern:
+                    return Self().VisitExtern(static_cast<ExternExpression *>(expr), args...);
+                case ExpressionKind::String:
+                    return Self().VisitString(static_cast<StringExpression *>(expr), args...);
+                case ExpressionKind::VariableMutation:
+                    return Self().VisitVariableMutation(static_cast<VariableMutationExpression *>(expr), args...);
+                case ExpressionKind::Boolean:
+                    return Self().VisitBoolean(static_cast<BooleanExpression *>(expr), args...);
+                case ExpressionKind::Operation:
+                    return Self().VisitOperation(static_cast<OperationExpression *>(expr), args...);
+                case ExpressionKind::Int:
+                    return Self().VisitInt(static_cast<IntExpression *>(expr), args...);
+                case ExpressionKind::Identifier:
+                    return Self().VisitIdentifier(static_cast<IdentifierExpression *>(expr), args...);
+                case ExpressionKind::StructConstruction:
+                    return Self().VisitStructConstruction(static_cast<StructConstructionExpression *>(expr), args...);
+                case ExpressionKind::FunctionReturn:
+                    return Self().VisitFunctionReturn(static_cast<FunctionReturnExpression *>(expr), args...);
+                case ExpressionKind::FunctionCall:
+                    return Self().VisitFunctionCall(static_cast<FunctionCallExpression *>(expr), args...);
+                case ExpressionKind::Parameter:
+                    return Self().VisitParameter(static_cast<ParameterExpression *>(expr), args...);
+                case ExpressionKind::List:
+                    return Self().VisitList(static_cast<ListExpression *>(expr), args...);
+                case ExpressionKind::Range:
+                    return Self().VisitRange(static_cast<RangeExpression *>(expr), args...);
+                case ExpressionKind::PropertyDeclaration:
+                    return Self().VisitPropertyDeclaration(static_cast<PropertyDeclarationExpression *>(expr), args...);
+                case ExpressionKind::Const:
+                    return Self().VisitConst(static_cast<ConstExpression *>(expr), args...);
+                case ExpressionKind::Let:
+                    return Self().VisitLet(static_cast<LetExpression *>(expr), args...);
+                case ExpressionKind::Struct:
+                    return Self().VisitStruct(static_cast<StructExpression *>(expr), args...);
+                case ExpressionKind::Function:
+                    return Self().VisitFunction(static_cast<FunctionExpression *>(expr), args...);
+                case ExpressionKind::Else:
+                    return Self().VisitElse(static_cast<ElseExpression *>(expr), args...);
+                case ExpressionKind::If:
+                    return Self().VisitIf(static_cast<IfExpression *>(expr), args...);
+                case ExpressionKind::While:
+                    return Self().VisitWhile(static_cast<WhileExpression *>(expr), args...);
+                case ExpressionKind::ForLoop:
+                    return Self().VisitForLoop(static_cast<ForLoopExpression *>(expr), args...);
+            }
+
+            return Self().VisitExpression(expr, args...);
+        }
+
+        ReturnType VisitExpression(Expression *, Args...) { return ReturnType(); }
+
+        ReturnType VisitImport(ImportExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitModule(ModuleExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitPrint(PrintExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitExtern(ExternExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitString(StringExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitVariableMutation(VariableMutationExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitBoolean(BooleanExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitOperation(OperationExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitInt(IntExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitIdentifier(IdentifierExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitStructConstruction(StructConstructionExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitFunctionReturn(FunctionReturnExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitFunctionCall(FunctionCallExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitParameter(ParameterExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitList(ListExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitRange(RangeExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+
+        ReturnType VisitVariableDeclaration(VariableDeclarationExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitPropertyDeclaration(PropertyDeclarationExpression * expr, Args... args) { return Self().VisitVariableDeclaration(expr, args...); }
+        ReturnType VisitConst(ConstExpression * expr, Args... args) { return Self().VisitVariableDeclaration(expr, args...); }
+        ReturnType VisitLet(LetExpression * expr, Args... args) { return Self().VisitVariableDeclaration(expr, args...); }
+
+        ReturnType VisitBlock(BlockExpression * expr, Args... args) { return Self().VisitExpression(expr, args...); }
+        ReturnType VisitStruct(StructExpression * expr, Args... args) { return Self().VisitBlock(expr, args...); }
+        ReturnType VisitFunction(FunctionExpression * expr, Args... args) { return Self().VisitBlock(expr, args...); }
+        ReturnType VisitElse(ElseExpression * expr, Args... args) { return Self().VisitBlock(expr, args...); }
+        ReturnType VisitIf(IfExpression * expr, Args... args) { return Self().VisitBlock(expr, args...); }
+        ReturnType VisitWhile(WhileExpression * expr, Args... args) { return Self().VisitBlock(expr, args...); }
+        ReturnType VisitForLoop(ForLoopExpression * expr, Args... args) { return Self().VisitBlock(expr, args...); }
+
+    private:
+        Derived & Self() { return *static_cast<Derived *>(this); }
+    };
+
+}
@@ -3,7 +3,7 @@
 
 namespace Hunter::Compiler {
 
-    DataTypeId GetDataTypeFromString(const std::string &typeStr) {
+    DataTypeId GetDataTypeFromString(std::string_view typeStr) {
         if (typeStr == "string") {
             return DataTypeId::String;
         }
@@ -68,7 +68,7 @@ namespace Hunter::Compiler {
     }
 
 
-    OperatorType GetOperatorFromString(const std::string &str) {
+    OperatorType GetOperatorFromString(std::string_view str) {
 
         if (str == "eq") {
             return OperatorType::LogicalEquals;
@@ -187,7 +187,7 @@ namespace Hunter::Compiler {
 
     DataTypeId GetDataTypeFromExpression(Expression *expr) {
 
-        if (dynamic_cast<StringExpression *>(expr)) {
+        if (DynCast<StringExpression>(expr)) {
             return DataTypeId::String;
         }
 
@@ -198,12 +198,12 @@ namespace Hunter::Compiler {
         return m_Type;
     }
 
-    uint64_t StructExpression::GetPropertyIndex(const std::string &propertyName) {
+    uint64_t StructExpression::GetPropertyIndex(Symbol property) {
         uint64_t counter = 0;
         for (const auto &propertyExpr : GetBody()) {
-            auto * p = dynamic_cast<PropertyDeclarationExpression *>(propertyExpr);
+            auto * p = DynCast<PropertyDeclarationExpression>(propertyExpr);
 
-            if (p->GetVariableName() == propertyName) {
+            if (p->GetVariable() == property) {
                 return counter;
             }
 
@@ -1,16 +1,18 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include <iostream>
 
 #include "DataType.h"
 #include "DebugData.h"
+#include "SymbolTable.h"
 
 namespace Hunter::Compiler {
 
-    DataTypeId GetDataTypeFromString(const std::string & typeStr);
+    DataTypeId GetDataTypeFromString(std::string_view typeStr);
     std::string GetDataTypeString(DataTypeId dataType);
 
     IntType GetTypeFromValue(int64_t val);
@@ -36,13 +38,53 @@ namespace Hunter::Compiler {
         BitNot,
     };
 
-    OperatorType GetOperatorFromString(const std::string & str);
+    OperatorType GetOperatorFromString(std::string_view str);
     int8_t GetOperandsNumber(OperatorType operatorType);
     std::string GetOperatorString(OperatorType operatorType);
 
+    /**
+     * Tag of every concrete expression class. Expressions sharing a base class are kept
+     * next to each other, so the base class checks are a simple range comparison.
+     */
+    enum class ExpressionKind : uint8_t {
+        Import,
+        Module,
+        Print,
+        Extern,
+        String,
+        VariableMutation,
+        Boolean,
+        Operation,
+        Int,
+        Identifier,
+        StructConstruction,
+        FunctionReturn,
+        FunctionCall,
+        Parameter,
+        List,
+        Range,
+
+        // variable declarations
+        PropertyDeclaration,
+        Const,
+        Let,
+
+        // blocks
+        Struct,
+        Function,
+        Else,
+        If,
+        While,
+        ForLoop,
+    };
+
     class Expression {
     public:
+        explicit Expression(ExpressionKind kind) : m_Kind(kind) {}
         virtual ~Expression() = default;
+
+        ExpressionKind GetKind() const { return m_Kind; }
+
         virtual const char* GetClassName() = 0;
         virtual void Dump(int level = 0) = 0;
         virtual bool HasBlock() { return false; }
@@ -57,83 +99,143 @@ namespace Hunter::Compiler {
             }
         }
 
-        Hunter::Parser::Debug::DebugData * m_DebugData;
+        Hunter::Parser::Debug::DebugData * m_DebugData = nullptr;
+
+    private:
+        ExpressionKind m_Kind;
     };
 
+    /**
+     * Replacements for dynamic_cast which only compare the kind tag of the expression.
+     * Like dynamic_cast, both accept a null pointer.
+     */
+    template<typename T>
+    bool IsA(const Expression * expr) {
+        return expr && T::classof(expr);
+    }
+
+    template<typename T>
+    T * DynCast(Expression * expr) {
+        return IsA<T>(expr) ? static_cast<T *>(expr) : nullptr;
+    }
+
     DataTypeId GetDataTypeFromExpression(Expression * expr);
 
     class ImportExpression : public Expression {
     public:
-        ImportExpression(std::string module) : m_Module(std::move(module)) {}
+        ImportExpression(std::string_view module) : Expression(ExpressionKind::Import), m_Module(module) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Import;
+        }
 
         const char *GetClassName() override {
             return "ImportExpression";
         }
 
-        const std::string &GetModule() const {
+        std::string_view GetModule() const {
             return m_Module;
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Import Expression: " << GetModule() << std::endl;
+            std::cout << "Import Expression: " << GetModule() << '\n';
         }
 
     private:
-        std::string m_Module;
+        std::string_view m_Module;
     };
 
     class ModuleExpression : public Expression {
     public:
-        ModuleExpression(std::string module) : m_Module(std::move(module)) {}
+        ModuleExpression(std::string_view module) : Expression(ExpressionKind::Module), m_Module(module) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Module;
+        }
 
         const char *GetClassName() override {
             return "ModuleExpression";
         }
 
-        const std::string &GetModule() const {
+        std::string_view GetModule() const {
             return m_Module;
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Module Expression: " << GetModule() << std::endl;
+            std::cout << "Module Expression: " << GetModule() << '\n';
         }
 
     private:
-        std::string m_Module;
+        std::string_view m_Module;
+    };
+
+    /**
+     * Source of block bodies which are only decoded when they are accessed for the first time,
+     * used for the function bodies of serialized trees.
+     */
+    class BodyDecoder {
+    public:
+        virtual void DecodeBody(size_t offset, std::vector<Expression *> & body) = 0;
+
+    protected:
+        ~BodyDecoder() = default;
     };
 
     class BlockExpression : public Expression {
     public:
+        explicit BlockExpression(ExpressionKind kind) : Expression(kind) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() >= ExpressionKind::Struct && expr->GetKind() <= ExpressionKind::ForLoop;
+        }
+
         bool HasBlock() override {
             return true;
         }
 
         void AddExpression(Expression * expr) {
-            m_Body.push_back(expr);
+            GetBody().push_back(expr);
         }
 
         std::vector<Expression *> & GetBody() {
+            if (m_BodyDecoder) {
+                BodyDecoder * decoder = m_BodyDecoder;
+                m_BodyDecoder = nullptr;
+                decoder->DecodeBody(m_BodyOffset, m_Body);
+            }
+
             return m_Body;
         }
 
+        void SetLazyBody(BodyDecoder * decoder, size_t offset) {
+            m_BodyDecoder = decoder;
+            m_BodyOffset = offset;
+        }
+
     private:
         std::vector<Expression *> m_Body;
+        BodyDecoder * m_BodyDecoder = nullptr;
+        size_t m_BodyOffset = 0;
     };
 
     class PrintExpression : public Expression {
     public:
-        PrintExpression(Expression * expr) : m_Data(expr) {}
+        PrintExpression(Expression * expr) : Expression(ExpressionKind::Print), m_Data(expr) {}
         Expression * GetInput() { return m_Data; }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Print;
+        }
+
         const char *GetClassName() override {
             return "PrintExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Print Expression: " << std::endl;
+            std::cout << "Print Expression: " << '\n';
             GetInput()->Dump(level+1);
         }
 
@@ -143,7 +245,7 @@ namespace Hunter::Compiler {
 
     class ExternExpression : public Expression {
     public:
-        ExternExpression(Expression * expr) : m_Data(expr) {}
+        ExternExpression(Expression * expr) : Expression(ExpressionKind::Extern), m_Data(expr) {}
         Expression * GetData() { return m_Data; }
 
         void SetDebugData(Hunter::Parser::Debug::DebugData *data) override {
@@ -151,13 +253,17 @@ namespace Hunter::Compiler {
             m_Data->SetDebugData(data);
         }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Extern;
+        }
+
         const char *GetClassName() override {
             return "ExternExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Extern Expression: " << std::endl;
+            std::cout << "Extern Expression: " << '\n';
             GetData()->Dump(level+1);
         }
 
@@ -167,8 +273,12 @@ namespace Hunter::Compiler {
 
     class StringExpression : public Expression {
     public:
-        StringExpression(std::string str) : m_Data(std::move(str)) {}
-        std::string & GetString() { return m_Data; }
+        StringExpression(std::string_view str) : Expression(ExpressionKind::String), m_Data(str) {}
+        std::string_view GetString() const { return m_Data; }
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::String;
+        }
 
         const char *GetClassName() override {
             return "StringExpression";
@@ -176,32 +286,44 @@ namespace Hunter::Compiler {
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "String Expression: " << GetString() << std::endl;
+            std::cout << "String Expression: " << GetString() << '\n';
         }
 
     private:
-        std::string m_Data;
+        // points into the source or into a string kept alive by the SourceManager
+        std::string_view m_Data;
     };
 
     class VariableDeclarationExpression : public Expression {
     public:
-        VariableDeclarationExpression(std::string name, Expression * value) : m_VariableName(std::move(name)), m_Type(DataTypeId::Unknown), m_Value(value) {}
-        VariableDeclarationExpression(std::string name, DataTypeId type) :
-            m_VariableName(std::move(name)), m_Type(type), m_Value(nullptr) {}
-        std::string & GetVariableName() { return m_VariableName; }
+        VariableDeclarationExpression(ExpressionKind kind, Symbol name, Expression * value)
+            : Expression(kind), m_Variable(name), m_Value(value), m_Type(DataTypeId::Unknown) {}
+        VariableDeclarationExpression(ExpressionKind kind, Symbol name, DataTypeId type)
+            : Expression(kind), m_Variable(name), m_Value(nullptr), m_Type(type) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() >= ExpressionKind::PropertyDeclaration && expr->GetKind() <= ExpressionKind::Let;
+        }
+
+        Symbol GetVariable() const { return m_Variable; }
+        std::string_view GetVariableName() const { return m_Variable.GetName(); }
         Expression * GetValue() { return m_Value; }
 
         DataTypeId GetVariableType();
 
     private:
-        std::string m_VariableName;
+        Symbol m_Variable;
         Expression * m_Value;
         DataTypeId m_Type;
     };
 
     class PropertyDeclarationExpression : public VariableDeclarationExpression {
     public:
-        PropertyDeclarationExpression(std::string name, DataTypeId type) : VariableDeclarationExpression(std::move(name), type) {}
+        PropertyDeclarationExpression(Symbol name, DataTypeId type) : VariableDeclarationExpression(ExpressionKind::PropertyDeclaration, name, type) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::PropertyDeclaration;
+        }
 
         const char *GetClassName() override {
             return "PropertyDeclarationExpression";
@@ -212,13 +334,17 @@ namespace Hunter::Compiler {
             std::cout << "Property Declaration Expression: "
                 << GetVariableName()
                 << " := "
-                << GetDataTypeString(GetVariableType()) << std::endl;
+                << GetDataTypeString(GetVariableType()) << '\n';
         }
     };
 
     class ConstExpression : public VariableDeclarationExpression {
     public:
-        ConstExpression(std::string name, Expression * value) : VariableDeclarationExpression(std::move(name), value) {}
+        ConstExpression(Symbol name, Expression * value) : VariableDeclarationExpression(ExpressionKind::Const, name, value) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Const;
+        }
 
         const char *GetClassName() override {
             return "ConstExpression";
@@ -226,14 +352,18 @@ namespace Hunter::Compiler {
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Const Expression: " << GetVariableName() << " := " << std::endl;
+            std::cout << "Const Expression: " << GetVariableName() << " := " << '\n';
             GetValue()->Dump(level+1);
         }
     };
 
     class LetExpression : public VariableDeclarationExpression {
     public:
-        LetExpression(std::string name, Expression * value) : VariableDeclarationExpression(std::move(name), value) {}
+        LetExpression(Symbol name, Expression * value) : VariableDeclarationExpression(ExpressionKind::Let, name, value) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Let;
+        }
 
         const char *GetClassName() override {
             return "LetExpression";
@@ -241,59 +371,68 @@ namespace Hunter::Compiler {
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Let Expression: " << GetVariableName() << " := " << std::endl;
+            std::cout << "Let Expression: " << GetVariableName() << " := " << '\n';
             GetValue()->Dump(level+1);
         }
     };
 
     class VariableMutationExpression : public Expression {
     public:
-        VariableMutationExpression(std::string name, Expression * value) : m_VariableName(std::move(name)), m_Value(value) {}
-        std::string & GetVariableName() { return m_VariableName; }
+        VariableMutationExpression(Symbol name, Expression * value) : Expression(ExpressionKind::VariableMutation), m_Variable(name), m_Value(value) {}
+        Symbol GetVariable() const { return m_Variable; }
+        std::string_view GetVariableName() const { return m_Variable.GetName(); }
         Expression * GetValue() { return m_Value; }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::VariableMutation;
+        }
+
         const char *GetClassName() override {
             return "VariableMutationExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Var Mutation Expression: " << GetVariableName() << " := " << std::endl;
+            std::cout << "Var Mutation Expression: " << GetVariableName() << " := " << '\n';
             GetValue()->Dump(level+1);
         }
 
     private:
-        std::string m_VariableName;
+        Symbol m_Variable;
         Expression * m_Value;
     };
 
     class BooleanExpression : public Expression {
     public:
         BooleanExpression(OperatorType operatorType, Expression * leftExpression, Expression * rightExpression)
-            : m_Operator(operatorType), m_Left(leftExpression), m_Right(rightExpression) {}
+            : Expression(ExpressionKind::Boolean), m_Operator(operatorType), m_Left(leftExpression), m_Right(rightExpression) {}
 
         OperatorType GetOperator() { return m_Operator; }
         Expression * Left() { return m_Left; }
         Expression * Right() { return m_Right; }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Boolean;
+        }
+
         const char *GetClassName() override {
             return "BooleanExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Boolean Expression: " << std::endl;
+            std::cout << "Boolean Expression: " << '\n';
 
             if (GetOperandsNumber(GetOperator()) == 1) {
                 DumpSpaces(level+1);
-                std::cout << GetOperatorString(GetOperator()) << std::endl;
+                std::cout << GetOperatorString(GetOperator()) << '\n';
                 Left()->Dump(level+1);
             }
 
             else if (GetOperandsNumber(GetOperator()) == 2) {
                 Left()->Dump(level+1);
                 DumpSpaces(level+1);
-                std::cout << GetOperatorString(GetOperator()) << std::endl;
+                std::cout << GetOperatorString(GetOperator()) << '\n';
                 Right()->Dump(level+1);
             }
         }
@@ -307,7 +446,7 @@ namespace Hunter::Compiler {
     class OperationExpression : public Expression {
     public:
         OperationExpression(OperatorType operatorType)
-            : m_Operator(operatorType), m_Left(nullptr), m_Right(nullptr) {}
+            : Expression(ExpressionKind::Operation), m_Operator(operatorType), m_Left(nullptr), m_Right(nullptr) {}
 
         OperatorType GetOperator() { return m_Operator; }
         Expression * Left() { return m_Left; }
@@ -321,24 +460,28 @@ namespace Hunter::Compiler {
             m_Right = right;
         }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Operation;
+        }
+
         const char *GetClassName() override {
             return "OperationExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Operation Expression: " << std::endl;
+            std::cout << "Operation Expression: " << '\n';
 
             if (GetOperandsNumber(GetOperator()) == 1) {
                 DumpSpaces(level+1);
-                std::cout << GetOperatorString(GetOperator()) << std::endl;
+                std::cout << GetOperatorString(GetOperator()) << '\n';
                 Left()->Dump(level+1);
             }
 
             else if (GetOperandsNumber(GetOperator()) == 2) {
                 Left()->Dump(level+1);
                 DumpSpaces(level+1);
-                std::cout << GetOperatorString(GetOperator()) << std::endl;
+                std::cout << GetOperatorString(GetOperator()) << '\n';
                 Right()->Dump(level+1);
             }
         }
@@ -351,18 +494,22 @@ namespace Hunter::Compiler {
 
     class IntExpression : public Expression {
     public:
-        IntExpression(IntType type, int64_t value) : m_Type(type), m_Value(value) {}
+        IntExpression(IntType type, int64_t value) : Expression(ExpressionKind::Int), m_Type(type), m_Value(value) {}
 
         IntType GetType() const { return m_Type; }
         int64_t GetValue() const { return m_Value; }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Int;
+        }
+
         const char *GetClassName() override {
             return "IntExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Int Expression: " << GetValue() << " (" << static_cast<int>(GetType()) << ")" << std::endl;
+            std::cout << "Int Expression: " << GetValue() << " (" << static_cast<int>(GetType()) << ")" << '\n';
         }
 
     private:
@@ -372,8 +519,19 @@ namespace Hunter::Compiler {
 
     class IdentifierExpression : public Expression {
     public:
-        IdentifierExpression(std::string name) : m_VariableName(std::move(name)) {}
-        std::string & GetVariableName() { return m_VariableName; }
+        IdentifierExpression(Symbol name, Symbol object, Symbol property)
+            : Expression(ExpressionKind::Identifier), m_Variable(name), m_Object(object), m_Property(property) {}
+
+        Symbol GetVariable() const { return m_Variable; }
+        std::string_view GetVariableName() const { return m_Variable.GetName(); }
+
+        // for "object.property" these are the two parts, otherwise the object is the variable itself
+        Symbol GetObject() const { return m_Object; }
+        Symbol GetProperty() const { return m_Property; }
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Identifier;
+        }
 
         const char *GetClassName() override {
             return "IdentifierExpression";
@@ -381,19 +539,26 @@ namespace Hunter::Compiler {
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Identifier Expression: " << GetVariableName() << std::endl;
+            std::cout << "Identifier Expression: " << GetVariableName() << '\n';
         }
 
     private:
-        std::string m_VariableName;
+        Symbol m_Variable;
+        Symbol m_Object;
+        Symbol m_Property;
     };
 
     class StructExpression : public BlockExpression {
     public:
-        StructExpression(std::string name) : m_StructName(std::move(name)) {}
-        std::string & GetStructName() { return m_StructName; }
+        StructExpression(Symbol name) : BlockExpression(ExpressionKind::Struct), m_Struct(name) {}
+        Symbol GetStruct() const { return m_Struct; }
+        std::string_view GetStructName() const { return m_Struct.GetName(); }
+
+        uint64_t GetPropertyIndex(Symbol property);
 
-        uint64_t GetPropertyIndex(const std::string & propertyName);
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Struct;
+        }
 
         const char *GetClassName() override {
             return "StructExpression";
@@ -401,33 +566,38 @@ namespace Hunter::Compiler {
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Struct Expression: " << GetStructName() << std::endl;
+            std::cout << "Struct Expression: " << GetStructName() << '\n';
 
-            std::cout << "Properties: " << std::endl;
+            std::cout << "Properties: " << '\n';
             for (const auto &property : GetBody()) {
                 property->Dump(level+1);
             }
         }
 
     private:
-        std::string m_StructName;
+        Symbol m_Struct;
     };
 
     class StructConstructionExpression : public Expression {
     public:
-        StructConstructionExpression(std::string name, std::vector<VariableMutationExpression *>  attributes)
-            : m_StructName(std::move(name)), m_StructAttributes(std::move(attributes)) {}
+        StructConstructionExpression(Symbol name, std::vector<VariableMutationExpression *>  attributes)
+            : Expression(ExpressionKind::StructConstruction), m_Struct(name), m_StructAttributes(std::move(attributes)) {}
 
-        std::string & GetStructName() { return m_StructName; }
+        Symbol GetStruct() const { return m_Struct; }
+        std::string_view GetStructName() const { return m_Struct.GetName(); }
         std::vector<VariableMutationExpression *> & GetAttributes() { return m_StructAttributes; }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::StructConstruction;
+        }
+
         const char *GetClassName() override {
             return "StructConstructionExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Struct Construct Expression: " << GetStructName() << std::endl;
+            std::cout << "Struct Construct Expression: " << GetStructName() << '\n';
 
             for (const auto &attribute : m_StructAttributes) {
                 attribute->Dump(level+1);
@@ -435,22 +605,26 @@ namespace Hunter::Compiler {
         }
 
     private:
-        std::string m_StructName;
+        Symbol m_Struct;
         std::vector<VariableMutationExpression *> m_StructAttributes;
     };
 
     class FunctionReturnExpression : public Expression {
     public:
-        FunctionReturnExpression(Expression * expr) : m_ReturnExpr(expr) {}
+        FunctionReturnExpression(Expression * expr) : Expression(ExpressionKind::FunctionReturn), m_ReturnExpr(expr) {}
         Expression * GetValue() { return m_ReturnExpr; }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::FunctionReturn;
+        }
+
         const char *GetClassName() override {
             return "FunctionReturnExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Function Return Expression: " << std::endl;
+            std::cout << "Function Return Expression: " << '\n';
             GetValue()->Dump(level+1);
         }
 
@@ -460,15 +634,23 @@ namespace Hunter::Compiler {
 
     class FunctionCallExpression : public Expression {
     public:
-        FunctionCallExpression(std::vector<Expression *> parameters) : m_Parameters(std::move(parameters)) {}
+        FunctionCallExpression(std::vector<Expression *> parameters) : Expression(ExpressionKind::FunctionCall), m_Parameters(std::move(parameters)) {}
         std::vector<Expression *> & GetParameters() { return m_Parameters; }
 
-        void SetFunctionName(const std::string &functionName) {
-            m_FunctionName = functionName;
+        void SetFunction(Symbol function) {
+            m_Function = function;
+        }
+
+        Symbol GetFunction() const {
+            return m_Function;
+        }
+
+        std::string_view GetFunctionName() const {
+            return m_Function.GetName();
         }
 
-        const std::string &GetFunctionName() const {
-            return m_FunctionName;
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::FunctionCall;
         }
 
         const char *GetClassName() override {
@@ -477,7 +659,7 @@ namespace Hunter::Compiler {
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Function call Expression: " << GetFunctionName() << std::endl;
+            std::cout << "Function call Expression: " << GetFunctionName() << '\n';
 
             for (const auto &parameter : m_Parameters) {
                 parameter->Dump(level+1);
@@ -485,41 +667,47 @@ namespace Hunter::Compiler {
         }
 
     private:
-        std::string m_FunctionName;
+        Symbol m_Function;
         std::vector<Expression *> m_Parameters;
     };
 
     class ParameterExpression : public Expression {
     public:
-        ParameterExpression(std::string name, DataType * dataType) : m_Name(std::move(name)), m_DataType(dataType) {}
+        ParameterExpression(Symbol name, DataType * dataType) : Expression(ExpressionKind::Parameter), m_Name(name), m_DataType(dataType) {}
 
-        std::string & GetName() { return m_Name; }
+        Symbol GetSymbol() const { return m_Name; }
+        std::string_view GetName() const { return m_Name.GetName(); }
 
         DataType * GetDataType() const {
             return m_DataType;
         }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Parameter;
+        }
+
         const char *GetClassName() override {
             return "ParameterExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "Parameter Expression: " << GetName() << " (" << GetDataTypeString(GetDataType()->GetId()) << ")" << std::endl;
+            std::cout << "Parameter Expression: " << GetName() << " (" << GetDataTypeString(GetDataType()->GetId()) << ")" << '\n';
         }
 
     private:
-        std::string m_Name;
+        Symbol m_Name;
         DataType * m_DataType;
     };
 
     class FunctionExpression : public BlockExpression {
     public:
-        FunctionExpression(std::string name, std::vector<ParameterExpression *>  params)
-            : m_Name(std::move(name)), m_Parameters(std::move(params)) {}
+        FunctionExpression(Symbol name, std::vector<ParameterExpression *>  params)
+            : BlockExpression(ExpressionKind::Function), m_Name(name), m_Parameters(std::move(params)) {}
 
-        void SetName(const std::string & name) { m_Name = name; }
-        std::string & GetName() { return m_Name; }
+        void SetSymbol(Symbol name) { m_Name = name; }
+        Symbol GetSymbol() const { return m_Name; }
+        std::string_view GetName() const { return m_Name.GetName(); }
 
         const std::vector<ParameterExpression *> &GetParameters() const {
             return m_Parameters;
@@ -541,6 +729,10 @@ namespace Hunter::Compiler {
             m_IsExternal = external;
         }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Function;
+        }
+
         const char *GetClassName() override {
             return "FunctionExpression";
         }
@@ -548,16 +740,16 @@ namespace Hunter::Compiler {
         void Dump(int level) override {
             DumpSpaces(level);
             std::string externalStr = m_IsExternal ? "extern " : "";
-            std::cout << "Function Expression: " << externalStr << GetName() << " : " << GetDataTypeString(GetReturnType()) << std::endl;
+            std::cout << "Function Expression: " << externalStr << GetName() << " : " << GetDataTypeString(GetReturnType()) << '\n';
 
             DumpSpaces(level+1);
-            std::cout << "Parameters:" << std::endl;
+            std::cout << "Parameters:" << '\n';
             for (const auto &subExpr : GetParameters()) {
                 subExpr->Dump(level+2);
             }
 
             DumpSpaces(level+1);
-            std::cout << "Body:" << std::endl;
+            std::cout << "Body:" << '\n';
             for (const auto &subExpr : GetBody()) {
                 subExpr->Dump(level+2);
             }
@@ -565,14 +757,14 @@ namespace Hunter::Compiler {
 
     private:
         bool m_IsExternal = false;
-        std::string m_Name;
+        Symbol m_Name;
         std::vector<ParameterExpression *> m_Parameters;
         DataTypeId m_ReturnType = DataTypeId::Void;
     };
 
     class ListExpression : public Expression {
     public:
-        ListExpression(DataTypeId dataType) : m_DataType(dataType) {}
+        ListExpression(DataTypeId dataType) : Expression(ExpressionKind::List), m_DataType(dataType) {}
 
         DataTypeId GetDataType() const {
             return m_DataType;
@@ -586,16 +778,20 @@ namespace Hunter::Compiler {
             m_Elements.push_back(expr);
         }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::List;
+        }
+
         const char *GetClassName() override {
             return "ListExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level);
-            std::cout << "List Expression: " << " (" << GetDataTypeString(GetDataType()) << ")" << std::endl;
+            std::cout << "List Expression: " << " (" << GetDataTypeString(GetDataType()) << ")" << '\n';
 
             DumpSpaces(level);
-            std::cout << "Elements:" << std::endl;
+            std::cout << "Elements:" << '\n';
             for (const auto &element : m_Elements) {
                 element->Dump(level+1);
             }
@@ -608,11 +804,16 @@ namespace Hunter::Compiler {
 
     class RangeExpression : public Expression {
     public:
-        RangeExpression(int64_t start, int64_t end) : m_Start(start), m_End(end), m_Variable(nullptr) {}
-        RangeExpression(IdentifierExpression * variable) :  m_Start(-1), m_End(-1), m_Variable(variable) {}
+        RangeExpression(int64_t start, int64_t end) : Expression(ExpressionKind::Range), m_Start(start), m_End(end), m_Variable(nullptr) {}
+        RangeExpression(IdentifierExpression * variable) :  Expression(ExpressionKind::Range), m_Start(-1), m_End(-1), m_Variable(variable) {}
 
         int64_t GetStart() const { return m_Start; }
         int64_t GetEnd() const { return m_End; }
+        IdentifierExpression * GetVariable() const { return m_Variable; }
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Range;
+        }
 
         const char *GetClassName() override {
             return "RangeExpression";
@@ -621,9 +822,9 @@ namespace Hunter::Compiler {
         void Dump(int level) override {
             DumpSpaces(level);
             if (!m_Variable) {
-                std::cout << "Range Expression: " << GetStart() << " - " << GetEnd() << std::endl;
+                std::cout << "Range Expression: " << GetStart() << " - " << GetEnd() << '\n';
             } else {
-                std::cout << "Range Expression: " << std::endl;
+                std::cout << "Range Expression: " << '\n';
                 m_Variable->Dump(level+1);
             }
         }
@@ -636,16 +837,22 @@ namespace Hunter::Compiler {
 
     class ElseExpression : public BlockExpression {
     public:
+        ElseExpression() : BlockExpression(ExpressionKind::Else) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::Else;
+        }
+
         const char *GetClassName() override {
             return "ElseExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level+1);
-            std::cout << "Else Expression: " << std::endl;
+            std::cout << "Else Expression: " << '\n';
 
             DumpSpaces(level+1);
-            std::cout << "  Body: " << std::endl;
+            std::cout << "  Body: " << '\n';
             for (const auto &subExpr : GetBody()) {
                 subExpr->Dump(level+3);
             }
@@ -654,23 +861,27 @@ namespace Hunter::Compiler {
 
     class IfExpression : public BlockExpression {
     public:
-        IfExpression(Expression * condition) : m_Condition(condition) {}
+        IfExpression(Expression * condition) : BlockExpression(ExpressionKind::If), m_Condition(condition) {}
         Expression * GetCondition() { return m_Condition; }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::If;
+        }
+
         const char *GetClassName() override {
             return "IfExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level+1);
-            std::cout << "If Expression: " << std::endl;
+            std::cout << "If Expression: " << '\n';
 
             DumpSpaces(level+1);
-            std::cout << "  Condition: " << std::endl;
+            std::cout << "  Condition: " << '\n';
             GetCondition()->Dump(level+3);
 
             DumpSpaces(level+1);
-            std::cout << "  Body: " << std::endl;
+            std::cout << "  Body: " << '\n';
             for (const auto &subExpr : GetBody()) {
                 subExpr->Dump(level+3);
             }
@@ -690,28 +901,32 @@ namespace Hunter::Compiler {
 
     private:
         Expression * m_Condition;
-        ElseExpression * m_Else;
+        ElseExpression * m_Else = nullptr;
     };
 
     class WhileExpression : public BlockExpression {
     public:
-        WhileExpression(Expression * condition) : m_Condition(condition) {}
+        WhileExpression(Expression * condition) : BlockExpression(ExpressionKind::While), m_Condition(condition) {}
         Expression * GetCondition() { return m_Condition; }
 
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::While;
+        }
+
         const char *GetClassName() override {
             return "WhileExpression";
         }
 
         void Dump(int level) override {
             DumpSpaces(level+1);
-            std::cout << "While Expression: " << std::endl;
+            std::cout << "While Expression: " << '\n';
 
             DumpSpaces(level+1);
-            std::cout << "  Condition: " << std::endl;
+            std::cout << "  Condition: " << '\n';
             GetCondition()->Dump(level+3);
 
             DumpSpaces(level+1);
-            std::cout << "  Body: " << std::endl;
+            std::cout << "  Body: " << '\n';
             for (const auto &subExpr : GetBody()) {
                 subExpr->Dump(level+3);
             }
@@ -723,8 +938,12 @@ namespace Hunter::Compiler {
 
     class ForLoopExpression : public BlockExpression {
     public:
-        ForLoopExpression(std::string counterIdentifier, Expression * range)
-            : m_CounterIdentifier(std::move(counterIdentifier)), m_Range(range) {}
+        ForLoopExpression(Symbol counter, Expression * range)
+            : BlockExpression(ExpressionKind::ForLoop), m_Counter(counter), m_Range(range) {}
+
+        static bool classof(const Expression * expr) {
+            return expr->GetKind() == ExpressionKind::ForLoop;
+        }
 
         const char *GetClassName() override {
             return "ForLoopExpression";
@@ -732,17 +951,17 @@ namespace Hunter::Compiler {
 
         void Dump(int level) override {
             DumpSpaces(level+1);
-            std::cout << "For loop Expression: " << std::endl;
+            std::cout << "For loop Expression: " << '\n';
 
             DumpSpaces(level+1);
-            std::cout << "  Counter: " << GetCounter() << std::endl;
+            std::cout << "  Counter: " << GetCounterName() << '\n';
 
             DumpSpaces(level+1);
-            std::cout << "  Range: " << std::endl;
+            std::cout << "  Range: " << '\n';
             GetRange()->Dump(level + 3);
 
             DumpSpaces(level+1);
-            std::cout << "  Body: " << std::endl;
+            std::cout << "  Body: " << '\n';
             for (const auto &subExpr : GetBody()) {
                 subExpr->Dump(level+3);
             }
@@ -752,12 +971,16 @@ namespace Hunter::Compiler {
             return m_Range;
         }
 
-        std::string & GetCounter() {
-            return m_CounterIdentifier;
+        Symbol GetCounter() const {
+            return m_Counter;
+        }
+
+        std::string_view GetCounterName() const {
+            return m_Counter.GetName();
         }
 
     private:
-        std::string m_CounterIdentifier;
+        Symbol m_Counter;
         Expression * m_Range;
     };
 }
\ No newline at end of file
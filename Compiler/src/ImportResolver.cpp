@@ -1,22 +1,133 @@
 #include "ImportResolver.h"
+#include "AstSerializer.h"
+#include "CompilationCache.h"
 #include "Expressions.h"
+#include "ModuleTreeCache.h"
+#include "SourceManager.h"
+#include "ThreadPool.h"
 #include "./utils/logger.h"
 #include "./utils/strings.h"
 
+#include <cctype>
+
+#include <llvm/Support/TimeProfiler.h>
+
 namespace Hunter::Compiler {
 
-    void ImportResolver::ResolveImports(const std::string & basePath, AbstractSyntaxTree *tree, std::vector<Expression *> & instructions) {
+    std::string ImportResolver::GetModuleFilePath(const std::string & basePath, std::string module) {
+        replaceAll(module, ".", "/");
+        return basePath + "/" + module + ".hunt";
+    }
+
+    std::vector<std::string_view> ImportResolver::FindImportedModules(std::string_view source) {
+        std::vector<std::string_view> modules;
+        size_t lineStart = 0;
+
+        while (lineStart < source.size()) {
+            size_t lineEnd = source.find('\n', lineStart);
+
+            if (lineEnd == std::string_view::npos) {
+                lineEnd = source.size();
+            }
+
+            std::string_view line = source.substr(lineStart, lineEnd - lineStart);
+            size_t keywordStart = line.find_first_not_of(" \t");
+
+            if (keywordStart != std::string_view::npos && line.substr(keywordStart).starts_with("import")) {
+                std::string_view rest = line.substr(keywordStart + 6);
+                size_t moduleStart = rest.find_first_not_of(" \t");
+
+                // the keyword has to be followed by whitespace, otherwise it is just an identifier starting with import
+                if (moduleStart != 0 && moduleStart != std::string_view::npos) {
+                    size_t moduleEnd = moduleStart;
+
+                    while (moduleEnd < rest.size() && (isalnum(rest[moduleEnd]) || rest[moduleEnd] == '_' || rest[moduleEnd] == '.')) {
+                        moduleEnd += 1;
+                    }
+
+                    if (moduleEnd > moduleStart) {
+                        modules.push_back(rest.substr(moduleStart, moduleEnd - moduleStart));
+                    }
+                }
+            }
+
+            lineStart = lineEnd + 1;
+        }
+
+        return modules;
+    }
+
+    void ImportResolver::ResolveImports(const std::string & basePath, AbstractSyntaxTree *tree, std::vector<Expression *> & instructions, std::vector<CompilationUnit> & units) {
+        llvm::TimeTraceScope timeScope("ResolveImports");
+        // the parsed modules are kept for the next program, but every program imports each of them once
+        m_Modules.clear();
+        ParseImportedModules(basePath, tree);
+
+        units.push_back({.IsMain = true});
+        AppendInstructions(basePath, tree, instructions, units);
+    }
+
+    void ImportResolver::ParseImportedModules(const std::string &basePath, AbstractSyntaxTree *tree) {
+        std::vector<std::string> imports;
+
+        for (const auto &instruction : tree->GetInstructions()) {
+            if (auto * importExpr = DynCast<ImportExpression>(instruction)) {
+                imports.emplace_back(importExpr->GetModule());
+            }
+        }
+
+        if (imports.empty()) {
+            return;
+        }
+
+        ThreadPool pool;
+
+        for (auto &module : imports) {
+            ScheduleModule(pool, basePath, std::move(module));
+        }
+
+        pool.Wait();
+    }
+
+    void ImportResolver::ScheduleModule(ThreadPool &pool, const std::string &basePath, const std::string &module) {
+        std::string moduleFilePath = GetModuleFilePath(basePath, module);
+
+        {
+            std::lock_guard lock(m_Mutex);
+
+            if (!m_ScheduledModules.insert(moduleFilePath).second) {
+                return;
+            }
+        }
+
+        pool.Submit([this, &pool, &basePath, moduleFilePath = std::move(moduleFilePath)]() {
+            // the import lines are enough to find the next modules, so they are scheduled before this one is parsed
+            for (const auto &importedModule : FindImportedModules(m_SourceManager.LoadFile(moduleFilePath))) {
+                ScheduleModule(pool, basePath, std::string(importedModule));
+            }
+
+            std::unique_ptr<AbstractSyntaxTree> ast(ParseModuleFile(moduleFilePath));
+
+            std::lock_guard lock(m_Mutex);
+            m_ParsedModules[moduleFilePath] = std::move(ast);
+        });
+    }
+
+    void ImportResolver::AppendInstructions(const std::string &basePath, AbstractSyntaxTree *tree, std::vector<Expression *> &instructions, std::vector<CompilationUnit> &units) {
         auto treeInstructions = tree->GetInstructions();
         std::string currentModule = "";
+        // the vector grows with every import, so the unit is only accessed by index
+        size_t unitIndex = units.size() - 1;
 
         for (int i = 0; i < treeInstructions.size(); ++i) {
             Expression * instruction = treeInstructions.at(i);
 
-            if (auto * moduleExpr = dynamic_cast<ModuleExpression *>(instruction)) {
+            if (auto * moduleExpr = DynCast<ModuleExpression>(instruction)) {
                 currentModule = moduleExpr->GetModule();
+                units[unitIndex].Module = currentModule;
                 COMPILER_INFO("Current module: \"{0}\"", currentModule);
-            } else if (auto * importExpr = dynamic_cast<ImportExpression *>(instruction)) {
-                std::string module = importExpr->GetModule();
+            } else if (auto * importExpr = DynCast<ImportExpression>(instruction)) {
+                std::string module(importExpr->GetModule());
                 if (HasModule(module)) {
                     continue;
                 }
@@ -24,23 +135,83 @@ namespace Hunter::Compiler {
                 AddModule(module);
                 COMPILER_INFO("Import module: \"{0}\"", module);
 
-                Parser parser;
-                replaceAll(module, ".", "/");
-                std::string moduleFilePath = basePath + "/" + module + ".hunt";
-                AbstractSyntaxTree * ast = parser.Parse(moduleFilePath);
-                ResolveImports(basePath, ast, instructions);
+                units.emplace_back();
+                AppendInstructions(basePath, GetParsedModule(basePath, module), instructions, units);
             } else {
                 instructions.push_back(instruction);
+                units[unitIndex].Instructions.push_back(instruction);
             }
         }
 
-        if (!currentModule.empty()) {
+        // the trees of modules are shared by all programs of a batch, their functions are only qualified once
+        if (!currentModule.empty() && m_QualifiedTrees.insert(tree).second) {
+            SymbolTable & symbols = m_SourceManager.GetSymbols();
+            std::string qualifiedName;
+
             for (const auto &instruction : treeInstructions) {
-                if (auto * funcExpr = dynamic_cast<FunctionExpression *>(instruction)) {
-                    funcExpr->SetName(currentModule + "." + funcExpr->GetName());
+                if (auto * funcExpr = DynCast<FunctionExpression>(instruction)) {
+                    qualifiedName.assign(currentModule).append(".").append(funcExpr->GetName());
+                    funcExpr->SetSymbol(symbols.Intern(qualifiedName));
+                }
+            }
+        }
+    }
+
+    AbstractSyntaxTree * ImportResolver::GetParsedModule(const std::string &basePath, const std::string &module) {
+        std::string moduleFilePath = GetModuleFilePath(basePath, module);
+        auto & ast = m_ParsedModules[moduleFilePath];
+
+        // only happens for imports the line scan could not see
+        if (!ast) {
+            ast.reset(ParseModuleFile(moduleFilePath));
+        }
+
+        return ast.get();
+    }
+
+    AbstractSyntaxTree * ImportResolver::ParseModuleFile(const std::string &filePath) {
+        std::string_view source = m_SourceManager.LoadFile(filePath);
+
+        if (m_TreeCache) {
+            if (std::string_view treeData = m_TreeCache->Find(filePath, source); !treeData.empty()) {
+                if (auto * tree = AstReader::Load(m_SourceManager, treeData, filePath)) {
+                    COMPILER_INFO("Loaded tree of \"{0}\" from the compile server", filePath);
+                    return tree;
                 }
+
+                // the tree reported below replaces it on the server
+                COMPILER_WARN("Could not use the tree of \"{0}\" kept by the compile server, parsing it again", filePath);
             }
         }
+
+        AbstractSyntaxTree * tree = nullptr;
+        std::string treeFilePath;
+
+        if (m_Cache) {
+            treeFilePath = m_Cache->GetTreeFilePath(filePath, source);
+
+            if ((tree = AstReader::Load(m_SourceManager, treeFilePath))) {
+                COMPILER_INFO("Loaded serialized tree of \"{0}\"", filePath);
+            } else if (m_Cache->EvictTree(treeFilePath)) {
+                COMPILER_WARN("Could not use the serialized tree of \"{0}\", parsing it again", filePath);
+            }
+        }
+
+        if (!tree) {
+            // all parsers share the sources, so every module file is only mapped once per compilation
+            Parser parser(m_SourceManager);
+            tree = parser.Parse(filePath);
+
+            if (m_Cache) {
+                AstWriter::Write(tree, treeFilePath);
+            }
+        }
+
+        if (m_TreeCache) {
+            m_TreeCache->Report(filePath, source, AstWriter::Serialize(tree));
+        }
+
+        return tree;
     }
 
-}
\ No newline at end of file
+}
@@ -1,10 +1,49 @@
+#pragma once
+
 #include "Parser.h"
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace Hunter::Compiler {
 
+    class CompilationCache;
+    class ModuleTreeCache;
+    class SourceManager;
+    class ThreadPool;
+
+    /**
+     * Instructions of a single source file. Every unit is generated into its own LLVM module,
+     * so modules can be compiled at the same time and only reference each other by name.
+     */
+    struct CompilationUnit {
+        // empty for a main file without module declaration
+        std::string Module;
+        bool IsMain = false;
+        std::vector<Expression *> Instructions;
+    };
+
     class ImportResolver {
     public:
-        void ResolveImports(const std::string & basePath, AbstractSyntaxTree * tree, std::vector<Expression *> & instructions);
+        explicit ImportResolver(SourceManager & sourceManager) : m_SourceManager(sourceManager) {}
+
+        /**
+         * instructions gets all of them in one list, units the same instructions split up by source file with the main file first.
+         * Can be called for several programs, modules they share are only parsed once.
+         */
+        void ResolveImports(const std::string & basePath, AbstractSyntaxTree * tree, std::vector<Expression *> & instructions, std::vector<CompilationUnit> & units);
+
+        // unchanged modules are loaded from the serialized trees in the cache instead of being parsed again
+        void SetCache(CompilationCache * cache) {
+            m_Cache = cache;
+        }
+
+        // trees kept in memory by the compile server, they are used before the ones on disk
+        void SetTreeCache(ModuleTreeCache * treeCache) {
+            m_TreeCache = treeCache;
+        }
 
         void AddModule(const std::string & module) {
             m_Modules.push_back(module);
@@ -24,8 +63,33 @@ namespace Hunter::Compiler {
             return false;
         }
 
+        static std::string GetModuleFilePath(const std::string & basePath, std::string module);
+
+        // finds the imported modules of a source by looking only at its import lines, without parsing it
+        static std::vector<std::string_view> FindImportedModules(std::string_view source);
+
+    protected:
+        // parses every module reachable from the tree at the same time
+        void ParseImportedModules(const std::string & basePath, AbstractSyntaxTree * tree);
+        void ScheduleModule(ThreadPool & pool, const std::string & basePath, const std::string & module);
+
+        // walks the parsed modules depth first, so the instruction order does not depend on the parse order
+        void AppendInstructions(const std::string & basePath, AbstractSyntaxTree * tree, std::vector<Expression *> & instructions, std::vector<CompilationUnit> & units);
+        AbstractSyntaxTree * GetParsedModule(const std::string & basePath, const std::string & module);
+        AbstractSyntaxTree * ParseModuleFile(const std::string & filePath);
+
     private:
+        SourceManager & m_SourceManager;
+        CompilationCache * m_Cache = nullptr;
+        ModuleTreeCache * m_TreeCache = nullptr;
         std::vector<std::string> m_Modules;
+
+        std::mutex m_Mutex;
+        // keyed by the file path, programs of a batch in other directories can have other modules of the same name
+        std::unordered_set<std::string> m_ScheduledModules;
+        // the resolved instructions point into the arenas of these trees
+        std::unordered_map<std::string, std::unique_ptr<AbstractSyntaxTree>> m_ParsedModules;
+        std::unordered_set<AbstractSyntaxTree *> m_QualifiedTrees;
     };
 
-}
\ No newline at end of file
+}
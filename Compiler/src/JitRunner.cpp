@@ -0,0 +1,421 @@
+#include "JitRunner.h"
+#include "./utils/logger.h"
+#include "../runtime/hunter_rt.h"
+
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/IR/DebugInfo.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+namespace Hunter::Compiler {
+
+    // called by the baseline code once a function reached the threshold
+    constexpr const char * TierUpFunctionName = "__hunter_tier_up";
+    // marks the modules of the optimized tier, so they are compiled with the optimizing target machine
+    constexpr const char * OptimizedTierFlag = "hunter.optimized-tier";
+
+    /**
+     * Uses a separate target machine for the modules of the optimized tier, a single JIT
+     * only knows one code generation level otherwise.
+     */
+    class TieredCompiler : public llvm::orc::IRCompileLayer::IRCompiler {
+    public:
+        TieredCompiler(std::unique_ptr<llvm::TargetMachine> baselineMachine, std::unique_ptr<llvm::TargetMachine> optimizingMachine)
+            : IRCompiler(llvm::orc::irManglingOptionsFromTargetOptions(baselineMachine->Options)),
+              m_BaselineMachine(std::move(baselineMachine)),
+              m_OptimizingMachine(std::move(optimizingMachine)),
+              m_BaselineCompiler(*m_BaselineMachine),
+              m_OptimizingCompiler(*m_OptimizingMachine) {}
+
+        llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(llvm::Module & module) override {
+            if (module.getModuleFlag(OptimizedTierFlag)) {
+                return m_OptimizingCompiler(module);
+            }
+
+            return m_BaselineCompiler(module);
+        }
+
+    private:
+        std::unique_ptr<llvm::TargetMachine> m_BaselineMachine;
+        std::unique_ptr<llvm::TargetMachine> m_OptimizingMachine;
+        llvm::orc::SimpleCompiler m_BaselineCompiler;
+        llvm::orc::SimpleCompiler m_OptimizingCompiler;
+    };
+
+    /**
+     * Moves the code of the function to a new name and leaves a declaration under the old one,
+     * which is resolved to the stub of the function. Every call, recursive ones included, goes through the stub then.
+     */
+    static llvm::Function * SplitOffBody(llvm::Function * function, const std::string & suffix) {
+        std::string name = function->getName().str();
+        function->setName(name + suffix);
+
+        llvm::Function * declaration = llvm::Function::Create(
+                function->getFunctionType(),
+                llvm::Function::ExternalLinkage,
+                name,
+                function->getParent()
+        );
+
+        function->replaceAllUsesWith(declaration);
+        function->setLinkage(llvm::Function::ExternalLinkage);
+
+        return function;
+    }
+
+    static void InsertCallCounter(llvm::Function * function, llvm::FunctionCallee tierUp, llvm::Value * runner, uint64_t functionIndex, uint64_t threshold) {
+        llvm::LLVMContext & context = function->getContext();
+        auto * counterType = llvm::Type::getInt64Ty(context);
+        auto * counter = new llvm::GlobalVariable(
+                *function->getParent(),
+                counterType,
+                false,
+                llvm::GlobalValue::InternalLinkage,
+                llvm::ConstantInt::get(counterType, 0),
+                function->getName() + ".calls"
+        );
+
+        llvm::BasicBlock * body = &function->getEntryBlock();
+        auto * checkBlock = llvm::BasicBlock::Create(context, "tierup.check", function, body);
+        auto * requestBlock = llvm::BasicBlock::Create(context, "tierup.request", function, body);
+
+        // the function can be called from several threads, the request still has to happen exactly once
+        llvm::IRBuilder<> builder(checkBlock);
+        auto * calls = builder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, counter, builder.getInt64(1), llvm::MaybeAlign(8), llvm::AtomicOrdering::Monotonic);
+        builder.CreateCondBr(builder.CreateICmpEQ(calls, builder.getInt64(threshold - 1)), requestBlock, body);
+
+        builder.SetInsertPoint(requestBlock);
+        builder.CreateCall(tierUp, {runner, builder.getInt64(functionIndex)});
+        builder.CreateBr(body);
+    }
+
+    JitRunner::JitRunner(const TargetSettings & target, uint64_t tierUpThreshold) : m_Target(target), m_TierUpThreshold(tierUpThreshold) {
+        static std::once_flag targetsInitialized;
+        std::call_once(targetsInitialized, []() {
+            llvm::InitializeNativeTarget();
+            llvm::InitializeNativeTargetAsmPrinter();
+        });
+
+        // the code runs right here, so the target is always this machine, only the CPU can be chosen
+        auto targetMachineBuilder = llvm::orc::JITTargetMachineBuilder::detectHost();
+
+        if (!targetMachineBuilder) {
+            COMPILER_ERROR("Could not detect the host target: {0}", llvm::toString(targetMachineBuilder.takeError()));
+            return;
+        }
+
+        if (m_Target.CPU != "generic") {
+            targetMachineBuilder->setCPU(m_Target.CPU);
+        }
+
+        if (!m_Target.Features.empty()) {
+            targetMachineBuilder->addFeatures({m_Target.Features});
+        }
+
+        // with tiering the first compilation has to be fast, the optimized tier has its own target machine
+        targetMachineBuilder->setCodeGenOptLevel(m_TierUpThreshold > 0 ? llvm::CodeGenOpt::None : GetCodeGenLevel(m_Target.Optimization));
+        m_Target.Triple = targetMachineBuilder->getTargetTriple().str();
+
+        llvm::orc::LLJITBuilder jitBuilder;
+        jitBuilder.setJITTargetMachineBuilder(*targetMachineBuilder);
+
+        if (m_TierUpThreshold > 0) {
+            llvm::orc::JITTargetMachineBuilder optimizingBuilder = *targetMachineBuilder;
+            optimizingBuilder.setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+
+            auto optimizingMachine = optimizingBuilder.createTargetMachine();
+
+            if (!optimizingMachine) {
+                COMPILER_ERROR("Could not create the target machine of the optimized tier: {0}", llvm::toString(optimizingMachine.takeError()));
+                return;
+            }
+
+            m_OptimizingMachine = std::move(*optimizingMachine);
+
+            jitBuilder.setCompileFunctionCreator(
+                [optimizingBuilder](llvm::orc::JITTargetMachineBuilder baselineBuilder) mutable -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+                    auto baselineMachine = baselineBuilder.createTargetMachine();
+
+                    if (!baselineMachine) {
+                        return baselineMachine.takeError();
+                    }
+
+                    auto optimizingMachine = optimizingBuilder.createTargetMachine();
+
+                    if (!optimizingMachine) {
+                        return optimizingMachine.takeError();
+                    }
+
+                    return std::make_unique<TieredCompiler>(std::move(*baselineMachine), std::move(*optimizingMachine));
+                }
+            );
+        }
+
+        auto jit = jitBuilder.create();
+
+        if (!jit) {
+            COMPILER_ERROR("Could not create the JIT: {0}", llvm::toString(jit.takeError()));
+            return;
+        }
+
+        m_Jit = std::move(*jit);
+
+        auto processSymbols = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(m_Jit->getDataLayout().getGlobalPrefix());
+
+        if (!processSymbols) {
+            COMPILER_ERROR("Could not load the symbols of the process: {0}", llvm::toString(processSymbols.takeError()));
+            m_Jit.reset();
+            return;
+        }
+
+        m_Jit->getMainJITDylib().addGenerator(std::move(*processSymbols));
+
+        // the runtime is linked into the compiler, its symbols are not exported by the process.
+        // its bitcode is not linked into the jitted modules, they would need the thread local state of the compiler
+        llvm::orc::SymbolMap runtimeSymbols;
+        for (const auto &[name, address] : std::initializer_list<std::pair<const char *, void *>>{
+            {"hunter_rt_alloc", reinterpret_cast<void *>(&hunter_rt_alloc)},
+            {"hunter_rt_free", reinterpret_cast<void *>(&hunter_rt_free)},
+            {"hunter_rt_string_equals", reinterpret_cast<void *>(&hunter_rt_string_equals)},
+            {"hunter_rt_string_length", reinterpret_cast<void *>(&hunter_rt_string_length)},
+            {"hunter_rt_list_new", reinterpret_cast<void *>(&hunter_rt_list_new)},
+            {"hunter_rt_list_copy", reinterpret_cast<void *>(&hunter_rt_list_copy)},
+            {"hunter_rt_write", reinterpret_cast<void *>(&hunter_rt_write)},
+            {"hunter_rt_write_string", reinterpret_cast<void *>(&hunter_rt_write_string)},
+            {"hunter_rt_write_i32", reinterpret_cast<void *>(&hunter_rt_write_i32)},
+            {"hunter_rt_write_i64", reinterpret_cast<void *>(&hunter_rt_write_i64)},
+            {"hunter_rt_flush", reinterpret_cast<void *>(&hunter_rt_flush)},
+        }) {
+            runtimeSymbols[m_Jit->mangleAndIntern(name)] = llvm::JITEvaluatedSymbol(llvm::pointerToJITTargetAddress(address), llvm::JITSymbolFlags::Exported);
+        }
+        llvm::cantFail(m_Jit->getMainJITDylib().define(llvm::orc::absoluteSymbols(std::move(runtimeSymbols))));
+
+        if (m_TierUpThreshold > 0) {
+            auto stubsBuilder = llvm::orc::createLocalIndirectStubsManagerBuilder(targetMachineBuilder->getTargetTriple());
+
+            if (!stubsBuilder) {
+                COMPILER_ERROR("Tiering is not supported for target {0}", m_Target.Triple);
+                m_Jit.reset();
+                return;
+            }
+
+            m_Stubs = stubsBuilder();
+
+            llvm::JITEvaluatedSymbol tierUpSymbol(llvm::pointerToJITTargetAddress(&JitRunner::RequestTierUp), llvm::JITSymbolFlags::Exported);
+            llvm::cantFail(m_Jit->getMainJITDylib().define(llvm::orc::absoluteSymbols({{m_Jit->mangleAndIntern(TierUpFunctionName), tierUpSymbol}})));
+
+            m_TierUpThread = std::make_unique<ThreadPool>(1);
+        } else if (m_Target.Optimization != OptimizationLevel::O0 || !m_Target.ProfileUse.empty()) {
+            m_Jit->getIRTransformLayer().setTransform(
+                [this, targetMachineBuilder = *targetMachineBuilder](llvm::orc::ThreadSafeModule module, const llvm::orc::MaterializationResponsibility &) mutable -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+                    auto targetMachine = targetMachineBuilder.createTargetMachine();
+
+                    if (!targetMachine) {
+                        return targetMachine.takeError();
+                    }
+
+                    module.withModuleDo([&](llvm::Module & irModule) {
+                        OptimizeModule(&irModule, targetMachine->get(), m_Target.Optimization, false, GetProfileOptions(m_Target));
+                    });
+
+                    return std::move(module);
+                }
+            );
+        }
+    }
+
+    JitRunner::~JitRunner() {
+        // requests which are still queued are not worth compiling anymore
+        m_IsStopping = true;
+        m_TierUpThread.reset();
+    }
+
+    bool JitRunner::AddModule(llvm::orc::ThreadSafeModule module) {
+        if (!m_Jit) {
+            return false;
+        }
+
+        module.withModuleDo([&](llvm::Module & irModule) {
+            irModule.setTargetTriple(m_Target.Triple);
+            irModule.setDataLayout(m_Jit->getDataLayout());
+        });
+
+        if (m_TierUpThreshold > 0) {
+            return AddTieredModule(std::move(module));
+        }
+
+        if (auto error = m_Jit->addIRModule(std::move(module))) {
+            COMPILER_ERROR("Could not add the module to the JIT: {0}", llvm::toString(std::move(error)));
+            return false;
+        }
+
+        return true;
+    }
+
+    bool JitRunner::AddTieredModule(llvm::orc::ThreadSafeModule module) {
+        size_t moduleIndex = m_SourceModules.size();
+        std::vector<std::string> functionNames;
+
+        // the baseline is a copy, the optimized tier is later cloned from the untouched module
+        llvm::orc::ThreadSafeModule baseline = module.withModuleDo([&](llvm::Module & sourceModule) {
+            std::unique_ptr<llvm::Module> baselineModule = llvm::CloneModule(sourceModule);
+            llvm::LLVMContext & context = baselineModule->getContext();
+
+            llvm::FunctionCallee tierUp = baselineModule->getOrInsertFunction(
+                    TierUpFunctionName,
+                    llvm::Type::getVoidTy(context),
+                    llvm::Type::getInt8PtrTy(context),
+                    llvm::Type::getInt64Ty(context)
+            );
+
+            auto * runner = llvm::ConstantExpr::getIntToPtr(
+                    llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), reinterpret_cast<uintptr_t>(this)),
+                    llvm::Type::getInt8PtrTy(context)
+            );
+
+            // collected first, splitting adds declarations to the module
+            std::vector<llvm::Function *> functions;
+
+            for (auto &function : *baselineModule) {
+                // main is only called once, there is nothing to gain
+                if (!function.isDeclaration() && function.getName() != "main") {
+                    functions.push_back(&function);
+                }
+            }
+
+            for (auto * function : functions) {
+                functionNames.push_back(function->getName().str());
+                m_TieredFunctions.push_back({.Name = functionNames.back(), .ModuleIndex = moduleIndex});
+
+                InsertCallCounter(SplitOffBody(function, "$tier0"), tierUp, runner, m_TieredFunctions.size() - 1, m_TierUpThreshold);
+            }
+
+            return llvm::orc::ThreadSafeModule(std::move(baselineModule), module.getContext());
+        });
+
+        m_SourceModules.push_back(std::move(module));
+
+        // the stubs point nowhere until the baseline is compiled in Run
+        for (const auto &name : functionNames) {
+            if (auto error = m_Stubs->createStub(name, 0, llvm::JITSymbolFlags::Exported)) {
+                COMPILER_ERROR("Could not create the stub of {0}: {1}", name, llvm::toString(std::move(error)));
+                return false;
+            }
+
+            llvm::orc::SymbolMap stubSymbol = {{m_Jit->mangleAndIntern(name), m_Stubs->findStub(name, true)}};
+
+            if (auto error = m_Jit->getMainJITDylib().define(llvm::orc::absoluteSymbols(std::move(stubSymbol)))) {
+                COMPILER_ERROR("Could not define the stub of {0}: {1}", name, llvm::toString(std::move(error)));
+                return false;
+            }
+        }
+
+        if (auto error = m_Jit->addIRModule(std::move(baseline))) {
+            COMPILER_ERROR("Could not add the module to the JIT: {0}", llvm::toString(std::move(error)));
+            return false;
+        }
+
+        return true;
+    }
+
+    void JitRunner::RequestTierUp(JitRunner * runner, uint64_t functionIndex) {
+        // called from the running program, the compilation must not block it
+        runner->m_TierUpThread->Submit([runner, functionIndex]() {
+            runner->TierUp(functionIndex);
+        });
+    }
+
+    void JitRunner::TierUp(size_t functionIndex) {
+        if (m_IsStopping) {
+            return;
+        }
+
+        const TieredFunction & function = m_TieredFunctions[functionIndex];
+        llvm::TimeTraceScope timeScope("TierUp", function.Name);
+        llvm::orc::ThreadSafeModule & source = m_SourceModules[function.ModuleIndex];
+        std::string optimizedName = function.Name + "$tier1";
+
+        llvm::orc::ThreadSafeModule optimized = source.withModuleDo([&](llvm::Module & sourceModule) {
+            std::unique_ptr<llvm::Module> module = llvm::CloneModule(sourceModule);
+            module->addModuleFlag(llvm::Module::Warning, OptimizedTierFlag, 1);
+
+            for (auto &other : *module) {
+                if (other.isDeclaration() || other.getName() == function.Name) {
+                    continue;
+                }
+
+                if (other.getName() == "main") {
+                    other.deleteBody();
+                } else {
+                    // the other functions can still be inlined, the calls which remain go through their stubs
+                    other.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+                }
+            }
+
+            SplitOffBody(module->getFunction(function.Name), "$tier1");
+
+            // the locations of the code generator do not pass the verifier yet, which would keep the module from being optimized
+            llvm::StripDebugInfo(*module);
+            OptimizeModule(module.get(), m_OptimizingMachine.get(), OptimizationLevel::O3);
+
+            return llvm::orc::ThreadSafeModule(std::move(module), source.getContext());
+        });
+
+        if (auto error = m_Jit->addIRModule(std::move(optimized))) {
+            COMPILER_WARN("Could not add the optimized version of {0}: {1}", function.Name, llvm::toString(std::move(error)));
+            return;
+        }
+
+        auto optimizedSymbol = m_Jit->lookup(optimizedName);
+
+        if (!optimizedSymbol) {
+            COMPILER_WARN("Could not compile the optimized version of {0}: {1}", function.Name, llvm::toString(optimizedSymbol.takeError()));
+            return;
+        }
+
+        // a single pointer store, calls which are already running simply finish in the baseline code
+        if (auto error = m_Stubs->updatePointer(function.Name, optimizedSymbol->getAddress())) {
+            COMPILER_WARN("Could not switch {0} to the optimized version: {1}", function.Name, llvm::toString(std::move(error)));
+            return;
+        }
+
+        COMPILER_DEBUG("Switched {0} to the optimized version", function.Name);
+    }
+
+    int JitRunner::Run() {
+        if (!m_Jit) {
+            return -1;
+        }
+
+        for (const auto &function : m_TieredFunctions) {
+            auto baselineSymbol = m_Jit->lookup(function.Name + "$tier0");
+
+            if (!baselineSymbol) {
+                COMPILER_ERROR("Could not compile {0}: {1}", function.Name, llvm::toString(baselineSymbol.takeError()));
+                return -1;
+            }
+
+            llvm::cantFail(m_Stubs->updatePointer(function.Name, baselineSymbol->getAddress()));
+        }
+
+        auto mainSymbol = m_Jit->lookup("main");
+
+        if (!mainSymbol) {
+            COMPILER_ERROR("Could not find the main function: {0}", llvm::toString(mainSymbol.takeError()));
+            return -1;
+        }
+
+        auto * mainFunction = reinterpret_cast<int (*)()>(mainSymbol->getAddress());
+        int exitCode = mainFunction();
+        m_IsStopping = true;
+
+        // the program writes through the buffers of this process, which are only flushed at exit otherwise
+        hunter_rt_flush();
+        fflush(stdout);
+
+        return exitCode;
+    }
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Compiler.h"
+#include "ThreadPool.h"
+
+#include <llvm/ExecutionEngine/Orc/IndirectionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Hunter::Compiler {
+
+    /**
+     * Compiles the modules of a program in memory and runs it inside the compiler process.
+     * Symbols which are not defined by a module, like printf or the functions of extern
+     * declarations, are resolved against the libraries already loaded into the process.
+     *
+     * With tiering, every function is first compiled without optimizations and called through
+     * an indirect stub. Once a function was called often enough, it is optimized with -O3 on a
+     * background thread and the stub is pointed to the new code, while the program keeps running.
+     */
+    class JitRunner {
+    public:
+        static constexpr uint64_t DefaultTierUpThreshold = 1000;
+
+        // a threshold of 0 turns tiering off, the target optimization level is used for everything then
+        explicit JitRunner(const TargetSettings & target = {}, uint64_t tierUpThreshold = 0);
+        ~JitRunner();
+
+        // returns false if the JIT could not be created for the target or the module could not be added
+        bool AddModule(llvm::orc::ThreadSafeModule module);
+
+        // calls the main function of the program and returns its exit code, -1 if it does not exist
+        int Run();
+
+    protected:
+        bool AddTieredModule(llvm::orc::ThreadSafeModule module);
+        // compiles the optimized version of a function, runs on the tier up thread
+        void TierUp(size_t functionIndex);
+
+        static void RequestTierUp(JitRunner * runner, uint64_t functionIndex);
+
+    private:
+        struct TieredFunction {
+            std::string Name;
+            // the unmodified module the function comes from, the optimized version is cloned from it
+            size_t ModuleIndex;
+        };
+
+        TargetSettings m_Target;
+        uint64_t m_TierUpThreshold;
+        std::unique_ptr<llvm::orc::JITTargetMachineBuilder> m_TargetMachineBuilder;
+        std::unique_ptr<llvm::orc::LLJIT> m_Jit;
+
+        std::unique_ptr<llvm::orc::IndirectStubsManager> m_Stubs;
+        std::unique_ptr<llvm::TargetMachine> m_OptimizingMachine;
+        std::vector<llvm::orc::ThreadSafeModule> m_SourceModules;
+        std::vector<TieredFunction> m_TieredFunctions;
+        std::atomic<bool> m_IsStopping = false;
+
+        // destroyed first, so no tier up is running anymore when the JIT goes away
+        std::unique_ptr<ThreadPool> m_TierUpThread;
+    };
+
+}
@@ -0,0 +1,317 @@
+#include "Lexer.h"
+#include "./utils/logger.h"
+
+#include <cctype>
+
+namespace Hunter::Compiler {
+
+    const char * GetTokenKindString(TokenKind kind) {
+        switch (kind) {
+            case TokenKind::Identifier:
+                return "Identifier";
+            case TokenKind::Integer:
+                return "Integer";
+            case TokenKind::String:
+                return "String";
+            case TokenKind::Operator:
+                return "Operator";
+            case TokenKind::LeftParenthesis:
+                return "(";
+            case TokenKind::RightParenthesis:
+                return ")";
+            case TokenKind::LeftBracket:
+                return "[";
+            case TokenKind::RightBracket:
+                return "]";
+            case TokenKind::Comma:
+                return ",";
+            case TokenKind::Colon:
+                return ":";
+            case TokenKind::Assign:
+                return "=";
+            case TokenKind::Range:
+                return "..";
+            case TokenKind::Import:
+                return "import";
+            case TokenKind::Module:
+                return "mod";
+            case TokenKind::Function:
+                return "fun";
+            case TokenKind::Extern:
+                return "extern";
+            case TokenKind::Print:
+                return "print";
+            case TokenKind::Const:
+                return "const";
+            case TokenKind::Let:
+                return "let";
+            case TokenKind::If:
+                return "if";
+            case TokenKind::Then:
+                return "then";
+            case TokenKind::Else:
+                return "else";
+            case TokenKind::While:
+                return "while";
+            case TokenKind::For:
+                return "for";
+            case TokenKind::In:
+                return "in";
+            case TokenKind::Return:
+                return "return";
+            case TokenKind::Struct:
+                return "struct";
+            case TokenKind::New:
+                return "new";
+            case TokenKind::EndOfLine:
+                return "EndOfLine";
+            case TokenKind::EndOfFile:
+                return "EndOfFile";
+        }
+
+        return "Unknown";
+    }
+
+    TokenKind GetWordKind(std::string_view word) {
+        // dispatch on the length first so every word is compared against at most three keywords
+        switch (word.size()) {
+            case 2:
+                if (word == "if") return TokenKind::If;
+                if (word == "in") return TokenKind::In;
+                if (word == "eq") return TokenKind::Operator;
+                break;
+            case 3:
+                if (word == "fun") return TokenKind::Function;
+                if (word == "let") return TokenKind::Let;
+                if (word == "for") return TokenKind::For;
+                if (word == "mod") return TokenKind::Module;
+                if (word == "new") return TokenKind::New;
+                if (word == "not") return TokenKind::Operator;
+                break;
+            case 4:
+                if (word == "then") return TokenKind::Then;
+                if (word == "else") return TokenKind::Else;
+                break;
+            case 5:
+                if (word == "const") return TokenKind::Const;
+                if (word == "print") return TokenKind::Print;
+                if (word == "while") return TokenKind::While;
+                break;
+            case 6:
+                if (word == "import") return TokenKind::Import;
+                if (word == "return") return TokenKind::Return;
+                if (word == "extern") return TokenKind::Extern;
+                if (word == "struct") return TokenKind::Struct;
+                break;
+            default:
+                break;
+        }
+
+        return TokenKind::Identifier;
+    }
+
+    std::vector<Token> Lexer::Tokenize() {
+        std::vector<Token> tokens;
+        // a rough guess which avoids most of the reallocations on real sources
+        tokens.reserve(m_Source.size() / 4 + 1);
+
+        const size_t size = m_Source.size();
+        size_t pos = 0;
+        int64_t line = 0;
+
+        while (pos < size) {
+            line += 1;
+
+            size_t lineStart = pos;
+            int32_t level = 0;
+            bool hasTokens = false;
+
+            while (pos < size && m_Source[pos] != '\n' && isspace(m_Source[pos])) {
+                level += 1;
+                pos += 1;
+            }
+
+            while (pos < size && m_Source[pos] != '\n') {
+                char c = m_Source[pos];
+
+                if (isspace(c)) {
+                    pos += 1;
+                    continue;
+                }
+
+                if (c == '#') {
+                    while (pos < size && m_Source[pos] != '\n') {
+                        pos += 1;
+                    }
+
+                    break;
+                }
+
+                int64_t column = static_cast<int64_t>(pos - lineStart) + 1;
+                size_t end = pos + 1;
+                TokenKind kind;
+                Symbol name;
+
+                if (isalpha(c) || c == '_') {
+                    end = LexIdentifier(pos);
+                    kind = GetWordKind(m_Source.substr(pos, end - pos));
+
+                    if (kind == TokenKind::Identifier) {
+                        name = m_Symbols.Intern(m_Source.substr(pos, end - pos));
+                    }
+                }
+                else if (isdigit(c) || (c == '-' && pos + 1 < size && isdigit(m_Source[pos + 1]))) {
+                    end = LexNumber(pos + 1);
+                    kind = TokenKind::Integer;
+                }
+                else if (c == '"') {
+                    end = LexString(pos + 1, line, column);
+                    tokens.push_back({
+                        .Kind = TokenKind::String,
+                        .Level = level,
+                        .Text = m_Source.substr(pos + 1, end - pos - 2),
+                        .Line = line,
+                        .Column = column
+                    });
+
+                    hasTokens = true;
+                    pos = end;
+                    continue;
+                }
+                else {
+                    char next = pos + 1 < size ? m_Source[pos + 1] : '\0';
+
+                    switch (c) {
+                        case '(':
+                            kind = TokenKind::LeftParenthesis;
+                            break;
+                        case ')':
+                            kind = TokenKind::RightParenthesis;
+                            break;
+                        case '[':
+                            kind = TokenKind::LeftBracket;
+                            break;
+                        case ']':
+                            kind = TokenKind::RightBracket;
+                            break;
+                        case ',':
+                            kind = TokenKind::Comma;
+                            break;
+                        case ':':
+                            kind = TokenKind::Colon;
+                            break;
+                        case '=':
+                            kind = TokenKind::Assign;
+                            break;
+                        case '.':
+                            if (next != '.') {
+                                COMPILER_ERROR("Unexpected character '.' at line {0}, column {1}", line, column);
+                                exit(1);
+                            }
+
+                            kind = TokenKind::Range;
+                            end += 1;
+                            break;
+                        case '<':
+                        case '>':
+                            kind = TokenKind::Operator;
+                            if (next == '=') {
+                                end += 1;
+                            }
+                            break;
+                        case '+':
+                        case '-':
+                        case '*':
+                        case '/':
+                        case '|':
+                        case '&':
+                        case '~':
+                            kind = TokenKind::Operator;
+                            break;
+                        default:
+                            COMPILER_ERROR("Unexpected character '{0}' at line {1}, column {2}", c, line, column);
+                            exit(1);
+                    }
+                }
+
+                tokens.push_back({
+                    .Kind = kind,
+                    .Level = level,
+                    .Text = m_Source.substr(pos, end - pos),
+                    .Name = name,
+                    .Line = line,
+                    .Column = column
+                });
+
+                hasTokens = true;
+                pos = end;
+            }
+
+            if (hasTokens) {
+                tokens.push_back({
+                    .Kind = TokenKind::EndOfLine,
+                    .Level = level,
+                    .Text = std::string_view(),
+                    .Line = line,
+                    .Column = static_cast<int64_t>(pos - lineStart) + 1
+                });
+            }
+
+            // skip the line break itself
+            pos += 1;
+        }
+
+        tokens.push_back({
+            .Kind = TokenKind::EndOfFile,
+            .Level = 0,
+            .Text = std::string_view(),
+            .Line = line,
+            .Column = 1
+        });
+
+        return tokens;
+    }
+
+    size_t Lexer::LexIdentifier(size_t pos) {
+        while (pos < m_Source.size()) {
+            char c = m_Source[pos];
+
+            if (!isalnum(c) && c != '_' && c != '.') {
+                break;
+            }
+
+            pos += 1;
+        }
+
+        return pos;
+    }
+
+    size_t Lexer::LexNumber(size_t pos) {
+        while (pos < m_Source.size() && isdigit(m_Source[pos])) {
+            pos += 1;
+        }
+
+        return pos;
+    }
+
+    size_t Lexer::LexString(size_t pos, int64_t line, int64_t column) {
+        while (pos < m_Source.size() && m_Source[pos] != '\n') {
+            char c = m_Source[pos];
+
+            if (c == '\\') {
+                pos += 2;
+                continue;
+            }
+
+            if (c == '"') {
+                return pos + 1;
+            }
+
+            pos += 1;
+        }
+
+        COMPILER_ERROR("Unterminated string starting at line {0}, column {1}", line, column);
+        exit(1);
+    }
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "SymbolTable.h"
+
+namespace Hunter::Compiler {
+
+    enum class TokenKind : uint8_t {
+        Identifier,
+        Integer,
+        String,
+        Operator,
+
+        LeftParenthesis,
+        RightParenthesis,
+        LeftBracket,
+        RightBracket,
+        Comma,
+        Colon,
+        Assign,
+        Range,
+
+        // keywords
+        Import,
+        Module,
+        Function,
+        Extern,
+        Print,
+        Const,
+        Let,
+        If,
+        Then,
+        Else,
+        While,
+        For,
+        In,
+        Return,
+        Struct,
+        New,
+
+        EndOfLine,
+        EndOfFile,
+    };
+
+    const char * GetTokenKindString(TokenKind kind);
+
+    struct Token {
+        TokenKind Kind;
+        // indentation of the line the token belongs to
+        int32_t Level;
+        // points into the lexed source, string tokens exclude the quotes
+        std::string_view Text;
+        // interned text of identifier tokens
+        Symbol Name;
+        int64_t Line;
+        int64_t Column;
+    };
+
+    /**
+     * Splits a whole source file in a single pass into a flat list of tokens.
+     * Every non empty line is terminated by an EndOfLine token, comments and
+     * blank lines do not produce any tokens at all. Identifiers are interned right away.
+     */
+    class Lexer {
+    public:
+        Lexer(std::string_view source, SymbolTable & symbols) : m_Source(source), m_Symbols(symbols) {}
+
+        std::vector<Token> Tokenize();
+
+    protected:
+        size_t LexIdentifier(size_t pos);
+        size_t LexNumber(size_t pos);
+        size_t LexString(size_t pos, int64_t line, int64_t column);
+
+    private:
+        std::string_view m_Source;
+        SymbolTable & m_Symbols;
+    };
+
+}
@@ -0,0 +1,101 @@
+#include "ModuleTreeCache.h"
+
+#include <cstring>
+#include <filesystem>
+
+#include <unistd.h>
+
+#include <llvm/Support/xxhash.h>
+
+namespace Hunter::Compiler {
+
+    static void AppendUnsigned(std::string & data, uint64_t value) {
+        data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    static bool ReadUnsigned(std::string_view & data, uint64_t & value) {
+        if (data.size() < sizeof(value)) {
+            return false;
+        }
+
+        std::memcpy(&value, data.data(), sizeof(value));
+        data.remove_prefix(sizeof(value));
+
+        return true;
+    }
+
+    static bool ReadString(std::string_view & data, std::string_view & str) {
+        uint64_t size;
+
+        if (!ReadUnsigned(data, size) || data.size() < size) {
+            return false;
+        }
+
+        str = data.substr(0, size);
+        data.remove_prefix(size);
+
+        return true;
+    }
+
+    std::string ModuleTreeCache::GetKey(const std::string & filePath) {
+        // the debug data keeps the path as it was given, so the working directory is part of the key
+        return std::filesystem::current_path().string() + "\n" + filePath;
+    }
+
+    std::string_view ModuleTreeCache::Find(const std::string & filePath, std::string_view source) const {
+        auto entry = m_Trees.find(GetKey(filePath));
+
+        if (entry == m_Trees.end() || entry->second.SourceHash != llvm::xxHash64(llvm::StringRef(source.data(), source.size()))) {
+            return {};
+        }
+
+        return entry->second.Tree;
+    }
+
+    void ModuleTreeCache::Report(const std::string & filePath, std::string_view source, std::string_view tree) {
+        if (m_ReportFileDescriptor == -1) {
+            return;
+        }
+
+        std::string key = GetKey(filePath);
+        std::string report;
+        AppendUnsigned(report, key.size());
+        report.append(key);
+        AppendUnsigned(report, llvm::xxHash64(llvm::StringRef(source.data(), source.size())));
+        AppendUnsigned(report, tree.size());
+        report.append(tree);
+
+        // reports are larger than what a pipe writes in one piece, so they must not be interleaved
+        std::lock_guard lock(m_ReportMutex);
+
+        for (size_t written = 0; written < report.size();) {
+            ssize_t result = write(m_ReportFileDescriptor, report.data() + written, report.size() - written);
+
+            // the tree is only lost for the next compilations
+            if (result <= 0) {
+                return;
+            }
+
+            written += static_cast<size_t>(result);
+        }
+    }
+
+    void ModuleTreeCache::AddReports(std::string_view reports) {
+        std::string_view key;
+        uint64_t sourceHash;
+        std::string_view tree;
+
+        while (ReadString(reports, key) && ReadUnsigned(reports, sourceHash) && ReadString(reports, tree)) {
+            if (m_Size + tree.size() > MaximumSize) {
+                m_Trees.clear();
+                m_Size = 0;
+            }
+
+            auto & entry = m_Trees[std::string(key)];
+            m_Size = m_Size - entry.Tree.size() + tree.size();
+            entry.SourceHash = sourceHash;
+            entry.Tree.assign(tree);
+        }
+    }
+
+}
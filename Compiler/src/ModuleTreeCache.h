@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Hunter::Compiler {
+
+    /**
+     * Serialized syntax trees of imported modules, kept in memory by the compile server.
+     * Every compilation runs in a child process of the server and sees the trees as they were
+     * when it was started. Trees it had to parse itself are reported back through a pipe and
+     * added by the server once the compilation is done, so the following ones can use them.
+     */
+    class ModuleTreeCache {
+    public:
+        // the trees of one build are small, a cache growing beyond this is simply started over
+        static constexpr size_t MaximumSize = 512 * 1024 * 1024;
+
+        // returns an empty view if the module was not parsed with exactly this source before
+        std::string_view Find(const std::string & filePath, std::string_view source) const;
+
+        // called by the compilation from any thread, writes the tree to the report pipe
+        void Report(const std::string & filePath, std::string_view source, std::string_view tree);
+
+        void SetReportFileDescriptor(int fileDescriptor) {
+            m_ReportFileDescriptor = fileDescriptor;
+        }
+
+        // called by the server with everything a compilation reported, an incomplete last report is ignored
+        void AddReports(std::string_view reports);
+
+        size_t GetSize() const {
+            return m_Size;
+        }
+
+    private:
+        struct Entry {
+            uint64_t SourceHash;
+            std::string Tree;
+        };
+
+        static std::string GetKey(const std::string & filePath);
+
+        std::unordered_map<std::string, Entry> m_Trees;
+        size_t m_Size = 0;
+
+        int m_ReportFileDescriptor = -1;
+        std::mutex m_ReportMutex;
+    };
+
+}
@@ -1,12 +1,17 @@
 #include "Parser.h"
 #include "Expressions.h"
-#include "./utils/files.h"
+#include "SourceManager.h"
 #include "./utils/logger.h"
 #include "./utils/strings.h"
 
+#include <charconv>
+
+#include <llvm/Support/TimeProfiler.h>
+
 namespace Hunter::Compiler {
     void AbstractSyntaxTree::Dump() {
-        std::cout << std::endl << "Dump ast:" << std::endl << "-----------" << std::endl;
+        // no flushing per line, trees of big programs have a lot of them
+        std::cout << "\nDump ast:\n-----------\n";
 
         for (const auto &expression : m_Expressions) {
             if (expression) {
@@ -16,36 +21,33 @@ namespace Hunter::Compiler {
     }
 
     AbstractSyntaxTree *Parser::Parse(const std::string &filePath) {
+        llvm::TimeTraceScope timeScope("Parse", filePath);
         auto path = std::filesystem::path(filePath);
-        std::string input = readFileIntoString(filePath);
+        std::string_view input = m_SourceManager.LoadFile(filePath);
 
-        m_CurrentFileName = path.filename();
-        m_CurrentDirectory = path.parent_path().string();
+        m_CurrentFileName = m_SourceManager.StoreString(path.filename());
+        m_CurrentDirectory = m_SourceManager.StoreString(path.parent_path().string());
         m_CurrentLine = 0;
         m_CurrentColumn = 0;
 
-        auto *tree = new AbstractSyntaxTree;
-
-        for (char const &c: input) {
+        Lexer lexer(input, m_SourceManager.GetSymbols());
+        m_Tokens = lexer.Tokenize();
 
-            if (c == '\n') {
-                m_CurrentLine += 1;
-
-                if (m_DataStr.empty()) {
-                    continue;
-                }
+        auto *tree = new AbstractSyntaxTree;
+        m_Arena = &tree->GetArena();
+        int currentPos = 0;
 
-                OnLineFinished(tree);
+        while (m_Tokens[currentPos].Kind != TokenKind::EndOfFile) {
+            int endPosition = currentPos;
 
-                continue;
+            while (m_Tokens[endPosition].Kind != TokenKind::EndOfLine) {
+                endPosition += 1;
             }
 
-            m_DataStr.push_back(c);
-        }
-
-        if (!m_DataStr.empty()) {
-            m_CurrentLine += 1;
+            m_CurrentExpression = ParseLine(currentPos, endPosition);
             OnLineFinished(tree);
+
+            currentPos = endPosition + 1;
         }
 
         return tree;
@@ -53,22 +55,15 @@ namespace Hunter::Compiler {
 
     void Parser::OnLineFinished(AbstractSyntaxTree * tree) {
 
-        m_CurrentExpression = ParseLine(m_DataStr);
-
-        if (!m_CurrentExpression && !m_IsFullLineComment) {
+        if (!m_CurrentExpression) {
             COMPILER_ERROR("Could not parse valid expression from current line");
             exit(1);
         }
-        else if (!m_CurrentExpression && m_IsFullLineComment) {
-            m_DataStr = "";
-            m_IsFullLineComment = false;
-            return;
-        }
 
         if (m_IsParsingBlock) {
-            if (auto *ifExpr = dynamic_cast<IfExpression *>(m_BlockExpressions.top())) {
+            if (auto *ifExpr = DynCast<IfExpression>(m_BlockExpressions.top())) {
 
-                if (auto * elseExpr = dynamic_cast<ElseExpression *>(m_CurrentExpression)) {
+                if (auto * elseExpr = DynCast<ElseExpression>(m_CurrentExpression)) {
                     m_BlockExpressions.pop();
                     m_BlockLevels.pop();
 
@@ -77,7 +72,7 @@ namespace Hunter::Compiler {
                     ifExpr->AddExpression(m_CurrentExpression);
                 }
 
-            } else if (auto *blockExpr = dynamic_cast<BlockExpression *>(m_BlockExpressions.top())) {
+            } else if (auto *blockExpr = DynCast<BlockExpression>(m_BlockExpressions.top())) {
                 blockExpr->AddExpression(m_CurrentExpression);
             }
 
@@ -96,463 +91,251 @@ namespace Hunter::Compiler {
                 m_IsParsingBlock = true;
             }
         }
-
-        m_DataStr = "";
     }
 
     Expression *Parser::ParseLine(const std::string &input) {
-        int level = 0;
-        bool isLevelParsing = true;
-
-        std::string str;
-        Expression * expr = nullptr;
-        int endPosition = input.length();
-        int hashPosition = input.find("#");
-
-        if (hashPosition != std::string::npos) {
-            auto doubleQuotePosition = input.find('"');
-            auto lastDoubleQuotePosition = input.find_last_of('"');
-            if (doubleQuotePosition == std::string::npos || doubleQuotePosition > hashPosition || lastDoubleQuotePosition < hashPosition) {
-                endPosition = hashPosition-1;
-                m_IsFullLineComment = true;
-            }
-        }
-
-        for (int i = 0; i < endPosition; ++i) {
-            m_CurrentColumn = i+1;
-            char c = input.at(i);
+        Lexer lexer(m_SourceManager.StoreString(input), m_SourceManager.GetSymbols());
+        m_Tokens = lexer.Tokenize();
 
-            if (isspace(c) && isLevelParsing) {
-                level += 1;
-                continue;
-            } else if (!isspace(c) && isLevelParsing) {
-                isLevelParsing = false;
-                m_CurrentLevel = level;
-
-                if (!m_BlockLevels.empty()) {
-                    while (!m_BlockLevels.empty() && m_CurrentLevel <= m_BlockLevels.top()) {
-                        m_BlockExpressions.pop();
-                        m_BlockLevels.pop();
-                    }
+        int endPosition = 0;
 
-                    if (m_BlockExpressions.empty()) {
-                        m_IsParsingBlock = false;
-                    }
-                }
+        while (m_Tokens[endPosition].Kind != TokenKind::EndOfLine && m_Tokens[endPosition].Kind != TokenKind::EndOfFile) {
+            endPosition += 1;
+        }
 
-            }
+        // blank lines and comments do not produce any tokens
+        if (endPosition == 0) {
+            return nullptr;
+        }
 
-            if (isspace(c) || c == '(' || c == ':') {
-                if (str == "import") {
-                    ParseResult result = ParseImport(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                } else if (str == "fun") {
-                    ParseResult result = ParseFunctionHeader(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                } else if (str == "print") {
-                    ParseResult result = ParseFunctionCall(i-1, endPosition, input);
-                    dynamic_cast<FunctionCallExpression *>(result.Expr)->SetFunctionName("print");
-
-                    i = result.Pos+1;
-                    expr = new PrintExpression(result.Expr);
-                } else if (str == "const") {
-                    ParseResult result = ParseVariableDeclaration(i, endPosition, input, VariableHandlingType::Const);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                } else if (str == "let") {
-                    ParseResult result = ParseVariableDeclaration(i, endPosition, input, VariableHandlingType::Let);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                }  else if (str == "if") {
-                    ParseResult result = ParseIf(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                }   else if (str == "while") {
-                    ParseResult result = ParseBoolean(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = new WhileExpression(result.Expr);
-                }  else if (str == "for") {
-                    ParseResult result = ParseFor(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                }  else if (str == "mod") {
-                    ParseResult result = ParseModule(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                }  else if (str == "return") {
-                    ParseResult result = ParseFunctionReturn(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                }  else if (str == "extern") {
-                    ParseResult result = ParseExtern(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                }  else if (str == "struct") {
-                    ParseResult result = ParseStruct(i, endPosition, input);
-                    i = result.Pos+1;
-                    expr = result.Expr;
-                } else {
+        return ParseLine(0, endPosition);
+    }
 
-                    ParseResult result = ParseIdentifier(-1, str.length(), str);
-                    if (result.Expr) {
-                        if (c == '(') {
-                            result = ParseFunctionCall(i, endPosition, input);
-                            dynamic_cast<FunctionCallExpression *>(result.Expr)->SetFunctionName(str);
-                        } else if (c == ':') {
-                            std::string typeStr = input.substr(i+1, input.size());
-                            trim(typeStr);
-                            result.Expr = new PropertyDeclarationExpression(
-                                    str,
-                                    GetDataTypeFromString(typeStr)
-                            );
-
-                            result.Pos = input.size();
-                        } else {
-                            result = ParseVariableDeclaration(i-str.length()-1, endPosition, input, VariableHandlingType::Assign);
-                        }
-
-                        expr = result.Expr;
-                        i = result.Pos+1;
-                    } else {
-                        std::cerr << "Unknown keyword: " << str << std::endl;
-                        exit(1);
-                    }
+    Expression *Parser::ParseLine(int currentPos, int endPosition) {
+        const Token & token = m_Tokens[currentPos];
 
-                }
+        m_CurrentLine = token.Line;
+        // points to the separator right after the leading keyword or identifier
+        m_CurrentColumn = token.Column + static_cast<int64_t>(token.Text.size());
+        m_CurrentLevel = token.Level;
 
-                if (!expr) {
-                    std::cerr << "Parsing produced invalid expression" << std::endl;
-                    exit(1);
+        if (!m_BlockLevels.empty()) {
+            while (!m_BlockLevels.empty() && m_CurrentLevel <= m_BlockLevels.top()) {
+                // an else on the level of an if belongs to it, OnLineFinished closes the if
+                if (token.Kind == TokenKind::Else && m_CurrentLevel == m_BlockLevels.top() && IsA<IfExpression>(m_BlockExpressions.top())) {
+                    break;
                 }
 
-                EmitDebugData(expr);
-
-                str = "";
-                continue;
+                m_BlockExpressions.pop();
+                m_BlockLevels.pop();
             }
 
-            str.push_back(c);
-        }
-
-        if (!str.empty()) {
-            // this happens if there is a single keyword like 'else' and there is no space left afterwards
-            if (str == "else") {
-                expr = new ElseExpression();
-            } else {
-                std::cerr << "Unknown keyword was found" << std::endl;
-                exit(1);
+            if (m_BlockExpressions.empty()) {
+                m_IsParsingBlock = false;
             }
         }
 
-        return expr;
-    }
-
-    ParseResult Parser::ParseExtern(int currentPos, int endPosition, const std::string &input) {
-        std::string str;
-
-        for (int i = currentPos; i < endPosition; ++i, ++currentPos) {
-            char c = input.at(i);
+        ParseResult result = {
+            .Pos = currentPos,
+            .Expr = nullptr
+        };
 
-            if (isspace(c)) {
-                if (str == "fun") {
-                    break;
+        switch (token.Kind) {
+            case TokenKind::Import:
+                result = ParseImport(currentPos+1, endPosition);
+                break;
+            case TokenKind::Module:
+                result = ParseModule(currentPos+1, endPosition);
+                break;
+            case TokenKind::Function:
+                result = ParseFunctionHeader(currentPos+1, endPosition);
+                break;
+            case TokenKind::Extern:
+                result = ParseExtern(currentPos+1, endPosition);
+                break;
+            case TokenKind::Print:
+                result = ParseFunctionCall(currentPos, endPosition);
+                result.Expr = m_Arena->Create<PrintExpression>(result.Expr);
+                break;
+            case TokenKind::Const:
+                result = ParseVariableDeclaration(currentPos+1, endPosition, VariableHandlingType::Const);
+                break;
+            case TokenKind::Let:
+                result = ParseVariableDeclaration(currentPos+1, endPosition, VariableHandlingType::Let);
+                break;
+            case TokenKind::If:
+                result = ParseIf(currentPos+1, endPosition);
+                break;
+            case TokenKind::While:
+                result = ParseBoolean(currentPos+1, endPosition);
+                result.Expr = m_Arena->Create<WhileExpression>(result.Expr);
+                break;
+            case TokenKind::For:
+                result = ParseFor(currentPos+1, endPosition);
+                break;
+            case TokenKind::Return:
+                result = ParseFunctionReturn(currentPos+1, endPosition);
+                break;
+            case TokenKind::Struct:
+                result = ParseStruct(currentPos+1, endPosition);
+                break;
+            case TokenKind::Else:
+                result = {
+                    .Pos = currentPos+1,
+                    .Expr = m_Arena->Create<ElseExpression>()
+                };
+                break;
+            case TokenKind::Identifier: {
+                TokenKind nextKind = m_Tokens[currentPos+1].Kind;
+
+                if (nextKind == TokenKind::LeftParenthesis) {
+                    result = ParseFunctionCall(currentPos, endPosition);
+                } else if (nextKind == TokenKind::Colon) {
+                    result = {
+                        .Pos = endPosition,
+                        .Expr = m_Arena->Create<PropertyDeclarationExpression>(
+                            token.Name,
+                            GetDataTypeFromString(GetTokensText(currentPos+2, endPosition))
+                        )
+                    };
+                } else if (nextKind == TokenKind::Assign) {
+                    result = ParseVariableDeclaration(currentPos, endPosition, VariableHandlingType::Assign);
+                } else {
+                    COMPILER_ERROR("Unknown keyword: {0} (line {1})", token.Text, token.Line);
+                    exit(1);
                 }
 
-                str = "";
-                continue;
+                break;
             }
-
-            str.push_back(c);
+            default:
+                COMPILER_ERROR("Unexpected {0} at line {1}, column {2}", GetTokenKindString(token.Kind), token.Line, token.Column);
+                exit(1);
         }
 
-        for (int i = currentPos+1; i < endPosition; ++i, ++currentPos) {
-            char c = input.at(i);
+        if (!result.Expr) {
+            COMPILER_ERROR("Parsing produced invalid expression (line {0})", token.Line);
+            exit(1);
+        }
 
-            if (!isspace(c)) {
-                break;
-            }
+        if (result.Pos < endPosition) {
+            const Token & unexpected = m_Tokens[result.Pos];
+            COMPILER_ERROR("Unexpected \"{0}\" at line {1}, column {2}", unexpected.Text, unexpected.Line, unexpected.Column);
+            exit(1);
         }
 
-        ParseResult result = ParseFunctionHeader(currentPos, endPosition, input);
+        EmitDebugData(result.Expr);
+
+        return result.Expr;
+    }
+
+    ParseResult Parser::ParseExtern(int currentPos, int endPosition) {
+        Expect(currentPos, endPosition, TokenKind::Function);
+
+        ParseResult result = ParseFunctionHeader(currentPos+1, endPosition);
 
         if (!result.Expr) {
             COMPILER_ERROR("Could not parse function definition for external");
             exit(1);
         }
 
-        (dynamic_cast<FunctionExpression *>(result.Expr))->SetExternal(true);
+        (DynCast<FunctionExpression>(result.Expr))->SetExternal(true);
 
         return {
             .Pos = result.Pos,
-            .Expr = new ExternExpression(result.Expr)
+            .Expr = m_Arena->Create<ExternExpression>(result.Expr)
         };
     }
 
-    ParseResult Parser::ParseImport(int currentPos, int endPosition, const std::string &input) {
-
-        std::string str;
-        Expression * expr;
-
-        for (int i = currentPos; i < endPosition; ++i, ++currentPos) {
-            char c = input.at(i);
-
-            if (isspace(c) && str.empty()) {
-                continue;
-            } else if (isspace(c)) {
-                str = "";
-                continue;
-            }
-
-            str.push_back(c);
-        }
+    ParseResult Parser::ParseImport(int currentPos, int endPosition) {
+        const Token & module = Expect(currentPos, endPosition, TokenKind::Identifier);
 
         return {
-            .Pos = currentPos,
-            .Expr = new ImportExpression(str)
+            .Pos = currentPos+1,
+            .Expr = m_Arena->Create<ImportExpression>(module.Text)
         };
     }
 
-    ParseResult Parser::ParseModule(int currentPos, int endPosition, const std::string &input) {
-
-        std::string str;
-        Expression * expr;
-
-        for (int i = currentPos; i < endPosition; ++i, ++currentPos) {
-            char c = input.at(i);
-
-            if (isspace(c) && str.empty()) {
-                continue;
-            } else if (isspace(c)) {
-                break;
-            }
-
-            str.push_back(c);
-        }
+    ParseResult Parser::ParseModule(int currentPos, int endPosition) {
+        const Token & module = Expect(currentPos, endPosition, TokenKind::Identifier);
 
         return {
-                .Pos = currentPos,
-                .Expr = new ModuleExpression(str)
+                .Pos = currentPos+1,
+                .Expr = m_Arena->Create<ModuleExpression>(module.Text)
         };
     }
 
-    ParseResult Parser::ParseExpression(int currentPos,  int endPosition, const std::string &input) {
-
-        std::string str;
-        Expression * expr = nullptr;
-
-        for (int i = currentPos+1; i < endPosition; ++i, ++currentPos) {
-            char c = input.at(i);
+    ParseResult Parser::ParseExpression(int currentPos,  int endPosition) {
 
-            if (isspace(c)) {
-                if (!str.empty()) {
-                    COMPILER_INFO("Word: {0}", str);
-                }
-
-                str = "";
-                continue;
-            }
-
-            else if (c == '[') {
-
-                std::string listElementsStr = input.substr(1, input.size()-2);
-                std::vector<std::string> listElements;
-                split(listElementsStr, ',', listElements);
-
-                for (const auto &element : listElements) {
-                    ParseResult result = ParseExpression(-1, element.size(), element);
-
-                    if (!result.Expr) {
-                        COMPILER_ERROR("Could not parse list element: {0}", element);
-                        exit(1);
-                    }
-
-                    if (!expr) {
-                        expr = new ListExpression(GetDataTypeFromExpression(result.Expr));
-                    }
-
-                    dynamic_cast<ListExpression *>(expr)->AddElement(result.Expr);
-                }
-
-                currentPos = endPosition;
-                i = endPosition;
-
-                continue;
-            }
+        if (currentPos >= endPosition) {
+            const Token & token = m_Tokens[currentPos];
+            COMPILER_ERROR("Expected expression at line {0}, column {1}", token.Line, token.Column);
+            exit(1);
+        }
 
-            else if (c == '(') {
+        const Token & token = m_Tokens[currentPos];
+        ParseResult result;
 
-                if (auto * identifierExpr = dynamic_cast<IdentifierExpression *>(expr)) {
+        switch (token.Kind) {
+            case TokenKind::LeftBracket:
+                result = ParseList(currentPos, endPosition);
+                break;
+            case TokenKind::String:
+                result = ParseString(currentPos, endPosition);
+                break;
+            case TokenKind::Integer:
+                result = ParseInt(currentPos, endPosition);
+                break;
+            case TokenKind::Identifier:
+                if (m_Tokens[currentPos+1].Kind == TokenKind::LeftParenthesis) {
                     // this is actually a function call
-
-                    ParseResult result = ParseFunctionCall(i, endPosition, input);
-                    dynamic_cast<FunctionCallExpression *>(result.Expr)->SetFunctionName(identifierExpr->GetVariableName());
-
-                    i = result.Pos+1;
-                    currentPos = result.Pos+1;
-                    expr = result.Expr;
-
+                    result = ParseFunctionCall(currentPos, endPosition);
                 } else {
-                    str = "";
-                    continue;
+                    result = ParseIdentifier(currentPos, endPosition);
                 }
-
-            }
-
-            else if (c == ')') {
-                str = "";
-                continue;
-            }
-
-            else if (c == '"') {
-                ParseResult result = ParseString(i, endPosition, input);
-                i = result.Pos+1;
-                currentPos = result.Pos+1;
-                expr = result.Expr;
-
-                str = "";
                 break;
-            }
-
-            // parse identifier
-            else if (isalpha(c) && str.empty()) {
-                ParseResult result = ParseIdentifier(i-1, input.length(), input);
-                i = result.Pos;
-                currentPos = result.Pos;
-                expr = result.Expr;
-
-                str = "";
-                continue;
-            }
-
-            // parse number
-            else if ((isnumber(c) || c == '-') && str.empty()) {
-                ParseResult result = ParseInt(i-1, endPosition, input);
-                i = result.Pos+1;
-                currentPos = result.Pos+1;
-                expr = result.Expr;
-
-                if (!expr) {
-                    std::cerr << "Could not parse int number" << std::endl;
-                    exit(1);
-                }
-
-                str = "";
+            case TokenKind::Operator:
+                result = {
+                    .Pos = currentPos+1,
+                    .Expr = m_Arena->Create<OperationExpression>(GetOperatorFromString(token.Text))
+                };
                 break;
-            }
-
-            str.push_back(c);
-        }
-
-        if (!expr) {
-            OperatorType operatorType = GetOperatorFromString(str);
-
-            if (operatorType != OperatorType::NoOperator) {
-                expr = new OperationExpression(operatorType);
-            } else {
-                COMPILER_ERROR("Could not parse valid expression from {0}", input);
+            default:
+                COMPILER_ERROR("Could not parse valid expression from \"{0}\" at line {1}, column {2}", token.Text, token.Line, token.Column);
                 exit(1);
-            }
-
         }
 
-        EmitDebugData(expr);
+        EmitDebugData(result.Expr);
 
-        return {
-            .Pos = currentPos+1,
-            .Expr = expr
-        };
+        return result;
     }
 
-    ParseResult Parser::ParseFullExpression(int currentPos,  int endPosition, const std::string &input) {
+    ParseResult Parser::ParseFullExpression(int currentPos,  int endPosition) {
         std::vector<Expression *> ops;
-        std::string str;
-
-        for (int i = currentPos; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-
-            if (isspace(c) && !str.empty()) {
-
-                if (str.at(0) == '[' && str.at(str.length()-1) != ']') {
-                    str.push_back(c);
-                    continue;
-                }
-
-                if (str.at(0) == '"' && str.at(str.length()-1) != '"') {
-                    str.push_back(c);
-                    continue;
-                }
 
-                ParseResult result;
+        while (currentPos < endPosition) {
+            TokenKind kind = m_Tokens[currentPos].Kind;
 
-                if (str == "new") {
-                    result = ParseStructConstruction(-1, input.size(), input.substr(i));
-                    i = input.size()+1;
-                    currentPos = input.size()+1;
-                } else {
-                    uint64_t parenthesisPos = str.find('(');
-
-                    if (parenthesisPos != std::string::npos) {
-                        uint64_t closingParenthesisPos = input.find(')')+1;
-                        str = input.substr(i - str.length(), closingParenthesisPos);
-                        i = closingParenthesisPos;
-                        currentPos = closingParenthesisPos;
-                    }
-
-                    result = ParseExpression(-1, str.length(), str);
-                }
-
-                if (!result.Expr) {
-                    COMPILER_ERROR("Could not parse expression");
-                    exit(1);
-                }
-
-                auto * operationExpr = dynamic_cast<OperationExpression *>(result.Expr);
-                if (operationExpr) {
-                    if (GetOperandsNumber(operationExpr->GetOperator()) == 2) {
-                        if (ops.empty()) {
-                            std::cerr << "Operation " << GetOperatorString(operationExpr->GetOperator()) << " expects operand befor its use" << std::endl;
-                            exit(1);
-                        } else {
-                            operationExpr->SetLeft(ops.at(0));
-                            ops.pop_back();
-                        }
-                    }
-
-                    ops.push_back(result.Expr);
-                } else if (!ops.empty() && (operationExpr = dynamic_cast<OperationExpression *>(ops.at(0)))) {
-                    if (GetOperandsNumber(operationExpr->GetOperator()) == 2) {
-                        operationExpr->SetRight(result.Expr);
-                    } else {
-                        operationExpr->SetLeft(result.Expr);
-                    }
-                } else {
-                    ops.push_back(result.Expr);
-                }
-
-                str = "";
-                continue;
-            } else if (isspace(c)) {
-                continue;
+            // these close an enclosing list, call or struct construction
+            if (kind == TokenKind::Comma || kind == TokenKind::RightParenthesis || kind == TokenKind::RightBracket) {
+                break;
             }
 
-            str.push_back(c);
-        }
-
-        if (!str.empty()) {
-            ParseResult result = ParseExpression(-1, str.length(), str);
+            ParseResult result;
 
-            if (!result.Expr) {
-                std::cerr << "Could not parse expression" << std::endl;
-                exit(1);
+            if (kind == TokenKind::New) {
+                result = ParseStructConstruction(currentPos+1, endPosition);
+                EmitDebugData(result.Expr);
+            } else {
+                result = ParseExpression(currentPos, endPosition);
             }
 
-            auto * operationExpr = dynamic_cast<OperationExpression *>(result.Expr);
+            currentPos = result.Pos;
+
+            auto * operationExpr = DynCast<OperationExpression>(result.Expr);
             if (operationExpr) {
                 if (GetOperandsNumber(operationExpr->GetOperator()) == 2) {
                     if (ops.empty()) {
-                        std::cerr << "Operation " << GetOperatorString(operationExpr->GetOperator()) << " expects operand befor its use" << std::endl;
+                        COMPILER_ERROR("Operation {0} expects operand before its use", GetOperatorString(operationExpr->GetOperator()));
                         exit(1);
                     } else {
                         operationExpr->SetLeft(ops.at(0));
@@ -561,7 +344,7 @@ namespace Hunter::Compiler {
                 }
 
                 ops.push_back(result.Expr);
-            } else if (!ops.empty() && (operationExpr = dynamic_cast<OperationExpression *>(ops.at(0)))) {
+            } else if (!ops.empty() && (operationExpr = DynCast<OperationExpression>(ops.at(0)))) {
                 if (GetOperandsNumber(operationExpr->GetOperator()) == 2) {
                     operationExpr->SetRight(result.Expr);
                 } else {
@@ -584,117 +367,122 @@ namespace Hunter::Compiler {
         };
     }
 
-    ParseResult Parser::ParseString(int currentPos,  int endPosition, const std::string &input) {
-        std::string str;
+    ParseResult Parser::ParseList(int currentPos, int endPosition) {
+        Expect(currentPos, endPosition, TokenKind::LeftBracket);
+        currentPos += 1;
 
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-            if (c == '"') {
-                break;
+        ListExpression * listExpr = nullptr;
+
+        while (m_Tokens[currentPos].Kind != TokenKind::RightBracket) {
+            ParseResult result = ParseExpression(currentPos, endPosition);
+
+            if (!listExpr) {
+                listExpr = m_Arena->Create<ListExpression>(GetDataTypeFromExpression(result.Expr));
             }
 
-            str.push_back(c);
+            listExpr->AddElement(result.Expr);
+            currentPos = result.Pos;
+
+            if (m_Tokens[currentPos].Kind == TokenKind::Comma) {
+                currentPos += 1;
+            } else {
+                Expect(currentPos, endPosition, TokenKind::RightBracket);
+            }
         }
 
-        replaceAll(str, "\\n", "\n");
+        if (!listExpr) {
+            listExpr = m_Arena->Create<ListExpression>(DataTypeId::Unknown);
+        }
 
         return {
-            .Pos = currentPos,
-            .Expr = new StringExpression(str),
+            .Pos = currentPos+1,
+            .Expr = listExpr
         };
     }
 
-    ParseResult Parser::ParseStruct(int currentPos, int endPosition, const std::string &input) {
-        ParseResult result = ParseIdentifier(currentPos, endPosition, input);
+    ParseResult Parser::ParseString(int currentPos,  int endPosition) {
+        const Token & token = Expect(currentPos, endPosition, TokenKind::String);
+        std::string_view str = token.Text;
 
-        if (!result.Expr) {
-            COMPILER_ERROR("Could not parse struct identifier");
-            exit(1);
-        }
+        // only strings with escape sequences need their own copy
+        if (str.find('\\') != std::string_view::npos) {
+            std::string unescapedStr(str);
+            replaceAll(unescapedStr, "\\n", "\n");
+            replaceAll(unescapedStr, "\\\"", "\"");
 
-        std::string structName = dynamic_cast<IdentifierExpression *>(result.Expr)->GetVariableName();
+            str = m_SourceManager.StoreString(std::move(unescapedStr));
+        }
 
         return {
-            .Pos = result.Pos,
-            .Expr = new StructExpression(structName)
+            .Pos = currentPos+1,
+            .Expr = m_Arena->Create<StringExpression>(str),
         };
     }
 
-    ParseResult Parser::ParseFunctionHeader(int currentPos,  int endPosition, const std::string &input) {
+    ParseResult Parser::ParseStruct(int currentPos, int endPosition) {
+        const Token & structName = Expect(currentPos, endPosition, TokenKind::Identifier);
 
-        std::string functionName;
-        std::string parameter;
-        std::string returnTypeExpressionStr;
-        bool isNameParsing = true;
-        bool isParametersParsing = false;
-        bool isReturnParsing = false;
+        return {
+            .Pos = currentPos+1,
+            .Expr = m_Arena->Create<StructExpression>(structName.Name)
+        };
+    }
 
+    ParseResult Parser::ParseFunctionHeader(int currentPos,  int endPosition) {
+        const Token & functionName = Expect(currentPos, endPosition, TokenKind::Identifier);
         std::vector<ParameterExpression *> parametersList;
 
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-
-            if (isspace(c) && isNameParsing) {
-                isNameParsing = false;
-                continue;
-            }
-
-            else if (isspace(c)) {
-                continue;
-            }
+        // the runtime is declared in every module and linked into every program, a function with its prefix would clash with it
+        if (functionName.Text.starts_with("hunter_rt_")) {
+            COMPILER_ERROR("Function {0} at line {1}, column {2} uses the prefix hunter_rt_, which is reserved for the runtime", functionName.Text, functionName.Line, functionName.Column);
+            exit(1);
+        }
 
-            else if (c == '(') {
-                isNameParsing = false;
-                isParametersParsing = true;
-                continue;
-            }
+        currentPos += 1;
 
-            else if (!isParametersParsing && c == ':') {
-                isNameParsing = false;
-                isParametersParsing = false;
-                isReturnParsing = true;
-                continue;
-            }
+        if (currentPos < endPosition && m_Tokens[currentPos].Kind == TokenKind::LeftParenthesis) {
+            currentPos += 1;
 
-            else if (isParametersParsing && (c == ',' || c == ')')) {
-                if (!parameter.empty()) {
-                    auto index = parameter.find(':');
+            while (m_Tokens[currentPos].Kind != TokenKind::RightParenthesis) {
+                const Token & parameterName = Expect(currentPos, endPosition, TokenKind::Identifier);
 
-                    if (index > parameter.length()) {
-                        std::cerr << ": is missing for parameter type" << std::endl;
-                        exit(1);
-                    }
+                if (m_Tokens[currentPos+1].Kind != TokenKind::Colon) {
+                    COMPILER_ERROR(": is missing for parameter type of {0} (line {1})", parameterName.Text, parameterName.Line);
+                    exit(1);
+                }
 
-                    std::string parameterName = parameter.substr(0, index);
-                    std::string parameterType = parameter.substr(index+1, parameter.size());
+                int typePos = currentPos+2;
+                currentPos = typePos;
 
-                    parametersList.push_back(
-                        new ParameterExpression(parameterName, DataType::FromString(parameterType))
-                    );
+                while (currentPos < endPosition && m_Tokens[currentPos].Kind != TokenKind::Comma && m_Tokens[currentPos].Kind != TokenKind::RightParenthesis) {
+                    currentPos += 1;
+                }
 
-                    parameter = "";
+                if (currentPos >= endPosition) {
+                    COMPILER_ERROR("Parameter list of {0} is not closed (line {1})", functionName.Text, functionName.Line);
+                    exit(1);
                 }
 
-                if (c == ')') {
-                    isParametersParsing = false;
+                parametersList.push_back(
+                    m_Arena->Create<ParameterExpression>(
+                        parameterName.Name,
+                        DataType::FromString(std::string(GetTokensText(typePos, currentPos)), *m_Arena)
+                    )
+                );
+
+                if (m_Tokens[currentPos].Kind == TokenKind::Comma) {
+                    currentPos += 1;
                 }
             }
-            else if (isParametersParsing) {
-                parameter.push_back(c);
-            }
-            else if (isNameParsing) {
-                functionName.push_back(c);
-            }
-            else if (isReturnParsing) {
-                returnTypeExpressionStr.push_back(c);
-            }
 
+            currentPos += 1;
         }
 
-        auto * funcExpr = new FunctionExpression(functionName, parametersList);
+        auto * funcExpr = m_Arena->Create<FunctionExpression>(functionName.Name, parametersList);
 
-        if (!returnTypeExpressionStr.empty()) {
-            funcExpr->SetReturnType(GetDataTypeFromString(returnTypeExpressionStr));
+        if (currentPos < endPosition && m_Tokens[currentPos].Kind == TokenKind::Colon) {
+            funcExpr->SetReturnType(GetDataTypeFromString(GetTokensText(currentPos+1, endPosition)));
+            currentPos = endPosition;
         }
 
         return {
@@ -703,236 +491,106 @@ namespace Hunter::Compiler {
         };
     }
 
-    ParseResult Parser::ParseFunctionReturn(int currentPos, int endPosition, const std::string &input) {
-        ParseResult result = ParseExpression(currentPos, endPosition, input);
+    ParseResult Parser::ParseFunctionReturn(int currentPos, int endPosition) {
+        ParseResult result = ParseFullExpression(currentPos, endPosition);
+
+        if (!result.Expr) {
+            COMPILER_ERROR("Could not parse return value (line {0})", m_CurrentLine);
+            exit(1);
+        }
 
         return {
             .Pos = result.Pos,
-            .Expr = new FunctionReturnExpression(result.Expr)
+            .Expr = m_Arena->Create<FunctionReturnExpression>(result.Expr)
         };
     }
 
-    ParseResult Parser::ParseIf(int currentPos,  int endPosition, const std::string &input) {
-
-        std::string str;
-        std::string expressionStr;
-
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-
-            if (isspace(c)) {
-                if (str != "then") {
-                    expressionStr += str + " ";
-                }
-
-                str = "";
-                continue;
-            }
-
-            str.push_back(c);
-        }
+    ParseResult Parser::ParseIf(int currentPos,  int endPosition) {
 
-        if (str != "then") {
-            std::cerr << "If condition has always to be followed by then" << std::endl;
+        if (endPosition <= currentPos || m_Tokens[endPosition-1].Kind != TokenKind::Then) {
+            COMPILER_ERROR("If condition has always to be followed by then (line {0})", m_CurrentLine);
             exit(1);
         }
 
-        Expression * expr = ParseBoolean(0, expressionStr.length(), expressionStr).Expr;
+        Expression * expr = ParseBoolean(currentPos, endPosition-1).Expr;
 
         if (!expr) {
-            std::cerr << "Could not parse if boolean expression" << std::endl;
+            COMPILER_ERROR("Could not parse if boolean expression (line {0})", m_CurrentLine);
             exit(1);
         }
 
         return {
-            .Pos = currentPos,
-            .Expr = new IfExpression(expr)
+            .Pos = endPosition,
+            .Expr = m_Arena->Create<IfExpression>(expr)
         };
     }
 
-    ParseResult Parser::ParseFor(int currentPos,  int endPosition, const std::string &input) {
-
-        std::string str;
-        std::string counterIdentifier;
-        Expression * range;
-
-        int currentParsingPart = 1;
-
-        for (int i = currentPos; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-
-            if (isspace(c) && !str.empty()) {
-
-                if (currentParsingPart == 1) {
-                    counterIdentifier = str;
-                } else if (currentParsingPart == 2) {
-                    if (str != "in") {
-                        std::cerr << "Between counter and range there has to be \"in\" keyword" << std::endl;
-                        exit(1);
-                    }
-                } else if (currentParsingPart == 3) {
-                    ParseResult result = ParseRange(-1, str.length(), str);
+    ParseResult Parser::ParseFor(int currentPos,  int endPosition) {
+        const Token & counterIdentifier = Expect(currentPos, endPosition, TokenKind::Identifier);
+        Expect(currentPos+1, endPosition, TokenKind::In);
 
-                    if (!result.Expr) {
-                        std::cerr << "Could not parse range expression" << std::endl;
-                        exit(1);
-                    }
-
-                    range = result.Expr;
-
-                } else {
-                    std::cerr << "After range nothing else is expected" << std::endl;
-                    exit(1);
-                }
-
-                currentParsingPart += 1;
-
-                str = "";
-                continue;
-            } else if (isspace(c)) {
-                continue;
-            }
-
-            str.push_back(c);
-        }
-
-        if (currentParsingPart == 3) {
-            ParseResult result = ParseRange(-1, str.length(), str);
-
-            if (!result.Expr) {
-                std::cerr << "Could not parse range expression" << std::endl;
-                exit(1);
-            }
-
-            range = result.Expr;
-        }
+        ParseResult result = ParseRange(currentPos+2, endPosition);
 
         return {
-            .Pos = currentPos,
-            .Expr = new ForLoopExpression(counterIdentifier, range)
+            .Pos = result.Pos,
+            .Expr = m_Arena->Create<ForLoopExpression>(counterIdentifier.Name, result.Expr)
         };
     }
 
-    ParseResult Parser::ParseRange(int currentPos,  int endPosition, const std::string &input) {
+    ParseResult Parser::ParseRange(int currentPos,  int endPosition) {
 
-        std::string str;
-        int64_t start = -1;
-        int64_t end = -1;
-        IdentifierExpression * variable = nullptr;
+        if (currentPos < endPosition && m_Tokens[currentPos].Kind == TokenKind::Identifier) {
+            ParseResult result = ParseIdentifier(currentPos, endPosition);
 
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-            if (c == '.') {
-
-                if (!str.empty()) {
-                    if (start == -1) {
-                        start = std::stoll(str);
-                    } else {
-                        end = std::stoll(str);
-                    }
-                }
-
-                str = "";
-                continue;
-            } else if (!isnumber(c)) {
-                ParseResult result = ParseIdentifier(i-1, endPosition, input);
-                variable = dynamic_cast<IdentifierExpression *>(result.Expr);
-                i = result.Pos+1;
-                currentPos = result.Pos+1;
-            }
-
-            str.push_back(c);
-        }
-
-        if (!str.empty() && !variable) {
-            if (end == -1) {
-                end = std::stoll(str);
-            }
+            return {
+                .Pos = result.Pos,
+                .Expr = m_Arena->Create<RangeExpression>(DynCast<IdentifierExpression>(result.Expr))
+            };
         }
 
-        Expression * resultExpr = nullptr;
+        int64_t start = -1;
+        int64_t end = GetIntFromToken(Expect(currentPos, endPosition, TokenKind::Integer));
+        currentPos += 1;
 
-        if (variable) {
-            resultExpr = new RangeExpression(variable);
-        } else {
-            resultExpr = new RangeExpression(start, end);
+        if (currentPos < endPosition && m_Tokens[currentPos].Kind == TokenKind::Range) {
+            start = end;
+            end = GetIntFromToken(Expect(currentPos+1, endPosition, TokenKind::Integer));
+            currentPos += 2;
         }
 
         return {
             .Pos = currentPos,
-            .Expr = resultExpr
+            .Expr = m_Arena->Create<RangeExpression>(start, end)
         };
     }
 
-    ParseResult Parser::ParseBoolean(int currentPos,  int endPosition, const std::string &input) {
+    ParseResult Parser::ParseBoolean(int currentPos,  int endPosition) {
 
-        std::string str;
-        Expression * resultExpr;
+        Expression * resultExpr = nullptr;
         OperatorType currentOperator = OperatorType::NoOperator;
         int8_t operandsNumber = 0;
         int8_t currentOperand = 0;
 
-        for (int i = currentPos; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-
-            if (c == '"') {
-                do {
-                    str.push_back(c);
-                    c = input.at(++i);
-                    currentPos++;
-                } while (c != '"');
-            }
-
-            if (isspace(c) && !str.empty()) {
-                OperatorType operatorType = GetOperatorFromString(str);
-                if (operatorType != OperatorType::NoOperator) {
-                    currentOperator = operatorType;
-                    operandsNumber = GetOperandsNumber(currentOperator);
-
-                    currentOperand = operandsNumber > 1 ? 1 : 0;
-
-                    if (resultExpr == nullptr && operandsNumber > 1) {
-                        std::cerr << "Operator " << str << " needs " << operandsNumber << " operands" << std::endl;
-                        exit(1);
-                    }
-
-                } else {
-                    ParseResult result = ParseExpression(-1, str.length(), str);
-
-                    if (currentOperator != OperatorType::NoOperator) {
-                        currentOperand += 1;
+        while (currentPos < endPosition) {
+            const Token & token = m_Tokens[currentPos];
 
-                        if (currentOperand == operandsNumber) {
+            if (token.Kind == TokenKind::Operator) {
+                currentOperator = GetOperatorFromString(token.Text);
+                operandsNumber = GetOperandsNumber(currentOperator);
 
-                            if (operandsNumber == 1) {
-                                resultExpr = new BooleanExpression(currentOperator, result.Expr, nullptr);
-                            }
-                            else if (operandsNumber == 2) {
-                                resultExpr = new BooleanExpression(currentOperator, resultExpr, result.Expr);
-                            }
+                currentOperand = operandsNumber > 1 ? 1 : 0;
 
-                            currentOperator = OperatorType::NoOperator;
-                            operandsNumber = 0;
-                            currentOperand = 0;
-                        }
-                    }
-                    else {
-                        resultExpr = result.Expr;
-                    }
+                if (resultExpr == nullptr && operandsNumber > 1) {
+                    COMPILER_ERROR("Operator {0} needs {1} operands", token.Text, operandsNumber);
+                    exit(1);
                 }
 
-                str = "";
-                continue;
-            }
-            else if (isspace(c)) {
+                currentPos += 1;
                 continue;
             }
 
-            str.push_back(c);
-        }
-
-        if (!str.empty()) {
-            ParseResult result = ParseExpression(-1, str.length(), str);
+            ParseResult result = ParseExpression(currentPos, endPosition);
+            currentPos = result.Pos;
 
             if (currentOperator != OperatorType::NoOperator) {
                 currentOperand += 1;
@@ -940,11 +598,15 @@ namespace Hunter::Compiler {
                 if (currentOperand == operandsNumber) {
 
                     if (operandsNumber == 1) {
-                        resultExpr = new BooleanExpression(currentOperator, result.Expr, nullptr);
+                        resultExpr = m_Arena->Create<BooleanExpression>(currentOperator, result.Expr, nullptr);
                     }
                     else if (operandsNumber == 2) {
-                        resultExpr = new BooleanExpression(currentOperator, resultExpr, result.Expr);
+                        resultExpr = m_Arena->Create<BooleanExpression>(currentOperator, resultExpr, result.Expr);
                     }
+
+                    currentOperator = OperatorType::NoOperator;
+                    operandsNumber = 0;
+                    currentOperand = 0;
                 }
             }
             else {
@@ -958,237 +620,160 @@ namespace Hunter::Compiler {
         };
     }
 
-    ParseResult Parser::ParseVariableDeclaration(int currentPos,  int endPosition, const std::string &input, VariableHandlingType handlingType) {
-
-        std::string str;
-        std::string variableName;
-        Expression * value = nullptr;
+    ParseResult Parser::ParseVariableDeclaration(int currentPos,  int endPosition, VariableHandlingType handlingType) {
+        const Token & variableName = Expect(currentPos, endPosition, TokenKind::Identifier);
+        Expect(currentPos+1, endPosition, TokenKind::Assign);
 
-        bool isParsingVariable = false;
-
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-            if (isspace(c) && isParsingVariable) {
-                variableName = str;
-                str = "";
-                isParsingVariable = false;
-            } else if (isspace(c)) {
-                continue;
-            } else if (variableName.empty() && !isParsingVariable) {
-                isParsingVariable = true;
-            } else if (!str.empty() && c == '=') {
-                variableName = str;
-                str = "";
-                isParsingVariable = false;
-
-                ParseResult result = ParseFullExpression(currentPos+2, endPosition, input);
-                value = result.Expr;
-                currentPos = result.Pos+1;
-            } else if (!variableName.empty() && c == '=') {
-                ParseResult result = ParseFullExpression(currentPos+2, endPosition, input);
-                value = result.Expr;
-                currentPos = result.Pos+1;
-                i = result.Pos+1;
-            }
-
-            if (isParsingVariable) {
-                str.push_back(c);
-            }
-        }
+        ParseResult result = ParseFullExpression(currentPos+2, endPosition);
+        Expression * value = result.Expr;
 
         if (!value) {
-            COMPILER_ERROR("Could not parse variable value: {0}", input);
+            COMPILER_ERROR("Could not parse variable value: {0} (line {1})", variableName.Text, variableName.Line);
             exit(1);
         }
 
         Expression * expr;
         if (handlingType == VariableHandlingType::Const) {
-            expr = new ConstExpression(variableName, value);
+            expr = m_Arena->Create<ConstExpression>(variableName.Name, value);
         } else if (handlingType == VariableHandlingType::Let) {
-            expr = new LetExpression(variableName, value);
-        } else if (handlingType == VariableHandlingType::Assign) {
-            expr = new VariableMutationExpression(variableName, value);
+            expr = m_Arena->Create<LetExpression>(variableName.Name, value);
+        } else {
+            expr = m_Arena->Create<VariableMutationExpression>(variableName.Name, value);
         }
 
         return {
-                .Pos = currentPos,
+                .Pos = result.Pos,
                 .Expr = expr
         };
     }
 
-    ParseResult Parser::ParseInt(int currentPos,  int endPosition, const std::string &input) {
-
-        std::string str;
-        bool isNegative = false;
-
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-
-            if (c == '-') {
-                isNegative = true;
-                continue;
-            }
-
-            if (!isnumber(c)) {
-                break;
-            }
-
-            str.push_back(c);
-        }
-
-        int64_t value = std::stoll(str);
-
-        if (isNegative) {
-            value *= -1;
-        }
-
+    ParseResult Parser::ParseInt(int currentPos,  int endPosition) {
+        int64_t value = GetIntFromToken(Expect(currentPos, endPosition, TokenKind::Integer));
         IntType type = GetTypeFromValue(value);
 
         return {
-            .Pos = currentPos,
-            .Expr = new IntExpression(type, value)
+            .Pos = currentPos+1,
+            .Expr = m_Arena->Create<IntExpression>(type, value)
         };
     }
 
-    ParseResult Parser::ParseFunctionCall(int currentPos,  int endPosition, const std::string &input) {
-        std::vector<Expression *> parameters;
-
-        std::string str;
-        bool isParsingParameter = false;
+    ParseResult Parser::ParseFunctionCall(int currentPos,  int endPosition) {
+        const Token & functionName = m_Tokens[currentPos];
+        Expect(currentPos+1, endPosition, TokenKind::LeftParenthesis);
 
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-
-            if (isspace(c) || c == ',' || c == '(' || c == ')') {
-                isParsingParameter = false;
-                if (!str.empty()) {
-                    ParseResult result;
-
-                    if (str.starts_with("\"")) {
-
-                        if (!str.ends_with("\"")) {
-                            str.push_back(c);
-                            continue;
-                        }
-
-                        result = ParseString(0, str.length(), str);
-                    } else {
-                        result = ParseExpression(-1, str.length(), str);
-                    }
-
-                    if (!result.Expr) {
-                        COMPILER_ERROR("Could not parse expression: {0}", str);
-                        exit(1);
-                    }
-
-                    parameters.push_back(result.Expr);
+        std::vector<Expression *> parameters;
+        currentPos += 2;
 
-                    str = "";
-                }
+        while (m_Tokens[currentPos].Kind != TokenKind::RightParenthesis) {
+            ParseResult result = ParseExpression(currentPos, endPosition);
+            parameters.push_back(result.Expr);
+            currentPos = result.Pos;
 
-                continue;
-            } else if (!isParsingParameter) {
-                isParsingParameter = true;
+            if (m_Tokens[currentPos].Kind == TokenKind::Comma) {
+                currentPos += 1;
+            } else {
+                Expect(currentPos, endPosition, TokenKind::RightParenthesis);
             }
-
-            str.push_back(c);
         }
 
+        auto * funcCallExpr = m_Arena->Create<FunctionCallExpression>(parameters);
+        // print is a keyword, so the lexer did not intern it
+        funcCallExpr->SetFunction(
+            functionName.Name.IsValid() ? functionName.Name : m_SourceManager.GetSymbols().Intern(functionName.Text)
+        );
+
         return {
-                .Pos = currentPos,
-                .Expr = new FunctionCallExpression(parameters)
+                .Pos = currentPos+1,
+                .Expr = funcCallExpr
         };
     }
 
-    ParseResult Parser::ParseStructConstruction(int currentPos, int endPosition, const std::string &input) {
-        COMPILER_INFO("Input: {0}", input);
+    ParseResult Parser::ParseStructConstruction(int currentPos, int endPosition) {
+        const Token & structName = Expect(currentPos, endPosition, TokenKind::Identifier);
+        Expect(currentPos+1, endPosition, TokenKind::LeftParenthesis);
 
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
-            if (!isspace(c)) {
-                break;
-            }
-        }
-
-        ParseResult identifierResult = ParseIdentifier(currentPos, endPosition, input);
-        std::string structName = dynamic_cast<IdentifierExpression *>(identifierResult.Expr)->GetVariableName();
         std::vector<VariableMutationExpression *> attributes;
+        currentPos += 2;
 
-        currentPos = identifierResult.Pos;
-        std::string str;
-
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
+        while (m_Tokens[currentPos].Kind != TokenKind::RightParenthesis) {
+            ParseResult parseResult = ParseVariableDeclaration(currentPos, endPosition, VariableHandlingType::Assign);
+            attributes.push_back(DynCast<VariableMutationExpression>(parseResult.Expr));
+            currentPos = parseResult.Pos;
 
-            if (isspace(c)) {
-                continue;
-            }
-            else if (c == '(') {
-                str = "";
-                continue;
-            }
-            else if (c == ')') {
-                COMPILER_INFO("Current data: {0}", str);
-                ParseResult parseResult = ParseVariableDeclaration(-1, str.length(), str, VariableHandlingType::Assign);
-                i += 1;
-                currentPos += 1;
-
-                if (auto * attr = dynamic_cast<VariableMutationExpression *>(parseResult.Expr)) {
-                    attributes.push_back(attr);
-                } else {
-                    COMPILER_ERROR("Could not parse property assignment for struct");
-                    exit(1);
-                }
-
-                str = "";
-                break;
-            } else if (c == ',') {
-                COMPILER_INFO("Current data: {0}", str);
-                ParseResult parseResult = ParseVariableDeclaration(-1, str.length(), str, VariableHandlingType::Assign);
-                i += 1;
+            if (m_Tokens[currentPos].Kind == TokenKind::Comma) {
                 currentPos += 1;
+            } else {
+                Expect(currentPos, endPosition, TokenKind::RightParenthesis);
+            }
+        }
 
-                if (auto * attr = dynamic_cast<VariableMutationExpression *>(parseResult.Expr)) {
-                    attributes.push_back(attr);
-                } else {
-                    COMPILER_ERROR("Could not parse property assignment for struct");
-                    exit(1);
-                }
+        return {
+            .Pos = currentPos+1,
+            .Expr = m_Arena->Create<StructConstructionExpression>(structName.Name, attributes)
+        };
+    }
 
-                str = "";
-                continue;
-            }
+    ParseResult Parser::ParseIdentifier(int currentPos, int endPosition) {
+        const Token & identifier = Expect(currentPos, endPosition, TokenKind::Identifier);
+        Symbol object = identifier.Name;
+        Symbol property;
 
-            str.push_back(c);
+        // split property access once here, so code generation only works with symbols
+        if (size_t lastDotPosition = identifier.Text.find_last_of('.'); lastDotPosition != std::string_view::npos) {
+            SymbolTable & symbols = m_SourceManager.GetSymbols();
+            object = symbols.Intern(identifier.Text.substr(0, lastDotPosition));
+            property = symbols.Intern(identifier.Text.substr(lastDotPosition + 1));
         }
 
         return {
-            .Pos = currentPos,
-            .Expr = new StructConstructionExpression(structName, attributes)
+            .Pos = currentPos+1,
+            .Expr = m_Arena->Create<IdentifierExpression>(identifier.Name, object, property)
         };
     }
 
-    ParseResult Parser::ParseIdentifier(int currentPos, int endPosition, const std::string &input) {
-        std::string str;
+    const Token &Parser::Expect(int pos, int endPosition, TokenKind kind) {
+        const Token & token = m_Tokens[pos];
+
+        if (pos >= endPosition || token.Kind != kind) {
+            COMPILER_ERROR(
+                "Expected {0} but found {1} at line {2}, column {3}",
+                GetTokenKindString(kind),
+                pos >= endPosition ? "end of line" : GetTokenKindString(token.Kind),
+                token.Line,
+                token.Column
+            );
+            exit(1);
+        }
+
+        return token;
+    }
+
+    std::string_view Parser::GetTokensText(int startPos, int endPosition) {
+        if (startPos >= endPosition) {
+            return {};
+        }
 
-        for (int i = currentPos+1; i < endPosition; ++i, currentPos++) {
-            char c = input.at(i);
+        const Token & first = m_Tokens[startPos];
+        const Token & last = m_Tokens[endPosition-1];
 
-            if (!isalnum(c) && c != '_' && c != '.') {
-                break;
-            }
+        // all tokens of a line point into the same source, so the span between them is contiguous
+        return {first.Text.data(), static_cast<size_t>(last.Text.data() + last.Text.size() - first.Text.data())};
+    }
+
+    int64_t Parser::GetIntFromToken(const Token &token) {
+        int64_t value = 0;
+        auto [end, error] = std::from_chars(token.Text.data(), token.Text.data() + token.Text.size(), value);
 
-            str.push_back(c);
+        if (error != std::errc() || end != token.Text.data() + token.Text.size()) {
+            COMPILER_ERROR("Invalid int number {0} at line {1}, column {2}", token.Text, token.Line, token.Column);
+            exit(1);
         }
 
-        return {
-            .Pos = currentPos,
-            .Expr = new IdentifierExpression(str)
-        };
+        return value;
     }
 
     void Parser::EmitDebugData(Expression *expr) {
-        auto * debugData = new Hunter::Parser::Debug::DebugData;
+        auto * debugData = m_Arena->Create<Hunter::Parser::Debug::DebugData>();
         debugData->SetDirectory(m_CurrentDirectory);
         debugData->SetFileName(m_CurrentFileName);
         debugData->SetFileLine(m_CurrentLine);
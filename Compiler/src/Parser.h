@@ -6,9 +6,13 @@
 #include <vector>
 #include <stack>
 
+#include "Arena.h"
+#include "Lexer.h"
+
 namespace Hunter::Compiler {
 
     class Expression;
+    class SourceManager;
 
     class AbstractSyntaxTree {
     public:
@@ -24,9 +28,15 @@ namespace Hunter::Compiler {
             return m_Expressions;
         }
 
+        // all nodes of the tree are allocated in here and released together with the tree
+        Arena & GetArena() {
+            return m_Arena;
+        }
+
         void Dump();
 
     private:
+        Arena m_Arena;
         std::vector<Expression *> m_Expressions;
     };
 
@@ -43,47 +53,58 @@ namespace Hunter::Compiler {
 
     class Parser {
     public:
+        explicit Parser(SourceManager & sourceManager) : m_SourceManager(sourceManager) {}
+
         AbstractSyntaxTree * Parse(const std::string & filePath);
 
         void OnLineFinished(AbstractSyntaxTree * tree);
 
         Expression * ParseLine(const std::string & input);
-        ParseResult ParseExtern(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseImport(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseModule(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseExpression(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseFullExpression(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseString(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseStruct(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseFunctionHeader(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseFunctionReturn(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseIf(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseFor(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseRange(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseBoolean(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseVariableDeclaration(int currentPos, int endPosition, const std::string & input, VariableHandlingType handlingType);
-        ParseResult ParseInt(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseFunctionCall(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseStructConstruction(int currentPos, int endPosition, const std::string & input);
-        ParseResult ParseIdentifier(int currentPos, int endPosition, const std::string & input);
+        Expression * ParseLine(int currentPos, int endPosition);
+        ParseResult ParseExtern(int currentPos, int endPosition);
+        ParseResult ParseImport(int currentPos, int endPosition);
+        ParseResult ParseModule(int currentPos, int endPosition);
+        ParseResult ParseExpression(int currentPos, int endPosition);
+        ParseResult ParseFullExpression(int currentPos, int endPosition);
+        ParseResult ParseList(int currentPos, int endPosition);
+        ParseResult ParseString(int currentPos, int endPosition);
+        ParseResult ParseStruct(int currentPos, int endPosition);
+        ParseResult ParseFunctionHeader(int currentPos, int endPosition);
+        ParseResult ParseFunctionReturn(int currentPos, int endPosition);
+        ParseResult ParseIf(int currentPos, int endPosition);
+        ParseResult ParseFor(int currentPos, int endPosition);
+        ParseResult ParseRange(int currentPos, int endPosition);
+        ParseResult ParseBoolean(int currentPos, int endPosition);
+        ParseResult ParseVariableDeclaration(int currentPos, int endPosition, VariableHandlingType handlingType);
+        ParseResult ParseInt(int currentPos, int endPosition);
+        ParseResult ParseFunctionCall(int currentPos, int endPosition);
+        ParseResult ParseStructConstruction(int currentPos, int endPosition);
+        ParseResult ParseIdentifier(int currentPos, int endPosition);
 
     protected:
         void EmitDebugData(Expression * expr);
 
+        const Token & Expect(int pos, int endPosition, TokenKind kind);
+        std::string_view GetTokensText(int startPos, int endPosition);
+        int64_t GetIntFromToken(const Token & token);
+
     private:
-        std::string m_DataStr;
+        SourceManager & m_SourceManager;
+        // single lines parsed without a tree keep their nodes in here
+        Arena m_LineArena;
+        Arena * m_Arena = &m_LineArena;
+        std::vector<Token> m_Tokens;
         Expression * m_CurrentExpression = nullptr;
         std::stack<Expression *> m_BlockExpressions;
         std::stack<int> m_BlockLevels;
 
         bool m_IsParsingBlock = false;
-        bool m_IsFullLineComment = false;
         int m_CurrentLevel = 0;
 
-        std::string m_CurrentDirectory;
-        std::string m_CurrentFileName;
-        int64_t m_CurrentLine;
-        int64_t m_CurrentColumn;
+        std::string_view m_CurrentDirectory;
+        std::string_view m_CurrentFileName;
+        int64_t m_CurrentLine = 0;
+        int64_t m_CurrentColumn = 0;
     };
 
 }
\ No newline at end of file
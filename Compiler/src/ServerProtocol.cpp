@@ -0,0 +1,191 @@
+#include "ServerProtocol.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Hunter::Compiler {
+
+    constexpr char RequestMagic[4] = {'H', 'C', 'S', 'R'};
+    // has to be increased whenever the layout of a request changes, client and server have to match
+    constexpr uint32_t ProtocolVersion = 1;
+    // far more than any command line, protects the server from clients sending garbage
+    constexpr uint64_t MaximumPayloadSize = 16 * 1024 * 1024;
+
+    struct RequestHeader {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t ArgumentCount;
+        uint32_t EnvironmentCount;
+        uint64_t PayloadSize;
+    };
+
+    static bool WriteAll(int socket, const void * data, size_t size) {
+        for (size_t written = 0; written < size;) {
+            ssize_t result = write(socket, static_cast<const char *>(data) + written, size - written);
+
+            if (result <= 0) {
+                return false;
+            }
+
+            written += static_cast<size_t>(result);
+        }
+
+        return true;
+    }
+
+    static bool ReadAll(int socket, void * data, size_t size) {
+        for (size_t read = 0; read < size;) {
+            ssize_t result = recv(socket, static_cast<char *>(data) + read, size - read, 0);
+
+            if (result <= 0) {
+                return false;
+            }
+
+            read += static_cast<size_t>(result);
+        }
+
+        return true;
+    }
+
+    std::string GetDefaultServerSocketPath() {
+        if (const char * socketPath = getenv("HUNTER_SERVER_SOCKET"); socketPath && *socketPath) {
+            return socketPath;
+        }
+
+        std::error_code error;
+        std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+
+        return ((error ? std::filesystem::path("/tmp") : directory) / ("hunterd-" + std::to_string(getuid()) + ".sock")).string();
+    }
+
+    bool SendRequest(int socket, const CompileRequest & request) {
+        std::string payload = request.WorkingDirectory;
+        payload.push_back('\0');
+
+        for (const auto &strings : {&request.Arguments, &request.Environment}) {
+            for (const auto &str : *strings) {
+                payload.append(str);
+                payload.push_back('\0');
+            }
+        }
+
+        RequestHeader header{};
+        std::memcpy(header.Magic, RequestMagic, sizeof(header.Magic));
+        header.Version = ProtocolVersion;
+        header.ArgumentCount = static_cast<uint32_t>(request.Arguments.size());
+        header.EnvironmentCount = static_cast<uint32_t>(request.Environment.size());
+        header.PayloadSize = payload.size();
+
+        // the file descriptors travel with the header, the kernel duplicates them into the server
+        iovec headerData{&header, sizeof(header)};
+        char control[CMSG_SPACE(sizeof(request.FileDescriptors))] = {};
+
+        msghdr message{};
+        message.msg_iov = &headerData;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        cmsghdr * controlMessage = CMSG_FIRSTHDR(&message);
+        controlMessage->cmsg_level = SOL_SOCKET;
+        controlMessage->cmsg_type = SCM_RIGHTS;
+        controlMessage->cmsg_len = CMSG_LEN(sizeof(request.FileDescriptors));
+        std::memcpy(CMSG_DATA(controlMessage), request.FileDescriptors, sizeof(request.FileDescriptors));
+
+        if (sendmsg(socket, &message, 0) != static_cast<ssize_t>(sizeof(header))) {
+            return false;
+        }
+
+        return WriteAll(socket, payload.data(), payload.size());
+    }
+
+    bool ReceiveRequest(int socket, CompileRequest & request) {
+        RequestHeader header{};
+        iovec headerData{&header, sizeof(header)};
+        char control[CMSG_SPACE(sizeof(request.FileDescriptors))] = {};
+
+        msghdr message{};
+        message.msg_iov = &headerData;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t received = recvmsg(socket, &message, 0);
+        cmsghdr * controlMessage = CMSG_FIRSTHDR(&message);
+        bool hasFileDescriptors = controlMessage
+            && controlMessage->cmsg_level == SOL_SOCKET
+            && controlMessage->cmsg_type == SCM_RIGHTS
+            && controlMessage->cmsg_len == CMSG_LEN(sizeof(request.FileDescriptors));
+
+        if (hasFileDescriptors) {
+            std::memcpy(request.FileDescriptors, CMSG_DATA(controlMessage), sizeof(request.FileDescriptors));
+        }
+
+        std::string payload;
+        bool isValid = received == static_cast<ssize_t>(sizeof(header))
+            && hasFileDescriptors
+            && !(message.msg_flags & MSG_CTRUNC)
+            && std::memcmp(header.Magic, RequestMagic, sizeof(header.Magic)) == 0
+            && header.Version == ProtocolVersion
+            && header.PayloadSize <= MaximumPayloadSize;
+
+        if (isValid) {
+            payload.resize(header.PayloadSize);
+            isValid = ReadAll(socket, payload.data(), payload.size());
+        }
+
+        // the strings are split at the terminators, there has to be one for every string
+        std::vector<std::string> strings;
+
+        for (size_t start = 0; isValid && start < payload.size();) {
+            size_t end = payload.find('\0', start);
+
+            if (end == std::string::npos) {
+                isValid = false;
+                break;
+            }
+
+            strings.emplace_back(payload, start, end - start);
+            start = end + 1;
+        }
+
+        if (!isValid || strings.size() != 1ull + header.ArgumentCount + header.EnvironmentCount) {
+            for (int & fileDescriptor : request.FileDescriptors) {
+                if (fileDescriptor != -1) {
+                    close(fileDescriptor);
+                    fileDescriptor = -1;
+                }
+            }
+
+            return false;
+        }
+
+        request.WorkingDirectory = std::move(strings[0]);
+        request.Arguments.assign(strings.begin() + 1, strings.begin() + 1 + header.ArgumentCount);
+        request.Environment.assign(strings.begin() + 1 + header.ArgumentCount, strings.end());
+
+        return true;
+    }
+
+    bool SendExitCode(int socket, int exitCode) {
+        int32_t code = exitCode;
+        return WriteAll(socket, &code, sizeof(code));
+    }
+
+    bool ReceiveExitCode(int socket, int & exitCode) {
+        int32_t code;
+
+        if (!ReadAll(socket, &code, sizeof(code))) {
+            return false;
+        }
+
+        exitCode = code;
+        return true;
+    }
+
+}
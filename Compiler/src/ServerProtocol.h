@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Hunter::Compiler {
+
+    // the socket of the compile server if none is given: $HUNTER_SERVER_SOCKET or one per user in the temporary directory
+    std::string GetDefaultServerSocketPath();
+
+    // everything a compilation needs from the process which asked for it
+    struct CompileRequest {
+        std::string WorkingDirectory;
+        // like argv, starting with the name of the program
+        std::vector<std::string> Arguments;
+        std::vector<std::string> Environment;
+        // stdin, stdout and stderr of the client, the compilation writes directly into them
+        int FileDescriptors[3] = {-1, -1, -1};
+    };
+
+    /**
+     * A request is sent as a single message over a Unix socket, which carries the file
+     * descriptors along, followed by the strings. The server answers with the exit code
+     * of the compilation once it is done. All functions return false if the other side
+     * went away or did not follow the protocol.
+     */
+    bool SendRequest(int socket, const CompileRequest & request);
+    bool ReceiveRequest(int socket, CompileRequest & request);
+
+    bool SendExitCode(int socket, int exitCode);
+    bool ReceiveExitCode(int socket, int & exitCode);
+
+}
@@ -0,0 +1,33 @@
+#include "SourceManager.h"
+#include "./utils/files.h"
+
+#include <filesystem>
+
+namespace Hunter::Compiler {
+
+    SourceManager::~SourceManager() {
+        for (const auto &[path, data] : m_Files) {
+            unmapFile(data);
+        }
+    }
+
+    std::string_view SourceManager::LoadFile(const std::string &filePath) {
+        std::string normalizedPath = std::filesystem::path(filePath).lexically_normal().string();
+        std::lock_guard lock(m_Mutex);
+
+        if (auto file = m_Files.find(normalizedPath); file != m_Files.end()) {
+            return file->second;
+        }
+
+        std::string_view data = mapFileIntoMemory(normalizedPath);
+        m_Files[normalizedPath] = data;
+
+        return data;
+    }
+
+    std::string_view SourceManager::StoreString(std::string str) {
+        std::lock_guard lock(m_Mutex);
+        return m_Strings.emplace_back(std::move(str));
+    }
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "SymbolTable.h"
+
+namespace Hunter::Compiler {
+
+    /**
+     * Owns the text of every source used during a compilation. Files are memory mapped
+     * only once, all handed out views stay valid until the manager is destroyed,
+     * so AST nodes can point directly into the sources instead of copying them.
+     * The identifiers found in the sources are interned in its symbol table.
+     * It is shared by all parsers, so every method can be called from multiple threads.
+     */
+    class SourceManager {
+    public:
+        SourceManager() = default;
+        SourceManager(const SourceManager &) = delete;
+        SourceManager & operator=(const SourceManager &) = delete;
+        ~SourceManager();
+
+        std::string_view LoadFile(const std::string & filePath);
+
+        // keeps a string alive for the whole compilation, e.g. string literals with resolved escapes
+        std::string_view StoreString(std::string str);
+
+        SymbolTable & GetSymbols() { return m_Symbols; }
+
+    private:
+        std::mutex m_Mutex;
+        SymbolTable m_Symbols;
+        std::unordered_map<std::string, std::string_view> m_Files;
+        std::deque<std::string> m_Strings;
+    };
+
+}
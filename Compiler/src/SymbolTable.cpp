@@ -0,0 +1,41 @@
+#include "SymbolTable.h"
+
+#include <functional>
+
+namespace Hunter::Compiler {
+
+    Symbol SymbolTable::Intern(std::string_view name) {
+        Shard & shard = GetShard(name);
+        std::lock_guard lock(shard.Mutex);
+
+        if (auto entry = shard.Lookup.find(name); entry != shard.Lookup.end()) {
+            return Symbol(entry->second);
+        }
+
+        std::string_view storedName = shard.Names.emplace_back(name);
+        const Symbol::Entry * entry = &shard.Entries.emplace_back(Symbol::Entry{
+            .Id = m_NextId++,
+            .Name = storedName
+        });
+
+        shard.Lookup.emplace(storedName, entry);
+
+        return Symbol(entry);
+    }
+
+    Symbol SymbolTable::Find(std::string_view name) const {
+        Shard & shard = GetShard(name);
+        std::lock_guard lock(shard.Mutex);
+
+        if (auto entry = shard.Lookup.find(name); entry != shard.Lookup.end()) {
+            return Symbol(entry->second);
+        }
+
+        return {};
+    }
+
+    SymbolTable::Shard & SymbolTable::GetShard(std::string_view name) const {
+        return m_Shards[std::hash<std::string_view>{}(name) % ShardCount];
+    }
+
+}
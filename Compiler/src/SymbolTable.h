@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Hunter::Compiler {
+
+    /**
+     * Handle of an interned identifier. Equal names always share the same symbol,
+     * so symbols can be compared and used as keys without touching the text again.
+     */
+    class Symbol {
+    public:
+        Symbol() = default;
+
+        // ids are dense and start at 1, 0 is left for the empty symbol
+        uint32_t GetId() const { return m_Entry ? m_Entry->Id : 0; }
+        std::string_view GetName() const { return m_Entry ? m_Entry->Name : std::string_view(); }
+        bool IsValid() const { return m_Entry != nullptr; }
+
+        bool operator==(const Symbol & other) const { return m_Entry == other.m_Entry; }
+
+    private:
+        struct Entry {
+            uint32_t Id;
+            std::string_view Name;
+        };
+
+        explicit Symbol(const Entry * entry) : m_Entry(entry) {}
+
+        const Entry * m_Entry = nullptr;
+
+        friend class SymbolTable;
+    };
+
+    /**
+     * Interns every identifier of a compilation. The names are copied once,
+     * all symbols stay valid until the table is destroyed. Modules are lexed in parallel,
+     * so the table is split into independently locked shards to keep contention low.
+     */
+    class SymbolTable {
+    public:
+        SymbolTable() = default;
+        SymbolTable(const SymbolTable &) = delete;
+        SymbolTable & operator=(const SymbolTable &) = delete;
+
+        Symbol Intern(std::string_view name);
+
+        // returns the empty symbol if the name was never interned
+        Symbol Find(std::string_view name) const;
+
+        size_t GetSize() const { return m_NextId - 1; }
+
+    private:
+        struct Shard {
+            std::mutex Mutex;
+            std::deque<std::string> Names;
+            std::deque<Symbol::Entry> Entries;
+            std::unordered_map<std::string_view, const Symbol::Entry *> Lookup;
+        };
+
+        static constexpr size_t ShardCount = 16;
+
+        Shard & GetShard(std::string_view name) const;
+
+        mutable std::array<Shard, ShardCount> m_Shards;
+        std::atomic<uint32_t> m_NextId = 1;
+    };
+
+    /**
+     * Map from symbols to pointers backed by a vector indexed with the symbol id,
+     * a missing entry is simply a nullptr.
+     */
+    template<typename T>
+    class SymbolMap {
+    public:
+        T * Get(Symbol symbol) const {
+            uint32_t id = symbol.GetId();
+            return id < m_Values.size() ? m_Values[id] : nullptr;
+        }
+
+        bool Contains(Symbol symbol) const {
+            return Get(symbol) != nullptr;
+        }
+
+        void Set(Symbol symbol, T * value) {
+            uint32_t id = symbol.GetId();
+
+            if (id >= m_Values.size()) {
+                m_Values.resize(id + 1, nullptr);
+            }
+
+            m_Values[id] = value;
+        }
+
+        void Erase(Symbol symbol) {
+            uint32_t id = symbol.GetId();
+
+            if (id < m_Values.size()) {
+                m_Values[id] = nullptr;
+            }
+        }
+
+    private:
+        std::vector<T *> m_Values;
+    };
+
+}
@@ -0,0 +1,131 @@
+#include "ThreadPool.h"
+#include "TimeTrace.h"
+
+namespace Hunter::Compiler {
+
+    namespace {
+        // lets Submit find the queue of the worker it is called from
+        thread_local ThreadPool * t_CurrentPool = nullptr;
+        thread_local size_t t_CurrentWorker = 0;
+    }
+
+    ThreadPool::ThreadPool(size_t threadCount) {
+        if (threadCount == 0) {
+            threadCount = 1;
+        }
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            m_Queues.push_back(std::make_unique<WorkQueue>());
+        }
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            m_Threads.emplace_back(&ThreadPool::Run, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_IsStopping = true;
+        }
+
+        m_TaskAvailable.notify_all();
+
+        for (auto &thread : m_Threads) {
+            thread.join();
+        }
+    }
+
+    size_t ThreadPool::GetDefaultThreadCount() {
+        size_t count = std::thread::hardware_concurrency();
+        return count > 0 ? count : 1;
+    }
+
+    void ThreadPool::Submit(std::function<void()> task) {
+        size_t queueIndex;
+
+        {
+            std::lock_guard lock(m_Mutex);
+            queueIndex = t_CurrentPool == this ? t_CurrentWorker : m_NextQueue++ % m_Queues.size();
+            m_QueuedTasks += 1;
+            m_UnfinishedTasks += 1;
+
+            // pushed while still holding the counter lock, so a woken worker always finds the task
+            std::lock_guard queueLock(m_Queues[queueIndex]->Mutex);
+            m_Queues[queueIndex]->Tasks.push_back(std::move(task));
+        }
+
+        m_TaskAvailable.notify_one();
+    }
+
+    void ThreadPool::Wait() {
+        std::unique_lock lock(m_Mutex);
+        m_AllTasksDone.wait(lock, [this] { return m_UnfinishedTasks == 0; });
+    }
+
+    void ThreadPool::Run(size_t workerIndex) {
+        t_CurrentPool = this;
+        t_CurrentWorker = workerIndex;
+        TimeTrace::StartThread();
+
+        while (true) {
+            {
+                std::unique_lock lock(m_Mutex);
+                m_TaskAvailable.wait(lock, [this] { return m_IsStopping || m_QueuedTasks > 0; });
+
+                if (m_QueuedTasks == 0) {
+                    TimeTrace::FinishThread();
+                    return;
+                }
+
+                m_QueuedTasks -= 1;
+            }
+
+            // a task is reserved for this worker now, so one of the queues has to contain it
+            std::function<void()> task;
+            while (!TryTakeTask(workerIndex, task)) {
+                std::this_thread::yield();
+            }
+
+            task();
+
+            bool isLastTask;
+            {
+                std::lock_guard lock(m_Mutex);
+                m_UnfinishedTasks -= 1;
+                isLastTask = m_UnfinishedTasks == 0;
+            }
+
+            if (isLastTask) {
+                m_AllTasksDone.notify_all();
+            }
+        }
+    }
+
+    bool ThreadPool::TryTakeTask(size_t workerIndex, std::function<void()> &task) {
+        {
+            WorkQueue & ownQueue = *m_Queues[workerIndex];
+            std::lock_guard lock(ownQueue.Mutex);
+
+            if (!ownQueue.Tasks.empty()) {
+                task = std::move(ownQueue.Tasks.back());
+                ownQueue.Tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t offset = 1; offset < m_Queues.size(); ++offset) {
+            WorkQueue & otherQueue = *m_Queues[(workerIndex + offset) % m_Queues.size()];
+            std::lock_guard lock(otherQueue.Mutex);
+
+            if (!otherQueue.Tasks.empty()) {
+                task = std::move(otherQueue.Tasks.front());
+                otherQueue.Tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+}
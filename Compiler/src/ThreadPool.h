@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Hunter::Compiler {
+
+    /**
+     * Fixed size pool where every worker owns a task queue. Tasks submitted from a worker
+     * go to its own queue and are taken newest first, idle workers steal the oldest
+     * tasks of the others. Tasks may submit further tasks, Wait returns once all of them are done.
+     */
+    class ThreadPool {
+    public:
+        explicit ThreadPool(size_t threadCount = GetDefaultThreadCount());
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool & operator=(const ThreadPool &) = delete;
+        ~ThreadPool();
+
+        void Submit(std::function<void()> task);
+        void Wait();
+
+        size_t GetThreadCount() const { return m_Threads.size(); }
+
+        static size_t GetDefaultThreadCount();
+
+    private:
+        struct WorkQueue {
+            std::mutex Mutex;
+            std::deque<std::function<void()>> Tasks;
+        };
+
+        void Run(size_t workerIndex);
+        bool TryTakeTask(size_t workerIndex, std::function<void()> & task);
+
+        std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+        std::vector<std::thread> m_Threads;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_TaskAvailable;
+        std::condition_variable m_AllTasksDone;
+        // both are guarded by m_Mutex, queued tasks are not yet taken by a worker
+        size_t m_QueuedTasks = 0;
+        size_t m_UnfinishedTasks = 0;
+        size_t m_NextQueue = 0;
+        bool m_IsStopping = false;
+    };
+
+}
@@ -0,0 +1,47 @@
+#include "TimeTrace.h"
+#include "./utils/logger.h"
+
+#include <llvm/Support/Error.h>
+
+namespace Hunter::Compiler {
+
+    std::atomic<bool> TimeTrace::s_IsEnabled = false;
+    unsigned TimeTrace::s_Granularity = TimeTrace::DefaultGranularity;
+
+    TimeTrace::TimeTrace(std::string filePath, unsigned granularity) : m_FilePath(std::move(filePath)) {
+        if (m_FilePath.empty()) {
+            return;
+        }
+
+        s_Granularity = granularity;
+        s_IsEnabled = true;
+        StartThread();
+    }
+
+    TimeTrace::~TimeTrace() {
+        if (m_FilePath.empty()) {
+            return;
+        }
+
+        // the events of the other threads were handed over when they finished
+        if (auto error = llvm::timeTraceProfilerWrite(m_FilePath, "")) {
+            COMPILER_ERROR("Could not write the time trace - '{0}': {1}", m_FilePath, llvm::toString(std::move(error)));
+        }
+
+        llvm::timeTraceProfilerCleanup();
+        s_IsEnabled = false;
+    }
+
+    void TimeTrace::StartThread() {
+        if (s_IsEnabled && !llvm::timeTraceProfilerEnabled()) {
+            llvm::timeTraceProfilerInitialize(s_Granularity, "Hunter_Compiler");
+        }
+    }
+
+    void TimeTrace::FinishThread() {
+        if (llvm::timeTraceProfilerEnabled()) {
+            llvm::timeTraceProfilerFinishThread();
+        }
+    }
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <llvm/Support/TimeProfiler.h>
+
+#include <atomic>
+#include <string>
+
+namespace Hunter::Compiler {
+
+    /**
+     * Records the phases of a compilation as a Chrome trace, which can be opened in chrome://tracing
+     * or Perfetto. Events are added with llvm::TimeTraceScope, the pass managers of LLVM add one for
+     * every pass. LLVM keeps the events per thread, so the threads of the ThreadPool register themselves.
+     */
+    class TimeTrace {
+    public:
+        // only records when a file is given, the trace is written to it when the object is destroyed
+        TimeTrace(std::string filePath, unsigned granularity);
+        ~TimeTrace();
+
+        // events shorter than this many microseconds are left out
+        static constexpr unsigned DefaultGranularity = 500;
+
+        static void StartThread();
+        static void FinishThread();
+
+    private:
+        std::string m_FilePath;
+
+        static std::atomic<bool> s_IsEnabled;
+        static unsigned s_Granularity;
+    };
+
+}
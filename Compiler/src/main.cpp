@@ -2,44 +2,593 @@
 #include "ImportResolver.h"
 #include "CodeGenerator.h"
 #include "Compiler.h"
-#include "./utils/files.h"
+#include "SourceManager.h"
+#include "CompilationCache.h"
+#include "CompileServer.h"
+#include "JitRunner.h"
+#include "ThreadPool.h"
+#include "TimeTrace.h"
 #include "./utils/logger.h"
 
+#include <llvm/Bitcode/BitcodeWriter.h>
+
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
+#include <string_view>
 
-int main(int argc, const char ** argv) {
+// the artifacts --emit can ask for and the extensions of their files, without -o they are called output
+static const std::vector<std::pair<std::string, std::string>> EmitKinds = {
+    {"obj", ".o"},
+    {"bc", ".bc"},
+    {"ll", ".ll"},
+    {"asm", ".s"},
+    {"exe", ""},
+};
+
+// the options which take the next argument as their value
+static const std::set<std::string_view> OptionsWithValue = {"--output-ir", "-o", "-j", "--cache-dir"};
+
+// one program of the command line, it is either restored from the cache or goes through all phases
+struct Program {
+    std::string FilePath;
+    // every requested artifact with its file
+    std::map<std::string, std::string> EmitFiles;
+    std::string IrOutputFile;
+    std::string CacheKey;
+    bool IsRestored = false;
+
+    std::unique_ptr<Hunter::Compiler::AbstractSyntaxTree> Ast;
+    std::vector<Hunter::Compiler::CompilationUnit> Units;
+    std::vector<std::string> OutputFiles;
+};
+
+// the files of the other modules are written next to the one of the main module, output.bc becomes output.<module>.bc
+static std::string GetModuleOutputFile(const std::string & mainFile, const Hunter::Compiler::CompilationUnit & unit) {
+    if (unit.IsMain) {
+        return mainFile;
+    }
+
+    std::filesystem::path path(mainFile);
+    return (path.parent_path() / (path.stem().string() + "." + unit.Module + path.extension().string())).string();
+}
+
+// prints why the file could not be opened, the stream is never written then
+static bool CheckOutputFile(const std::string & file, const std::error_code & error) {
+    if (error) {
+        std::cerr << "Could not open " << file << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// bodies of serialized trees are decoded on their first access, which must not happen on several threads at once
+static void DecodeBodies(const std::vector<Hunter::Compiler::Expression *> & instructions) {
+    for (auto * instruction : instructions) {
+        if (auto * block = Hunter::Compiler::DynCast<Hunter::Compiler::BlockExpression>(instruction)) {
+            DecodeBodies(block->GetBody());
+
+            if (auto * ifExpr = Hunter::Compiler::DynCast<Hunter::Compiler::IfExpression>(block); ifExpr && ifExpr->GetElse()) {
+                DecodeBodies({ifExpr->GetElse()});
+            }
+        }
+    }
+}
+
+// every unit gets its own generator and with it its own context, unless they share the context of the program
+static void GenerateModules(
+    Hunter::Compiler::SourceManager & sourceManager,
+    const std::vector<Hunter::Compiler::CompilationUnit> & units,
+    const Hunter::Compiler::ProgramDeclarations & declarations,
+    llvm::LLVMContext * programContext,
+    size_t threadCount,
+    std::vector<std::unique_ptr<Hunter::Compiler::CodeGenerator>> & codeGenerators,
+    std::vector<llvm::Module *> & modules
+) {
+    codeGenerators.resize(units.size());
+    modules.resize(units.size());
+
+    // a shared context can only be used by one thread at a time
+    Hunter::Compiler::ThreadPool pool(programContext ? 1 : threadCount);
+
+    for (size_t i = 0; i < units.size(); ++i) {
+        pool.Submit([&, i]() {
+            codeGenerators[i] = programContext
+                ? std::make_unique<Hunter::Compiler::CodeGenerator>(sourceManager.GetSymbols(), *programContext)
+                : std::make_unique<Hunter::Compiler::CodeGenerator>(sourceManager.GetSymbols());
+            codeGenerators[i]->SetDeclarations(&declarations);
+            modules[i] = codeGenerators[i]->GenerateCode(units[i]);
+        });
+    }
+
+    pool.Wait();
+}
+
+// generates the code of a resolved program and writes all requested outputs, returns false if one of them could not be written
+static bool BuildProgram(
+    Program & program,
+    const Hunter::Compiler::TargetSettings & target,
+    Hunter::Compiler::SourceManager & sourceManager,
+    Hunter::Compiler::CompilationCache * cache,
+    size_t threadCount
+) {
+    llvm::TimeTraceScope buildScope("BuildProgram", program.FilePath);
+    const auto &units = program.Units;
+    auto emitFile = [&](const std::string & kind) {
+        auto file = program.EmitFiles.find(kind);
+        return file != program.EmitFiles.end() ? file->second : std::string();
+    };
+    const auto &irOutputFile = program.IrOutputFile;
+    auto &outputFiles = program.OutputFiles;
+
+    Hunter::Compiler::ProgramDeclarations declarations;
+    for (const auto &unit : units) {
+        declarations.AddUnit(unit);
+    }
+
+    // modules are only linked in memory for link time optimization, which needs them in one context
+    std::unique_ptr<llvm::LLVMContext> programContext;
+    if (target.LinkTimeOptimization) {
+        programContext = std::make_unique<llvm::LLVMContext>();
+    }
+
+    std::vector<std::unique_ptr<Hunter::Compiler::CodeGenerator>> codeGenerators;
+    std::vector<llvm::Module *> modules;
+    GenerateModules(sourceManager, units, declarations, programContext.get(), threadCount, codeGenerators, modules);
+
+    std::error_code error;
+
+    // the IR is written as the code generator produced it, before the backend optimizes it
+    for (size_t i = 0; i < units.size() && !emitFile("bc").empty(); ++i) {
+        llvm::TimeTraceScope timeScope("WriteBitcode", units[i].IsMain ? "main" : units[i].Module);
+        std::string bitcodeFile = GetModuleOutputFile(emitFile("bc"), units[i]);
+        llvm::raw_fd_ostream bitcodeStream(bitcodeFile, error);
+
+        if (!CheckOutputFile(bitcodeFile, error)) {
+            return false;
+        }
+
+        llvm::WriteBitcodeToFile(*modules[i], bitcodeStream);
+        outputFiles.push_back(bitcodeFile);
+    }
+
+    for (size_t i = 0; i < units.size() && !emitFile("ll").empty(); ++i) {
+        llvm::TimeTraceScope timeScope("WriteIR", units[i].IsMain ? "main" : units[i].Module);
+        std::string moduleTextFile = GetModuleOutputFile(emitFile("ll"), units[i]);
+        llvm::raw_fd_ostream moduleTextStream(moduleTextFile, error);
+
+        if (!CheckOutputFile(moduleTextFile, error)) {
+            return false;
+        }
+
+        modules[i]->print(moduleTextStream, nullptr);
+        outputFiles.push_back(moduleTextFile);
+    }
+
+    // taken before the backend adds the target information, so a restored entry prints the same IR.
+    // only the cache needs the whole text at once, otherwise the modules are streamed into the output
+    std::string moduleText;
+    if (cache || !irOutputFile.empty()) {
+        llvm::TimeTraceScope timeScope("PrintModules");
+        std::unique_ptr<llvm::raw_ostream> moduleTextStream;
 
-    if (argc < 2) {
+        if (cache) {
+            moduleTextStream = std::make_unique<llvm::raw_string_ostream>(moduleText);
+        } else {
+            moduleTextStream = std::make_unique<llvm::raw_fd_ostream>(irOutputFile, error);
+
+            if (!CheckOutputFile(irOutputFile, error)) {
+                return false;
+            }
+        }
+
+        for (const auto &module : modules) {
+            module->print(*moduleTextStream, nullptr);
+        }
+
+        moduleTextStream->flush();
+
+        if (cache && !irOutputFile.empty()) {
+            llvm::raw_fd_ostream irOutputStream(irOutputFile, error);
+
+            if (!CheckOutputFile(irOutputFile, error)) {
+                return false;
+            }
+
+            irOutputStream << moduleText;
+        }
+    }
+
+    Hunter::Compiler::ProgramOutputs programOutputs;
+    programOutputs.Object = emitFile("obj");
+    programOutputs.Executable = emitFile("exe");
+
+    if (!emitFile("asm").empty()) {
+        // a program linked for link time optimization only has a single module left
+        for (size_t i = 0; i < (programContext ? 1 : units.size()); ++i) {
+            programOutputs.Assembly.push_back(programContext ? emitFile("asm") : GetModuleOutputFile(emitFile("asm"), units[i]));
+        }
+    }
+
+    bool needsBackend = !programOutputs.Object.empty() || !programOutputs.Executable.empty() || !programOutputs.Assembly.empty();
+
+    if (needsBackend && programContext) {
+        llvm::Module * linkedProgram = Hunter::Compiler::LinkProgram(modules, target);
+
+        if (!linkedProgram) {
+            return false;
+        }
+
+        modules = {linkedProgram};
+    }
+
+    if (needsBackend && !Hunter::Compiler::CompileModules(modules, programOutputs, target, threadCount)) {
+        return false;
+    }
+
+    for (const auto &file : {programOutputs.Object, programOutputs.Executable}) {
+        if (!file.empty()) {
+            outputFiles.push_back(file);
+        }
+    }
+
+    outputFiles.insert(outputFiles.end(), programOutputs.Assembly.begin(), programOutputs.Assembly.end());
+
+    if (cache) {
+        llvm::TimeTraceScope timeScope("StoreCache");
+        cache->Store(program.CacheKey, outputFiles, moduleText);
+    }
+
+    return true;
+}
+
+
+// compiles the programs of the command line, the compile server calls it in a child process for every request
+static int Compile(int argc, const char ** argv, Hunter::Compiler::ModuleTreeCache * treeCache) {
+
+    // "run" compiles the program in memory and executes it right away instead of writing files
+    bool runProgram = argc > 1 && strcmp(argv[1], "run") == 0;
+    int fileArgument = runProgram ? 2 : 1;
+
+    if (argc <= fileArgument) {
         std::cerr << "Did not find parameter for file" << std::endl;
         exit(1);
     }
 
     Hunter::Compiler::Logger::Init();
 
-    Hunter::Compiler::Parser parser;
-    Hunter::Compiler::ImportResolver importResolver;
-    Hunter::Compiler::CodeGenerator codeGenerator;
+    // owns the sources, AST nodes point into them until the compilation is done
+    Hunter::Compiler::SourceManager sourceManager;
+    Hunter::Compiler::Parser parser(sourceManager);
+    // shared by all programs, so the modules they have in common are only parsed once
+    Hunter::Compiler::ImportResolver importResolver(sourceManager);
+
+    std::vector<std::string> inputFiles = {argv[fileArgument]};
+    size_t jobs = Hunter::Compiler::ThreadPool::GetDefaultThreadCount();
+    std::string irOutputFile;
+    std::string outputFile;
+    std::set<std::string> emit;
+    // several builds can share one cache, so it can be set for all of them through the environment
+    std::string cacheDirectory = getenv("HUNTER_CACHE_DIR") ? getenv("HUNTER_CACHE_DIR") : "";
+
+    Hunter::Compiler::TargetSettings target;
+    std::string cpu;
+    std::vector<std::string> explicitFeatures;
+    uint64_t tierUpThreshold = 0;
+    std::string timeTraceFile;
+    int verbosity = 0;
+    bool dumpAst = false;
+    unsigned timeTraceGranularity = Hunter::Compiler::TimeTrace::DefaultGranularity;
 
-    if (argc > 3) {
-        if (strcmp(argv[2], "--output-ir") == 0) {
-            codeGenerator.SetDebugOutputFile(argv[3]);
+    for (int i = fileArgument + 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--output-ir") == 0 && i + 1 < argc) {
+            irOutputFile = argv[++i];
+        } else if (strcmp(argv[i], "--dump-ir") == 0) {
+            // the IR goes to stdout, unless it is written to a file anyway
+            if (irOutputFile.empty()) {
+                irOutputFile = "-";
+            }
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jobs = std::max(strtoul(argv[++i], nullptr, 10), 1ul);
+        } else if (strncmp(argv[i], "-j", 2) == 0) {
+            jobs = std::max(strtoul(argv[i] + 2, nullptr, 10), 1ul);
+        } else if (strncmp(argv[i], "--emit=", 7) == 0) {
+            for (llvm::StringRef kinds = argv[i] + 7; !kinds.empty();) {
+                auto [kind, rest] = kinds.split(',');
+                kinds = rest;
+
+                if (std::none_of(EmitKinds.begin(), EmitKinds.end(), [&](const auto &emitKind) { return kind == emitKind.first; })) {
+                    std::cerr << "Unknown output " << kind.str() << ", use a comma separated list of obj, bc, ll, asm or exe" << std::endl;
+                    exit(1);
+                }
+
+                emit.insert(kind.str());
+            }
+        } else if (strcmp(argv[i], "--dump-ast") == 0) {
+            dumpAst = true;
+        } else if (argv[i][0] == '-' && argv[i][1] == 'v' && strspn(argv[i] + 1, "v") == strlen(argv[i] + 1)) {
+            verbosity += static_cast<int>(strlen(argv[i] + 1));
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            cacheDirectory = argv[++i];
+        } else if (strncmp(argv[i], "--march=", 8) == 0 || strncmp(argv[i], "--mcpu=", 7) == 0) {
+            cpu = strchr(argv[i], '=') + 1;
+        } else if (strncmp(argv[i], "--mattr=", 8) == 0) {
+            explicitFeatures.emplace_back(argv[i] + 8);
+        } else if (strcmp(argv[i], "--lto") == 0) {
+            target.LinkTimeOptimization = true;
+        } else if (strncmp(argv[i], "--lto-input=", 12) == 0) {
+            target.LinkTimeOptimization = true;
+            target.LinkTimeInputs.emplace_back(argv[i] + 12);
+        } else if (strcmp(argv[i], "--profile-generate") == 0) {
+            target.ProfileGenerate = "default.profraw";
+        } else if (strncmp(argv[i], "--profile-generate=", 19) == 0) {
+            target.ProfileGenerate = argv[i] + 19;
+        } else if (strncmp(argv[i], "--profile-use=", 14) == 0) {
+            target.ProfileUse = argv[i] + 14;
+        } else if (strcmp(argv[i], "--time-trace") == 0) {
+            timeTraceFile = "output.time-trace.json";
+        } else if (strncmp(argv[i], "--time-trace=", 13) == 0) {
+            timeTraceFile = argv[i] + 13;
+        } else if (strncmp(argv[i], "--time-trace-granularity=", 25) == 0) {
+            timeTraceGranularity = strtoul(argv[i] + 25, nullptr, 10);
+        } else if (strcmp(argv[i], "--tiered") == 0) {
+            tierUpThreshold = Hunter::Compiler::JitRunner::DefaultTierUpThreshold;
+        } else if (strncmp(argv[i], "--tier-up-after=", 16) == 0) {
+            tierUpThreshold = std::max(strtoull(argv[i] + 16, nullptr, 10), 1ull);
+        } else if (strncmp(argv[i], "-O", 2) == 0) {
+            if (!Hunter::Compiler::ParseOptimizationLevel(argv[i], target.Optimization)) {
+                std::cerr << "Unknown optimization level " << argv[i] << ", use one of -O0, -O1, -O2, -O3 or -Os" << std::endl;
+                exit(1);
+            }
+        } else if (argv[i][0] != '-') {
+            inputFiles.emplace_back(argv[i]);
+        } else if (OptionsWithValue.count(argv[i])) {
+            std::cerr << "Missing value for " << argv[i] << std::endl;
+            exit(1);
+        } else {
+            // a misspelled option would otherwise build the program without what it asks for
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            exit(1);
         }
     }
 
+    Hunter::Compiler::Logger::SetVerbosity(verbosity);
+
+    if (!target.ProfileGenerate.empty() && !target.ProfileUse.empty()) {
+        std::cerr << "--profile-generate and --profile-use can not be combined" << std::endl;
+        exit(1);
+    }
+
+    // the counters are written by the profile runtime of compiler-rt, which is not part of the compiler process
+    if (!target.ProfileGenerate.empty() && runProgram) {
+        std::cerr << "--profile-generate is not supported by run, build the program with -o and run it instead" << std::endl;
+        exit(1);
+    }
+
+    if (!target.ProfileUse.empty() && !std::filesystem::exists(target.ProfileUse)) {
+        std::cerr << "Could not find profile " << target.ProfileUse << std::endl;
+        exit(1);
+    }
+
+    bool isBatch = inputFiles.size() > 1;
+
+    // the programs of a batch are built at the same time, their dumps would be mixed up
+    if (isBatch && (runProgram || dumpAst || irOutputFile == "-")) {
+        std::cerr << "run, --dump-ast and --dump-ir can only be used with a single program" << std::endl;
+        exit(1);
+    }
+
+    // an output file without anything else means a program which can be started right away
+    if (emit.empty()) {
+        emit.insert(outputFile.empty() ? "obj" : "exe");
+    }
+
+    if (!outputFile.empty() && emit.size() > 1 && !isBatch) {
+        std::cerr << "-o can only name a single output, use it with one --emit kind" << std::endl;
+        exit(1);
+    }
+
+    if (runProgram && (!outputFile.empty() || emit.size() > 1 || !emit.count("obj"))) {
+        std::cerr << "run does not write any outputs, -o and --emit can not be used with it" << std::endl;
+        exit(1);
+    }
+
+    // the executables are linked last, so a driver which can not link the profile runtime is found before anything is compiled
+    if (!target.ProfileGenerate.empty() && emit.count("exe")) {
+        if (auto linker = Hunter::Compiler::FindExecutableLinker(target); !linker) {
+            std::cerr << llvm::toString(linker.takeError()) << std::endl;
+            exit(1);
+        }
+    }
+
+    // explicit features always win over the ones of the host, no matter in which order the options are given
+    if (cpu == "native") {
+        Hunter::Compiler::UseHostCPU(target);
+    } else if (!cpu.empty()) {
+        target.CPU = cpu;
+    }
+
+    for (const auto &features : explicitFeatures) {
+        Hunter::Compiler::AddTargetFeatures(target, features);
+    }
+
     // todo: handle 1 character variable
 
-    std::string filePath = std::string(argv[1]);
-    Hunter::Compiler::AbstractSyntaxTree * ast = parser.Parse(filePath);
-    std::vector<Hunter::Compiler::Expression *> emptyInstructionList;
-    importResolver.ResolveImports(std::filesystem::path(filePath).parent_path(), ast, emptyInstructionList);
-    ast->SetInstructions(emptyInstructionList);
+    // the outputs of a batch are named after the programs, -o and --output-ir name the directories they are written to
+    std::vector<Program> programs(inputFiles.size());
+    std::set<std::string> programNames;
+
+    for (size_t i = 0; i < inputFiles.size(); ++i) {
+        Program & program = programs[i];
+        program.FilePath = inputFiles[i];
+        program.IrOutputFile = irOutputFile;
+
+        std::string name = std::filesystem::path(program.FilePath).stem().string();
+
+        if (isBatch && !programNames.insert(name).second) {
+            std::cerr << "Several programs are called " << name << ", their outputs would overwrite each other" << std::endl;
+            exit(1);
+        }
+
+        if (isBatch && !irOutputFile.empty()) {
+            program.IrOutputFile = (std::filesystem::path(irOutputFile) / (name + ".ll")).string();
+        }
+
+        for (const auto &[kind, extension] : EmitKinds) {
+            if (!emit.count(kind)) {
+                continue;
+            }
+
+            if (isBatch) {
+                program.EmitFiles[kind] = (std::filesystem::path(outputFile) / (name + extension)).string();
+            } else {
+                program.EmitFiles[kind] = outputFile.empty() ? "output" + extension : outputFile;
+            }
+        }
+    }
+
+    for (const auto &directory : {outputFile, irOutputFile}) {
+        std::error_code error;
+
+        if (isBatch && !directory.empty() && !std::filesystem::create_directories(directory, error) && error) {
+            std::cerr << "Could not create the directory " << directory << ": " << error.message() << std::endl;
+            exit(1);
+        }
+    }
+
+    // declared before everything which could still run on other threads, so the trace is written last
+    Hunter::Compiler::TimeTrace timeTrace(timeTraceFile, timeTraceGranularity);
+    llvm::TimeTraceScope compileScope("Compile", isBatch ? std::to_string(programs.size()) + " programs" : programs.front().FilePath);
 
-    ast->Dump();
+    std::unique_ptr<Hunter::Compiler::CompilationCache> cache;
 
-    // todo: validate ast -> like return values matching return type
+    if (!cacheDirectory.empty()) {
+        cache = std::make_unique<Hunter::Compiler::CompilationCache>(cacheDirectory);
+        importResolver.SetCache(cache.get());
+    }
+
+    importResolver.SetTreeCache(treeCache);
+
+    // parsed one after the other, the modules of each program are still parsed at the same time
+    for (auto &program : programs) {
+        // a run has no files which could be restored, only the syntax trees are taken from the cache
+        if (cache && !runProgram) {
+            llvm::TimeTraceScope timeScope("RestoreCache", program.FilePath);
+            std::string outputsKey;
+
+            for (const auto &[kind, file] : program.EmitFiles) {
+                outputsKey += kind + "=" + file + ";";
+            }
+
+            program.CacheKey = cache->ComputeKey(sourceManager, program.FilePath, target, outputsKey);
+            program.IsRestored = cache->Restore(program.CacheKey, program.IrOutputFile, program.OutputFiles);
+
+            if (program.IsRestored) {
+                continue;
+            }
+        }
+
+        program.Ast.reset(parser.Parse(program.FilePath));
+        std::vector<Hunter::Compiler::Expression *> emptyInstructionList;
+        importResolver.ResolveImports(std::filesystem::path(program.FilePath).parent_path(), program.Ast.get(), emptyInstructionList, program.Units);
+        program.Ast->SetInstructions(emptyInstructionList);
+
+        if (dumpAst) {
+            llvm::TimeTraceScope timeScope("DumpAst");
+            program.Ast->Dump();
+            std::cout << "\n\nGenerate code\n------------" << std::endl;
+        }
+
+        // todo: validate ast -> like return values matching return type
+    }
+
+    if (runProgram) {
+        Program & program = programs.front();
+
+        Hunter::Compiler::ProgramDeclarations declarations;
+        for (const auto &unit : program.Units) {
+            declarations.AddUnit(unit);
+        }
+
+        std::vector<std::unique_ptr<Hunter::Compiler::CodeGenerator>> codeGenerators;
+        std::vector<llvm::Module *> modules;
+        GenerateModules(sourceManager, program.Units, declarations, nullptr, Hunter::Compiler::ThreadPool::GetDefaultThreadCount(), codeGenerators, modules);
+
+        if (!irOutputFile.empty()) {
+            std::error_code error;
+            llvm::raw_fd_ostream moduleTextStream(irOutputFile, error);
+
+            if (!CheckOutputFile(irOutputFile, error)) {
+                return 1;
+            }
+
+            for (const auto &module : modules) {
+                module->print(moduleTextStream, nullptr);
+            }
+        }
+
+        Hunter::Compiler::JitRunner runner(target, tierUpThreshold);
 
-    llvm::Module * module = codeGenerator.GenerateCode(ast);
-    Hunter::Compiler::CompileModule(module);
+        for (const auto &codeGenerator : codeGenerators) {
+            if (!runner.AddModule(codeGenerator->TakeModule())) {
+                return 1;
+            }
+        }
+
+        return runner.Run();
+    }
+
+    std::atomic<bool> succeeded = true;
+
+    if (!isBatch) {
+        succeeded = programs.front().IsRestored || BuildProgram(programs.front(), target, sourceManager, cache.get(), Hunter::Compiler::ThreadPool::GetDefaultThreadCount());
+    } else {
+        // the modules are shared by the programs, so everything they contain has to exist before the first one is generated
+        for (const auto &program : programs) {
+            for (const auto &unit : program.Units) {
+                DecodeBodies(unit.Instructions);
+            }
+        }
+
+        // every program is generated on a single thread, the programs are built at the same time instead
+        Hunter::Compiler::ThreadPool pool(std::min(jobs, programs.size()));
+
+        for (auto &program : programs) {
+            if (program.IsRestored) {
+                continue;
+            }
+
+            pool.Submit([&]() {
+                if (!BuildProgram(program, target, sourceManager, cache.get(), 1)) {
+                    succeeded = false;
+                }
+            });
+        }
+
+        pool.Wait();
+    }
+
+    for (const auto &program : programs) {
+        for (const auto &file : program.OutputFiles) {
+            llvm::outs() << "Wrote " << file << "\n";
+        }
+    }
+
+    return succeeded ? 0 : 1;
+}
+
+int main(int argc, const char ** argv) {
+    // "daemon" keeps serving the compilations sent by Hunter_Client until it is terminated
+    if (argc > 1 && strcmp(argv[1], "daemon") == 0) {
+        std::string socketPath = argc > 3 && strcmp(argv[2], "--socket") == 0 ? argv[3] : Hunter::Compiler::GetDefaultServerSocketPath();
+        return Hunter::Compiler::CompileServer(socketPath, Compile).Run();
+    }
 
-    return 0;
+    return Compile(argc, argv, nullptr);
 }
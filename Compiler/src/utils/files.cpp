@@ -1,12 +1,47 @@
 #include "files.h"
 #include "logger.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-std::string readFileIntoString(const std::string& path) {
-    std::ifstream input_file(path);
-    if (!input_file.is_open()) {
+
+std::string_view mapFileIntoMemory(const std::string& path) {
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor == -1) {
         COMPILER_ERROR("Could not open the file - '{0}'", path);
         exit(EXIT_FAILURE);
     }
-    return std::string((std::istreambuf_iterator<char>(input_file)), std::istreambuf_iterator<char>());
-}
\ No newline at end of file
+
+    struct stat fileInfo{};
+    if (fstat(fileDescriptor, &fileInfo) == -1) {
+        COMPILER_ERROR("Could not read the size of the file - '{0}'", path);
+        exit(EXIT_FAILURE);
+    }
+
+    // mapping an empty file is not allowed
+    if (fileInfo.st_size == 0) {
+        close(fileDescriptor);
+        return {};
+    }
+
+    auto size = static_cast<size_t>(fileInfo.st_size);
+    void * data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+
+    if (data == MAP_FAILED) {
+        COMPILER_ERROR("Could not map the file - '{0}'", path);
+        exit(EXIT_FAILURE);
+    }
+
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    return {static_cast<const char *>(data), size};
+}
+
+void unmapFile(std::string_view data) {
+    if (!data.empty()) {
+        munmap(const_cast<char *>(data.data()), data.size());
+    }
+}
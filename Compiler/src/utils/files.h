@@ -1,6 +1,9 @@
 #pragma once
 
-#include <iostream>
-#include <fstream>
+#include <string>
+#include <string_view>
 
-std::string readFileIntoString(const std::string& path);
\ No newline at end of file
+// maps the whole file read only into memory, the returned view stays valid until unmapFile is called
+std::string_view mapFileIntoMemory(const std::string& path);
+
+void unmapFile(std::string_view data);
@@ -1,7 +1,10 @@
 #include "logger.h"
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <cstdlib>
+
 namespace Hunter::Compiler {
 
     std::shared_ptr<spdlog::logger> Logger::s_CoreLogger;
@@ -9,7 +12,31 @@ namespace Hunter::Compiler {
     void Logger::Init() {
         spdlog::set_pattern("%^[%T] [source %s] [function %!] [line %#]: %v%$");
 
-        s_CoreLogger = spdlog::stdout_color_mt("CORE");
-        s_CoreLogger->set_level(spdlog::level::trace);
+        // stderr keeps the messages apart from the dumps, which are written to stdout at the same time
+        spdlog::init_thread_pool(8192, 1);
+        s_CoreLogger = spdlog::create_async<spdlog::sinks::stderr_color_sink_mt>("CORE");
+        s_CoreLogger->set_level(spdlog::level::warn);
+
+        // most errors end the compiler with exit, the queued messages still have to be written
+        std::atexit([]() {
+            spdlog::shutdown();
+        });
+    }
+
+    void Logger::SetVerbosity(int verbosity) {
+        switch (verbosity) {
+            case 0:
+                s_CoreLogger->set_level(spdlog::level::warn);
+                break;
+            case 1:
+                s_CoreLogger->set_level(spdlog::level::info);
+                break;
+            case 2:
+                s_CoreLogger->set_level(spdlog::level::debug);
+                break;
+            default:
+                s_CoreLogger->set_level(spdlog::level::trace);
+                break;
+        }
     }
-}
\ No newline at end of file
+}
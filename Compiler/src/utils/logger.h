@@ -1,11 +1,19 @@
 #pragma once
 
+// set by the build, calls below this level are not compiled in at all
+#ifndef SPDLOG_ACTIVE_LEVEL
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
 #include <spdlog/spdlog.h>
 
 namespace Hunter::Compiler {
     class Logger {
     public:
+        // messages are formatted and written by a background thread, warnings and errors are shown by default
         static void Init();
+        // 0 shows warnings and errors, every step adds info, debug and trace messages
+        static void SetVerbosity(int verbosity);
         inline static std::shared_ptr<spdlog::logger>& GetInstance() { return s_CoreLogger; }
 
     private:
@@ -17,4 +25,4 @@ namespace Hunter::Compiler {
 #define COMPILER_WARN(...)  SPDLOG_LOGGER_WARN(::Hunter::Compiler::Logger::GetInstance(), __VA_ARGS__)
 #define COMPILER_INFO(...)  SPDLOG_LOGGER_INFO(::Hunter::Compiler::Logger::GetInstance(), __VA_ARGS__)
 #define COMPILER_DEBUG(...) SPDLOG_LOGGER_DEBUG(::Hunter::Compiler::Logger::GetInstance(), __VA_ARGS__)
-
+#define COMPILER_TRACE(...) SPDLOG_LOGGER_TRACE(::Hunter::Compiler::Logger::GetInstance(), __VA_ARGS__)
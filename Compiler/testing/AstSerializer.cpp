@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+
+#include "../src/AstSerializer.h"
+#include "../src/Expressions.h"
+#include "../src/Parser.h"
+#include "../src/SourceManager.h"
+#include "../src/utils/logger.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include <llvm/Support/xxhash.h>
+
+using namespace Hunter::Compiler;
+
+static std::string DumpTree(AbstractSyntaxTree * tree) {
+    std::stringstream output;
+    std::streambuf * previous = std::cout.rdbuf(output.rdbuf());
+    tree->Dump();
+    std::cout.rdbuf(previous);
+
+    return output.str();
+}
+
+TEST_CASE( "Syntax trees are serialized", "[serializer]" ) {
+    // the reader warns about outdated files
+    if (!Logger::GetInstance()) {
+        Logger::Init();
+    }
+
+    SourceManager sourceManager;
+    auto directory = std::filesystem::temp_directory_path() / "hunter-serializer-test";
+    std::filesystem::create_directories(directory);
+
+    std::string sourcePath = (directory / "source.hunt").string();
+    std::string treePath = (directory / "source.hast").string();
+
+    std::ofstream(sourcePath) << "import helpers\n"
+                                 "\n"
+                                 "struct Person\n"
+                                 "    age: i32\n"
+                                 "\n"
+                                 "fun add(a: i64, b: i64) : i64\n"
+                                 "    return a + b\n"
+                                 "\n"
+                                 "fun hunt()\n"
+                                 "    const name = \"Hunter\\n\"\n"
+                                 "    let counter = -300\n"
+                                 "    for i in 0..10\n"
+                                 "        counter = add(counter, i)\n"
+                                 "    if counter eq 5 then\n"
+                                 "        print(name)\n"
+                                 "    const person = new Person(age = 42)\n"
+                                 "    print(person.age)\n";
+
+    Parser parser(sourceManager);
+    std::unique_ptr<AbstractSyntaxTree> parsedTree(parser.Parse(sourcePath));
+    REQUIRE( AstWriter::Write(parsedTree.get(), treePath) );
+
+    std::unique_ptr<AbstractSyntaxTree> loadedTree(AstReader::Load(sourceManager, treePath));
+    REQUIRE( loadedTree );
+
+    SECTION("loaded tree matches the parsed one") {
+        REQUIRE( loadedTree->GetInstructions().size() == parsedTree->GetInstructions().size() );
+        REQUIRE( DumpTree(loadedTree.get()) == DumpTree(parsedTree.get()) );
+    }
+
+    SECTION("symbols and debug data are restored") {
+        auto * functionExpr = dynamic_cast<FunctionExpression *>(loadedTree->GetInstructions().at(3));
+        REQUIRE( functionExpr );
+        REQUIRE( functionExpr->GetSymbol() == sourceManager.GetSymbols().Find("hunt") );
+
+        auto * constExpr = dynamic_cast<ConstExpression *>(functionExpr->GetBody().at(0));
+        REQUIRE( constExpr );
+        REQUIRE( constExpr->GetVariableName() == "name" );
+        REQUIRE( constExpr->GetDebugData()->GetFileName() == "source.hunt" );
+        REQUIRE( constExpr->GetDebugData()->GetFileLine() == 10 );
+    }
+
+    SECTION("trees are loaded from memory") {
+        std::string data = AstWriter::Serialize(parsedTree.get());
+        std::unique_ptr<AbstractSyntaxTree> memoryTree(AstReader::Load(sourceManager, data, sourcePath));
+
+        REQUIRE( memoryTree );
+        REQUIRE( DumpTree(memoryTree.get()) == DumpTree(parsedTree.get()) );
+    }
+
+    SECTION("files of another format version are ignored") {
+        std::ofstream(treePath, std::ios::trunc) << "HAST but not really";
+        SourceManager otherSourceManager;
+
+        REQUIRE( AstReader::Load(otherSourceManager, treePath) == nullptr );
+        REQUIRE( AstReader::Load(otherSourceManager, (directory / "missing.hast").string()) == nullptr );
+    }
+
+    SECTION("corrupted trees are ignored") {
+        std::string data = AstWriter::Serialize(parsedTree.get());
+
+        std::string changed = data;
+        changed[sizeof(AstFileHeader) + 1] ^= 0x5A;
+        REQUIRE( AstReader::Load(sourceManager, changed, sourcePath) == nullptr );
+
+        // a tree which passes the checksum but can not be decoded
+        std::string truncated = data.substr(0, sizeof(AstFileHeader) + 2);
+        AstFileHeader header{};
+        std::memcpy(&header, truncated.data(), sizeof(header));
+        header.Size = truncated.size();
+        header.StringTableOffset = truncated.size();
+        header.StringCount = 0;
+        header.Checksum = llvm::xxHash64(llvm::StringRef(truncated).drop_front(sizeof(header)));
+        std::memcpy(truncated.data(), &header, sizeof(header));
+        REQUIRE( AstReader::Load(sourceManager, truncated, sourcePath) == nullptr );
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+
+#include "../src/Lexer.h"
+
+#include <string>
+
+using namespace Hunter::Compiler;
+
+TEST_CASE( "Source is split into tokens", "[lexer]" ) {
+    SymbolTable symbols;
+
+    SECTION("function header") {
+        Lexer lexer("fun foo(num: i8) : i64", symbols);
+        auto tokens = lexer.Tokenize();
+
+        REQUIRE( tokens.size() == 11 );
+        REQUIRE( tokens.at(0).Kind == TokenKind::Function );
+        REQUIRE( tokens.at(1).Kind == TokenKind::Identifier );
+        REQUIRE( tokens.at(1).Text == "foo" );
+        REQUIRE( tokens.at(2).Kind == TokenKind::LeftParenthesis );
+        REQUIRE( tokens.at(4).Kind == TokenKind::Colon );
+        REQUIRE( tokens.at(6).Kind == TokenKind::RightParenthesis );
+        REQUIRE( tokens.at(8).Text == "i64" );
+        REQUIRE( tokens.at(9).Kind == TokenKind::EndOfLine );
+        REQUIRE( tokens.at(10).Kind == TokenKind::EndOfFile );
+    }
+
+    SECTION("indentation, lines and columns") {
+        std::string source = "fun hunt()\n\n    print(\"Hello #1\\n\") # comment\n";
+        Lexer lexer(source, symbols);
+        auto tokens = lexer.Tokenize();
+
+        REQUIRE( tokens.at(4).Kind == TokenKind::EndOfLine );
+        REQUIRE( tokens.at(5).Kind == TokenKind::Print );
+        REQUIRE( tokens.at(5).Level == 4 );
+        REQUIRE( tokens.at(5).Line == 3 );
+        REQUIRE( tokens.at(5).Column == 5 );
+
+        REQUIRE( tokens.at(7).Kind == TokenKind::String );
+        REQUIRE( tokens.at(7).Text == "Hello #1\\n" );
+        REQUIRE( tokens.at(8).Kind == TokenKind::RightParenthesis );
+        REQUIRE( tokens.at(9).Kind == TokenKind::EndOfLine );
+        REQUIRE( tokens.at(10).Kind == TokenKind::EndOfFile );
+    }
+
+    SECTION("operators, ranges and negative numbers") {
+        Lexer lexer("for i in 1..10\nfoo = foo + -1\nif a <= b then", symbols);
+        auto tokens = lexer.Tokenize();
+
+        REQUIRE( tokens.at(3).Kind == TokenKind::Integer );
+        REQUIRE( tokens.at(4).Kind == TokenKind::Range );
+        REQUIRE( tokens.at(5).Text == "10" );
+
+        REQUIRE( tokens.at(8).Kind == TokenKind::Assign );
+        REQUIRE( tokens.at(10).Kind == TokenKind::Operator );
+        REQUIRE( tokens.at(11).Kind == TokenKind::Integer );
+        REQUIRE( tokens.at(11).Text == "-1" );
+
+        REQUIRE( tokens.at(7).Name == tokens.at(9).Name );
+        REQUIRE( tokens.at(7).Name.GetName() == "foo" );
+        REQUIRE_FALSE( tokens.at(0).Name.IsValid() );
+
+        REQUIRE( tokens.at(15).Kind == TokenKind::Operator );
+        REQUIRE( tokens.at(15).Text == "<=" );
+        REQUIRE( tokens.at(17).Kind == TokenKind::Then );
+    }
+
+    SECTION("identifiers are interned") {
+        Symbol foo = symbols.Intern("foo");
+
+        REQUIRE( foo.IsValid() );
+        REQUIRE( symbols.Intern(std::string("foo")) == foo );
+        REQUIRE( symbols.Find("foo") == foo );
+        REQUIRE_FALSE( symbols.Find("bar").IsValid() );
+        REQUIRE( symbols.Intern("bar").GetId() != foo.GetId() );
+    }
+}
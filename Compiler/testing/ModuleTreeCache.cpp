@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+
+#include "../src/ModuleTreeCache.h"
+
+#include <unistd.h>
+
+using namespace Hunter::Compiler;
+
+static std::string ReadAll(int fileDescriptor) {
+    std::string data;
+    char buffer[4096];
+
+    for (ssize_t size; (size = read(fileDescriptor, buffer, sizeof(buffer))) > 0;) {
+        data.append(buffer, static_cast<size_t>(size));
+    }
+
+    return data;
+}
+
+TEST_CASE( "Reported trees are found by the next compilations", "[tree-cache]" ) {
+    int reportPipe[2];
+    REQUIRE( pipe(reportPipe) == 0 );
+
+    // the compilation only reports, the server adds what it read from the pipe
+    ModuleTreeCache compilationCache;
+    compilationCache.SetReportFileDescriptor(reportPipe[1]);
+    compilationCache.Report("helpers.hunt", "fun helper()\n", "first tree");
+    compilationCache.Report("other.hunt", "fun other()\n", std::string(10000, 'x'));
+    close(reportPipe[1]);
+
+    REQUIRE( compilationCache.Find("helpers.hunt", "fun helper()\n").empty() );
+
+    std::string reports = ReadAll(reportPipe[0]);
+    close(reportPipe[0]);
+
+    ModuleTreeCache serverCache;
+    serverCache.AddReports(reports);
+
+    SECTION("trees are found for the same source") {
+        REQUIRE( serverCache.Find("helpers.hunt", "fun helper()\n") == "first tree" );
+        REQUIRE( serverCache.Find("other.hunt", "fun other()\n").size() == 10000 );
+        REQUIRE( serverCache.GetSize() == 10000 + std::string_view("first tree").size() );
+    }
+
+    SECTION("changed sources are parsed again") {
+        REQUIRE( serverCache.Find("helpers.hunt", "fun helper2()\n").empty() );
+        REQUIRE( serverCache.Find("missing.hunt", "fun helper()\n").empty() );
+    }
+
+    SECTION("an incomplete report is ignored") {
+        ModuleTreeCache crashedCache;
+        crashedCache.AddReports(std::string_view(reports).substr(0, reports.size() - 1));
+
+        REQUIRE( crashedCache.Find("helpers.hunt", "fun helper()\n") == "first tree" );
+        REQUIRE( crashedCache.Find("other.hunt", "fun other()\n").empty() );
+    }
+}
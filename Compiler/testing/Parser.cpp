@@ -3,13 +3,19 @@
 
 #include "../src/Expressions.h"
 #include "../src/Parser.h"
+#include "../src/SourceManager.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
 
 using namespace Hunter::Compiler;
 
 TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
+    SourceManager sourceManager;
 
     SECTION("print with static string instruction") {
-        Parser parser;
+        Parser parser(sourceManager);
 
         auto * expr = parser.ParseLine(R"( print("Hello 8\n"))");
         REQUIRE( dynamic_cast<PrintExpression *>(expr) );
@@ -26,7 +32,7 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
     }
 
     SECTION("print with const string var instruction") {
-        Parser parser;
+        Parser parser(sourceManager);
 
         parser.ParseLine(R"( const helloWorld = "Hello World")");
         auto * expr = parser.ParseLine(R"( print(helloWorld, "\n"))");
@@ -48,7 +54,7 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
     }
 
     SECTION("const instruction") {
-        Parser parser;
+        Parser parser(sourceManager);
 
         auto * expr = parser.ParseLine(R"( const my_str = "Foo Bar")");
         REQUIRE( dynamic_cast<ConstExpression *>(expr) );
@@ -63,7 +69,7 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
     }
 
     SECTION("variable assignment instruction") {
-        Parser parser;
+        Parser parser(sourceManager);
 
         auto * expr = parser.ParseLine(" foo = foo + 1");
         REQUIRE( dynamic_cast<VariableMutationExpression *>(expr) );
@@ -87,7 +93,7 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
     }
 
     SECTION("function declaration with parameter instruction") {
-        Parser parser;
+        Parser parser(sourceManager);
 
         auto * expr = parser.ParseLine("fun foo(num: i8)");
         REQUIRE( dynamic_cast<FunctionExpression *>(expr) );
@@ -100,11 +106,11 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
 
         auto * parameter = parameters.at(0);
         REQUIRE( parameter->GetName() == "num" );
-        REQUIRE(parameter->GetDataType() == DataTypeId::i8 );
+        REQUIRE(parameter->GetDataType()->GetId() == DataTypeId::i8 );
     }
 
     SECTION("function declaration without parameter instruction") {
-        Parser parser;
+        Parser parser(sourceManager);
 
         auto * expr = parser.ParseLine("fun foo()");
         REQUIRE( dynamic_cast<FunctionExpression *>(expr) );
@@ -117,7 +123,7 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
     }
 
     SECTION("function call instruction") {
-        Parser parser;
+        Parser parser(sourceManager);
 
         auto * expr = parser.ParseLine(" foo()");
         REQUIRE( dynamic_cast<FunctionCallExpression *>(expr) );
@@ -128,9 +134,9 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
     }
 
     SECTION("if instruction") {
-        Parser parser;
+        Parser parser(sourceManager);
 
-        auto * expr = parser.ParseLine(R"( if helloWorld eq \"Hello World\" then)");
+        auto * expr = parser.ParseLine(R"( if helloWorld eq "Hello World" then)");
         REQUIRE( dynamic_cast<IfExpression *>(expr) );
 
         auto * ifExpr = dynamic_cast<IfExpression *>(expr);
@@ -143,7 +149,7 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
     }
 
     SECTION("single line comments") {
-        Parser parser;
+        Parser parser(sourceManager);
 
         auto * expr = parser.ParseLine(R"( print("We also have a comment here") # on the print line)");
         REQUIRE( dynamic_cast<PrintExpression *>(expr) );
@@ -151,4 +157,108 @@ TEST_CASE( "Simple instructions are parsed", "[parser]" ) {
         auto * printExpr = dynamic_cast<PrintExpression *>(expr);
         REQUIRE( dynamic_cast<FunctionCallExpression *>(printExpr->GetInput()) );
     }
-}
\ No newline at end of file
+
+    SECTION("full line comment") {
+        Parser parser(sourceManager);
+
+        auto * expr = parser.ParseLine(R"(  # only a comment with "quotes")");
+        REQUIRE( expr == nullptr );
+    }
+
+    SECTION("for loop over range instruction") {
+        Parser parser(sourceManager);
+
+        auto * expr = parser.ParseLine("for counter in 1..10");
+        REQUIRE( dynamic_cast<ForLoopExpression *>(expr) );
+
+        auto * forExpr = dynamic_cast<ForLoopExpression *>(expr);
+        REQUIRE( forExpr->GetCounterName() == "counter" );
+
+        auto * rangeExpr = dynamic_cast<RangeExpression *>(forExpr->GetRange());
+        REQUIRE( rangeExpr );
+        REQUIRE( rangeExpr->GetStart() == 1 );
+        REQUIRE( rangeExpr->GetEnd() == 10 );
+    }
+
+    SECTION("struct construction instruction") {
+        Parser parser(sourceManager);
+
+        auto * expr = parser.ParseLine(R"(  const data = new SampleData(my_int = 9, my_string = "Hello"))");
+        REQUIRE( dynamic_cast<ConstExpression *>(expr) );
+
+        auto * constExpr = dynamic_cast<ConstExpression *>(expr);
+        auto * structExpr = dynamic_cast<StructConstructionExpression *>(constExpr->GetValue());
+        REQUIRE( structExpr );
+        REQUIRE( structExpr->GetStructName() == "SampleData" );
+        REQUIRE( structExpr->GetAttributes().size() == 2 );
+        REQUIRE( structExpr->GetAttributes().at(1)->GetVariableName() == "my_string" );
+        REQUIRE( dynamic_cast<StringExpression *>(structExpr->GetAttributes().at(1)->GetValue()) );
+    }
+
+    SECTION("expression kinds") {
+        Parser parser(sourceManager);
+
+        auto * expr = parser.ParseLine("while counter < 10");
+        REQUIRE( expr->GetKind() == ExpressionKind::While );
+        REQUIRE( IsA<WhileExpression>(expr) );
+        REQUIRE( IsA<BlockExpression>(expr) );
+        REQUIRE_FALSE( IsA<IfExpression>(expr) );
+        REQUIRE_FALSE( IsA<VariableDeclarationExpression>(expr) );
+
+        auto * letExpr = parser.ParseLine("let counter = 0");
+        REQUIRE( DynCast<VariableDeclarationExpression>(letExpr) == letExpr );
+        REQUIRE( DynCast<ConstExpression>(letExpr) == nullptr );
+        REQUIRE( DynCast<IntExpression>(nullptr) == nullptr );
+    }
+
+    SECTION("property access is split into symbols") {
+        Parser parser(sourceManager);
+
+        auto * expr = parser.ParseLine("print(data.my_int)");
+        auto * funcCallExpr = DynCast<FunctionCallExpression>(DynCast<PrintExpression>(expr)->GetInput());
+        auto * identifierExpr = DynCast<IdentifierExpression>(funcCallExpr->GetParameters().at(0));
+        REQUIRE( identifierExpr );
+
+        SymbolTable & symbols = sourceManager.GetSymbols();
+        REQUIRE( identifierExpr->GetVariableName() == "data.my_int" );
+        REQUIRE( identifierExpr->GetObject() == symbols.Find("data") );
+        REQUIRE( identifierExpr->GetProperty() == symbols.Find("my_int") );
+        REQUIRE( funcCallExpr->GetFunction() == symbols.Find("print") );
+    }
+}
+
+TEST_CASE( "Blocks are nested by their level", "[parser]" ) {
+    SourceManager sourceManager;
+    auto directory = std::filesystem::temp_directory_path() / "hunter-parser-test";
+    std::filesystem::create_directories(directory);
+
+    std::string sourcePath = (directory / "source.hunt").string();
+    std::ofstream(sourcePath) << "fun hunt()\n"
+                                 "    const num = 8\n"
+                                 "    if num eq 8 then\n"
+                                 "        print(\"Hello 8\\n\")\n"
+                                 "    else\n"
+                                 "        print(\"Not hello 8\\n\")\n"
+                                 "    print(\"done\\n\")\n";
+
+    Parser parser(sourceManager);
+    std::unique_ptr<AbstractSyntaxTree> tree(parser.Parse(sourcePath));
+
+    auto * functionExpr = DynCast<FunctionExpression>(tree->GetInstructions().at(0));
+    REQUIRE( functionExpr );
+    REQUIRE( functionExpr->GetBody().size() == 3 );
+
+    SECTION("else belongs to the if on its level") {
+        auto * ifExpr = DynCast<IfExpression>(functionExpr->GetBody().at(1));
+        REQUIRE( ifExpr );
+        REQUIRE( ifExpr->GetBody().size() == 1 );
+        REQUIRE( ifExpr->GetElse() );
+        REQUIRE( ifExpr->GetElse()->GetBody().size() == 1 );
+    }
+
+    SECTION("the else block ends with its level") {
+        REQUIRE( DynCast<PrintExpression>(functionExpr->GetBody().at(2)) );
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,27 @@
+# builds an instrumented program, runs it and checks that it wrote its counters on exit
+set(executable ${OUTPUT_DIRECTORY}/for-loop)
+set(profile ${OUTPUT_DIRECTORY}/for-loop.profraw)
+
+file(REMOVE_RECURSE ${OUTPUT_DIRECTORY})
+file(MAKE_DIRECTORY ${OUTPUT_DIRECTORY})
+
+# the clang of the build links the program, without it the compiler falls back to the profile runtime
+if (CLANG)
+    set(ENV{CC} ${CLANG})
+endif()
+
+execute_process(COMMAND ${COMPILER} ${SOURCE} --profile-generate=${profile} -o ${executable} RESULT_VARIABLE result)
+
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Building the instrumented program failed: ${result}")
+endif()
+
+execute_process(COMMAND ${executable} RESULT_VARIABLE result OUTPUT_QUIET)
+
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Running the instrumented program failed: ${result}")
+endif()
+
+if (NOT EXISTS ${profile})
+    message(FATAL_ERROR "The instrumented program did not write ${profile}")
+endif()
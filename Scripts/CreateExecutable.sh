@@ -1,4 +1,5 @@
 cd ./cmake-build-debug/bin
 
-clang -stdlib=libc++ output.o -o foo
+# print is implemented by the runtime, which is built next to the compiler
+clang -stdlib=libc++ output.o ../lib/libhunter_rt.a -pthread -o foo
 ./foo
\ No newline at end of file
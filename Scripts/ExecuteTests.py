@@ -1,5 +1,6 @@
 import os
 import subprocess
+import tempfile
 
 files_to_test = [
     ('./Examples/c-library-integration.hunt', './Examples/c-library-integration.hunt.txt'),
@@ -22,31 +23,28 @@ files_to_test = [
 
 path_to_compiler = './cmake-build-debug/bin/Hunter_Compiler'
 
-for hunt_file, hunt_test_output in files_to_test:
-    if not os.path.exists(hunt_test_output):
-        ret_code = subprocess.call(f'{path_to_compiler} {hunt_file} --output-ir {hunt_test_output}'.split(' '))
-        os.remove('output.bc')
-        os.remove('output.o')
-        if ret_code != 0:
-            print('Compilation failed')
-            exit(1)
+# all examples are compiled by a single process, which shares the modules they import
+with tempfile.TemporaryDirectory() as output_dir:
+    hunt_files = [hunt_file for hunt_file, _ in files_to_test]
+    ret_code = subprocess.call([path_to_compiler, *hunt_files, '--output-ir', output_dir, '-o', output_dir, '--emit=obj'])
 
-    else:
-        with open(hunt_test_output, 'r') as test_file:
-            expected_output = test_file.read()
+    if ret_code != 0:
+        print('Compilation failed')
+        exit(1)
 
-        ret_code = subprocess.call(f'{path_to_compiler} {hunt_file} --output-ir {hunt_test_output}'.split(' '))
+    for hunt_file, hunt_test_output in files_to_test:
+        ir_file = os.path.join(output_dir, os.path.basename(hunt_file).replace('.hunt', '.ll'))
 
-        if os.path.exists('output.o'):
-            os.remove('output.bc')
-            os.remove('output.o')
+        with open(ir_file, 'r') as ir:
+            real_output = ir.read()
 
-        if ret_code != 0:
-            print(f'Compilation failed for {hunt_file}')
-            exit(1)
+        if not os.path.exists(hunt_test_output):
+            with open(hunt_test_output, 'w') as test_file:
+                test_file.write(real_output)
+            continue
 
         with open(hunt_test_output, 'r') as test_file:
-            real_output = test_file.read()
+            expected_output = test_file.read()
 
         if expected_output != real_output:
             print(f'Outputs are not identical for {hunt_file}')
@@ -0,0 +1,181 @@
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import tempfile
+import time
+
+# every benchmark is a pair of Benchmarks/<name>.hunt and Benchmarks/<name>.c which print the same output.
+# the first line of the Hunter program tells how much work one run does: "# iterations: <count>"
+
+benchmark_directory = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'Benchmarks')
+
+parser = argparse.ArgumentParser(description='Compares programs generated by the Hunter compiler with C reference programs')
+parser.add_argument('--compiler', default='./cmake-build-debug/bin/Hunter_Compiler')
+parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+parser.add_argument('--optimization', default='-O2')
+parser.add_argument('--runs', type=int, default=10)
+parser.add_argument('--baseline', default=os.path.join(benchmark_directory, 'baseline.json'))
+parser.add_argument('--update-baseline', action='store_true')
+parser.add_argument('--tolerance', type=float, default=0.15, help='allowed slowdown of the Hunter program relative to the baseline')
+parser.add_argument('--min-delta', type=float, default=0.005, help='slowdowns below this many seconds are noise')
+parser.add_argument('--output', help='writes the full results as JSON')
+parser.add_argument('benchmarks', nargs='*')
+arguments = parser.parse_args()
+
+
+def percentile(samples, value):
+    ordered = sorted(samples)
+    rank = min(max(int(value / 100 * len(ordered) + 0.5), 1), len(ordered))
+    return ordered[rank - 1]
+
+
+def run_program(executable):
+    # the output goes nowhere, only the time of the program itself is measured
+    start = time.perf_counter()
+    process = subprocess.Popen([executable], stdout=subprocess.DEVNULL)
+    _, status, usage = os.wait4(process.pid, 0)
+    elapsed = time.perf_counter() - start
+    process.returncode = os.waitstatus_to_exitcode(status)
+
+    if process.returncode != 0:
+        print(f'{executable} failed with exit code {process.returncode}')
+        exit(1)
+
+    # linux reports kilobytes, macOS bytes
+    peak_rss = usage.ru_maxrss if platform.system() == 'Darwin' else usage.ru_maxrss * 1024
+    return elapsed, peak_rss
+
+
+def measure(executable, iterations):
+    samples = []
+    peak_rss = 0
+
+    for _ in range(arguments.runs):
+        elapsed, rss = run_program(executable)
+        samples.append(elapsed)
+        peak_rss = max(peak_rss, rss)
+
+    median = percentile(samples, 50)
+
+    return {
+        'median_s': median,
+        'p90_s': percentile(samples, 90),
+        'p99_s': percentile(samples, 99),
+        'min_s': min(samples),
+        'max_s': max(samples),
+        'throughput_per_s': iterations / median if median > 0 else 0,
+        'binary_size': os.path.getsize(executable),
+        'peak_rss': peak_rss,
+    }
+
+
+def compile_hunter(source, work_directory):
+    # the compiler links with the same C compiler as the reference programs
+    executable = os.path.join(work_directory, 'hunter')
+    ret_code = subprocess.call([os.path.abspath(arguments.compiler), source, arguments.optimization, '-o', executable],
+                               cwd=work_directory, stdout=subprocess.DEVNULL, env=dict(os.environ, CC=arguments.cc))
+    if ret_code != 0:
+        print(f'Compilation failed for {source}')
+        exit(1)
+
+    return executable
+
+
+def compile_c(source, work_directory):
+    executable = os.path.join(work_directory, 'c')
+    subprocess.check_call([arguments.cc, arguments.optimization, source, '-o', executable])
+    return executable
+
+
+def read_iterations(source):
+    with open(source, 'r') as source_file:
+        match = re.match(r'#\s*iterations:\s*(\d+)', source_file.readline())
+
+    if not match:
+        print(f'{source} does not start with "# iterations: <count>"')
+        exit(1)
+
+    return int(match.group(1))
+
+
+names = arguments.benchmarks or sorted(
+    file[:-len('.hunt')] for file in os.listdir(benchmark_directory)
+    if file.endswith('.hunt') and os.path.exists(os.path.join(benchmark_directory, file[:-len('.hunt')] + '.c'))
+)
+
+baseline = {}
+if os.path.exists(arguments.baseline) and not arguments.update_baseline:
+    with open(arguments.baseline, 'r') as baseline_file:
+        baseline = json.load(baseline_file)
+
+results = {}
+regressions = []
+
+print(f'{"benchmark":<22} {"hunter ms":>10} {"c ms":>10} {"ratio":>7} {"hunter size":>12} {"c size":>10} {"hunter rss":>11} {"c rss":>10}')
+
+for name in names:
+    hunt_file = os.path.join(benchmark_directory, name + '.hunt')
+    c_file = os.path.join(benchmark_directory, name + '.c')
+    iterations = read_iterations(hunt_file)
+
+    work_directory = tempfile.mkdtemp(prefix=f'hunter-benchmark-{name}-')
+
+    try:
+        hunter_executable = compile_hunter(hunt_file, work_directory)
+        c_executable = compile_c(c_file, work_directory)
+
+        # timings of a program which computes something else are worthless
+        hunter_output = subprocess.run([hunter_executable], capture_output=True, check=True).stdout
+        c_output = subprocess.run([c_executable], capture_output=True, check=True).stdout
+
+        if hunter_output != c_output:
+            print(f'Outputs are not identical for {name}')
+            print(f'Expected output {c_output.decode()}')
+            print('=====================================')
+            print(f'Actual output {hunter_output.decode()}')
+            exit(1)
+
+        hunter = measure(hunter_executable, iterations)
+        c = measure(c_executable, iterations)
+    finally:
+        shutil.rmtree(work_directory)
+
+    # compared relative to the C program, so a baseline taken on another machine still means something
+    ratio = hunter['median_s'] / c['median_s']
+    results[name] = {'iterations': iterations, 'hunter': hunter, 'c': c, 'ratio': ratio}
+
+    print(f'{name:<22} {hunter["median_s"] * 1000:>10.2f} {c["median_s"] * 1000:>10.2f} {ratio:>7.2f} '
+          f'{hunter["binary_size"]:>12} {c["binary_size"]:>10} {hunter["peak_rss"] // 1024:>9}KB {c["peak_rss"] // 1024:>8}KB')
+
+    if name in baseline:
+        expected = baseline[name]['ratio'] * c['median_s']
+
+        if hunter['median_s'] > expected * (1 + arguments.tolerance) and hunter['median_s'] - expected > arguments.min_delta:
+            regressions.append(f'{name} takes {hunter["median_s"] * 1000:.2f}ms, expected at most {expected * (1 + arguments.tolerance) * 1000:.2f}ms')
+
+        if hunter['binary_size'] > baseline[name]['hunter_binary_size'] * (1 + arguments.tolerance):
+            regressions.append(f'{name} binary has {hunter["binary_size"]} bytes, the baseline {baseline[name]["hunter_binary_size"]}')
+
+if arguments.output:
+    with open(arguments.output, 'w') as output_file:
+        json.dump(results, output_file, indent=2)
+
+if arguments.update_baseline:
+    with open(arguments.baseline, 'w') as baseline_file:
+        json.dump({
+            name: {'ratio': result['ratio'], 'hunter_binary_size': result['hunter']['binary_size']}
+            for name, result in results.items()
+        }, baseline_file, indent=2, sort_keys=True)
+        baseline_file.write('\n')
+
+    print(f'Wrote baseline {arguments.baseline}')
+
+if regressions:
+    print('Hunter programs regressed against the baseline:')
+    for regression in regressions:
+        print(f'  {regression}')
+    exit(1)
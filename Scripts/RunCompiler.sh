@@ -1,5 +1,2 @@
-./cmake-build-debug/bin/Hunter_Compiler Hunter-Compiler/compiler.hunt
-clang -stdlib=libc++ ./output.o -o ./cmake-build-debug/bin/compiler
-rm output.o
-rm output.bc
-./cmake-build-debug/bin/compiler ./Examples/hello-world.hunt
\ No newline at end of file
+./cmake-build-debug/bin/Hunter_Compiler Hunter-Compiler/compiler.hunt -o ./cmake-build-debug/bin/compiler
+./cmake-build-debug/bin/compiler ./Examples/hello-world.hunt